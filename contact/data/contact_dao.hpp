@@ -5,6 +5,7 @@
 #define CONTACT_CONTACT_DAO_HPP
 
 #include "db_connection.hpp"
+#include "../../cpp/src/wire_decimal.hpp"
 
 #include <soci/soci.h>
 #include <string>
@@ -46,6 +47,9 @@ struct EmailDTO
 
 // ─── Address DTO ─────────────────────────────────────────────────────────────
 
+// D_GeoCoordinate DECIMAL(9,6): exchanged with the database as text, never as double.
+using GeoCoordinate = Decimal<9, 6, Endian::native()>;
+
 struct AddressDTO
 {
     int64_t     id             = 0;
@@ -59,8 +63,8 @@ struct AddressDTO
     std::string country;
     int16_t     qualifier_id   = 3;
     bool        is_preferred   = false;
-    double      latitude       = 0.0;
-    double      longitude      = 0.0;
+    GeoCoordinate latitude;
+    GeoCoordinate longitude;
 };
 
 // ─── Contact DAO — Phone, Email, Address CRUD ────────────────────────────────
@@ -262,6 +266,8 @@ public:
         long long new_id = 0;
         int v_preferred = a.is_preferred ? 1 : 0;
         int v_qid       = static_cast<int>(a.qualifier_id);
+        std::string v_lat = a.latitude.to_string();
+        std::string v_lng = a.longitude.to_string();
 
         if (a.person_id != 0 && a.org_unit_id == 0)
         {
@@ -274,7 +280,7 @@ public:
                 " VALUES"
                 " (:pid, NULL, :sl1, NULLIF(:sl2,''), :city,"
                 "  NULLIF(:state,''), NULLIF(:pc,''), :ctry, :qid, :pref::boolean,"
-                "  :lat, :lng)"
+                "  :lat::numeric, :lng::numeric)"
                 " RETURNING id",
                 soci::use(v_pid,            "pid"),
                 soci::use(a.street_line1,   "sl1"),
@@ -285,8 +291,8 @@ public:
                 soci::use(a.country,        "ctry"),
                 soci::use(v_qid,            "qid"),
                 soci::use(v_preferred,      "pref"),
-                soci::use(a.latitude,       "lat"),
-                soci::use(a.longitude,      "lng"),
+                soci::use(v_lat,            "lat"),
+                soci::use(v_lng,            "lng"),
                 soci::into(new_id);
         }
         else if (a.person_id == 0 && a.org_unit_id != 0)
@@ -300,7 +306,7 @@ public:
                 " VALUES"
                 " (NULL, :oid, :sl1, NULLIF(:sl2,''), :city,"
                 "  NULLIF(:state,''), NULLIF(:pc,''), :ctry, :qid, :pref::boolean,"
-                "  :lat, :lng)"
+                "  :lat::numeric, :lng::numeric)"
                 " RETURNING id",
                 soci::use(v_oid,            "oid"),
                 soci::use(a.street_line1,   "sl1"),
@@ -311,8 +317,8 @@ public:
                 soci::use(a.country,        "ctry"),
                 soci::use(v_qid,            "qid"),
                 soci::use(v_preferred,      "pref"),
-                soci::use(a.latitude,       "lat"),
-                soci::use(a.longitude,      "lng"),
+                soci::use(v_lat,            "lat"),
+                soci::use(v_lng,            "lng"),
                 soci::into(new_id);
         }
 
@@ -329,7 +335,7 @@ public:
                 "street_line1, COALESCE(street_line2,''), city, "
                 "COALESCE(state_province,''), COALESCE(postal_code,''), country, "
                 "qualifier_id, is_preferred, "
-                "COALESCE(latitude,0), COALESCE(longitude,0) "
+                "COALESCE(latitude,0)::text, COALESCE(longitude,0)::text "
                 "FROM t_address WHERE person_id = :pid ORDER BY is_preferred DESC, id",
                 soci::use(v_pid, "pid"));
 
@@ -348,8 +354,8 @@ public:
             a.country        = r.get<std::string>(8);
             a.qualifier_id   = static_cast<int16_t>(r.get<int>(9));
             a.is_preferred   = r.get<int>(10) != 0;
-            a.latitude       = r.get<double>(11);
-            a.longitude      = r.get<double>(12);
+            GeoCoordinate::parse(r.get<std::string>(11), a.latitude);
+            GeoCoordinate::parse(r.get<std::string>(12), a.longitude);
             result.push_back(std::move(a));
         }
         return result;
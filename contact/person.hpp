@@ -150,6 +150,11 @@ namespace pensar_digital
 
                     inline static constexpr size_t DATA_SIZE = sizeof(Data);
                     inline static constexpr size_t SIZE = Object::SIZE + sizeof(ClassInfo) + DATA_SIZE;
+
+                    /// \brief Members of Data, e.g. the columns of a columnar file (see columnar.hpp).
+                    inline static constexpr auto COLUMNS = DATA_COLUMNS(Data, memail1, memail2, memail3, memail4, memail5, mname,
+                        mdate_of_birth, mphone1, mphone2, mphone3, mphone4, mphone5);
+                    using Serializer = pd::Serializer<pd::Object, Person>;
                     inline const static Data NULL_DATA = { null_person_name(), pd::NULL_DATE };
 
                     Data*              data()       noexcept { return &mdata; }
@@ -163,28 +168,15 @@ namespace pensar_digital
                     Person(const Data& d = NULL_DATA, const pd::Id id = pd::NULL_ID)
                         : Object(id == pd::NULL_ID ? generator.get_id() : id), mdata(d) {}
 
-                    // --- BinaryBuffer serialization (matches Generator pattern) ---
+                    // --- BinaryBuffer serialization (see pd::Serializer) ---
 
-                    BinaryBuffer& write(BinaryBuffer& bb) const noexcept override
-                    {
-                        Object::write(bb);
-                        bb.write(INFO.bytes());
-                        bb.write(data_bytes());
-                        return bb;
-                    }
+                    BinaryBuffer& write(BinaryBuffer& bb) const noexcept override { return Serializer::write(*this, bb); }
+                    BinaryBuffer& read (BinaryBuffer& bb)       noexcept override { return Serializer::read (*this, bb); }
 
-                    BinaryBuffer& read(BinaryBuffer& bb) noexcept override
-                    {
-                        Object::read(bb);
-                        ClassInfo info;
-                        bb.read(std::span<std::byte>(reinterpret_cast<std::byte*>(&info), sizeof(ClassInfo)));
-                        if (info != INFO)
-                        {
-                            LOG(W("ClassInfo mismatch in Person::read"));
-                            return bb;
-                        }
-                        return bb.read(data_wbytes());
-                    }
+                    // --- Delta serialization: only the bytes changed since a baseline the reader holds ---
+
+                    BinaryBuffer& write_delta(const Person& baseline, BinaryBuffer& bb) const noexcept { return Serializer::write_delta(*this, baseline, bb); }
+                    BinaryBuffer& read_delta (BinaryBuffer& bb)                               noexcept { return Serializer::read_delta (*this, bb); }
 
                     // --- Accessors ---
 
@@ -292,8 +292,8 @@ TEST_CASE("ContactDAO - Phone, Email, Address for Person", "[db][contact]")
         addr.country      = "BR";
         addr.qualifier_id = 1; // Home
         addr.is_preferred = true;
-        addr.latitude     = -23.550520;
-        addr.longitude    = -46.633308;
+        addr.latitude     = GeoCoordinate::parse("-23.550520");
+        addr.longitude    = GeoCoordinate::parse("-46.633308");
 
         int64_t addr_id = contact_dao.insert_address(addr, "test_user");
         REQUIRE(addr_id > 0);
@@ -302,6 +302,8 @@ TEST_CASE("ContactDAO - Phone, Email, Address for Person", "[db][contact]")
         REQUIRE(addrs.size() >= 1);
         CHECK(addrs[0].city == "Sao Paulo");
         CHECK(addrs[0].country == "BR");
+        CHECK(addrs[0].latitude  == addr.latitude);
+        CHECK(addrs[0].longitude == addr.longitude);
 
         contact_dao.remove_address(addr_id, "test_user");
     }
@@ -5,6 +5,7 @@
 #include "../person.hpp"
 #include "../../cpp/src/concept.hpp"
 #include "../../cpp/src/binary_buffer.hpp"
+#include "../../cpp/src/columnar.hpp"
 #include "../../cpp/src/test/test_helpers.hpp"
 
 namespace pensar_digital::cpplib::contact
@@ -247,6 +248,99 @@ namespace pensar_digital::cpplib::contact
         }
     }
 
+    TEST_CASE("Person delta round-trip", "[person]")
+    {
+        Person p(Person::DataType{ { W("Mauricio"), W(""), W("Gomes") }, Date(1980, 1, 1) });
+        p.set_phone1({ W("55"), W("11"), W("1234567890"), ContactQualifier::Business });
+        p.set_email1(Email(W("local1@domain1.com")));
+
+        // The replica holds the baseline.
+        Person replica;
+        BinaryBuffer full;
+        full.write(p);
+        full.read(replica);
+        REQUIRE(replica == p);
+
+        const Person baseline = p;
+        p.set_phone2({ W("55"), W("21"), W("9876543210"), ContactQualifier::Personal });
+        CHECK(baseline.id() == p.id());
+
+        INFO("Assignment copies the id and the data, as the copy constructor");
+        const Person source(Person::DataType{ { W("Ana"), W(""), W("Silva") }, Date(1990, 2, 3) }, 42);
+        Person assigned;
+        assigned = source;
+        CHECK((assigned.id() == 42 && assigned == source));
+        Person moved;
+        moved = Person(source);
+        CHECK((moved.id() == 42 && moved == source));
+        BinaryBuffer bb;
+        bb.set_compact_types(true);
+        p.write_delta(baseline, bb);
+        INFO("A one field change is a small patch");
+        CHECK(bb.size() < Person::DATA_SIZE / 4);
+
+        BinaryBuffer in;
+        in.set_compact_types(true);
+        in.write(bb.data());
+        replica.read_delta(in);
+        REQUIRE(in.ok());
+        CHECK(in.remaining() == 0);
+        CHECK(replica == p);
+        CHECK(replica.phone2() == p.phone2());
+
+        INFO("Once the stream defined the type, a delta is a few bytes");
+        const Person baseline2 = p;
+        p.set_phone2({ W("55"), W("21"), W("9876543211"), ContactQualifier::Personal });
+        const size_t before = bb.size();
+        p.write_delta(baseline2, bb);
+        CHECK(bb.size() - before < 24);
+        in.write(bb.data().subspan(before));
+        replica.read_delta(in);
+        REQUIRE(in.ok());
+        CHECK(replica == p);
+
+        INFO("Applying it again fails: the replica no longer holds the baseline");
+        in.rewind();
+        replica.read_delta(in);
+        CHECK(in.error() == BufferError::INVALID_DATA);
+        CHECK(replica == p);
+    }
+
+    TEST_CASE("Person columnar round-trip", "[person]")
+    {
+        PersonName name1 = { W("First"), W("Middle"), W("Last") };
+        Person p1(Person::DataType{ name1, Date(1980, 1, 1) });
+        p1.set_phone1({ W("55"), W("11"), W("1234567890"), ContactQualifier::Business });
+        p1.set_email1(Email(W("first@example.com")));
+
+        PersonName name2 = { W("Second"), W(""), W("Person") };
+        Person p2(Person::DataType{ name2, Date(1981, 2, 2) });
+        p2.set_email1(Email(W("second@example.com")));
+
+        const size_t N = 100;
+        ColumnarWriter w(Person::COLUMNS, Person::DATA_SIZE);
+        for (size_t i = 0; i < N; ++i) w.add(i % 2 == 0 ? p1 : p2);
+        BinaryBuffer bb;
+        REQUIRE(w.write(bb));
+        INFO("Columns are much smaller than the records");
+        CHECK(bb.size() < N * Person::DATA_SIZE / 10);
+
+        ColumnarReader r;
+        REQUIRE(r.open(bb.data()));
+        std::vector<PersonName> names(r.rows());
+        REQUIRE(r.read_column(r.find("mname"), std::span<PersonName>(names)));
+        CHECK((names[0] == name1 && names[1] == name2 && names[N - 1] == name2));
+
+        std::vector<Person::DataType> records(r.rows(), Person::NULL_DATA);
+        REQUIRE(r.read_records(std::span<Person::DataType>(records)));
+        for (size_t i = 0; i < N; ++i)
+        {
+            INFO("record " << i);
+            const Person& p = i % 2 == 0 ? p1 : p2;
+            CHECK(std::memcmp(&records[i], p.data(), Person::DATA_SIZE) == 0);
+        }
+    }
+
     // ===== Text streaming =====
 
     TEST_CASE("Person text streaming", "[person]")
@@ -0,0 +1,164 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <new>
+#include <memory>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
+
+namespace pensar_digital::cpplib
+{
+    // Monotonic arena: allocation bumps a pointer in the current chunk, nothing is freed
+    // one by one. release () destroys every object created in the arena, newest first, and
+    // rewinds it keeping its largest chunk, so a steady load (e.g. one message per release)
+    // stops allocating after the first round. Objects needing a destructor get a small
+    // finalizer node in the arena itself; trivially destructible ones cost their size only.
+    //
+    // Not thread safe: one arena per thread or per batch.
+    class MonotonicArena
+    {
+        public:
+            inline static constexpr size_t DEFAULT_CHUNK = 64 * 1024;
+            inline static constexpr size_t MAX_CHUNK     = 16 * 1024 * 1024; // Growth stops doubling here.
+
+            explicit MonotonicArena(size_t initial_chunk = DEFAULT_CHUNK) noexcept
+                : mnext_size((std::max)(initial_chunk, sizeof(Chunk) + alignof(std::max_align_t))) {}
+
+            MonotonicArena(const MonotonicArena&) = delete;
+            MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+            ~MonotonicArena() noexcept
+            {
+                finalize();
+                for (Chunk* c = mchunks; c != nullptr; )
+                {
+                    Chunk* next = c->mnext;
+                    ::operator delete(c);
+                    c = next;
+                }
+            }
+
+            // Raw storage, uninitialized. align must be a power of two.
+            void* allocate(size_t size, size_t align = alignof(std::max_align_t))
+            {
+                std::byte* p = align_up(mcur, align);
+                if (mcur == nullptr || static_cast<size_t>(p - mcur) + size > static_cast<size_t>(mend - mcur))
+                {
+                    grow(size + align);
+                    p = align_up(mcur, align);
+                }
+                mcur = p + size;
+                return p;
+            }
+
+            // Constructs a T in the arena. Its destructor runs on release () or when the arena dies.
+            template <typename T, typename... Args>
+            T* create(Args&&... args)
+            {
+                if constexpr (std::is_trivially_destructible_v<T>)
+                    return ::new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+                else
+                {
+                    // Node first: if T's constructor throws, only arena bytes are lost.
+                    Finalizer* f = static_cast<Finalizer*>(allocate(sizeof(Finalizer), alignof(Finalizer)));
+                    T* t = ::new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+                    *f = { [](void* o) noexcept { static_cast<T*>(o)->~T(); }, t, mfinalizers };
+                    mfinalizers = f;
+                    ++mobjects;
+                    return t;
+                }
+            }
+
+            // Destroys every object and rewinds, keeping the largest chunk for reuse.
+            void release() noexcept
+            {
+                finalize();
+                if (mchunks == nullptr) return;
+                Chunk* keep = mchunks;
+                for (Chunk* c = mchunks->mnext; c != nullptr; c = c->mnext)
+                    if (c->msize > keep->msize) keep = c;
+                for (Chunk* c = mchunks; c != nullptr; )
+                {
+                    Chunk* next = c->mnext;
+                    if (c != keep) ::operator delete(c);
+                    c = next;
+                }
+                keep->mnext = nullptr;
+                mchunks = keep;
+                mcapacity = keep->msize - sizeof(Chunk);
+                mcur = reinterpret_cast<std::byte*>(keep + 1);
+                mend = reinterpret_cast<std::byte*>(keep) + keep->msize;
+            }
+
+            // Bytes handed out, counting what was left unused at the end of older chunks.
+            size_t used() const noexcept
+            {
+                return mchunks == nullptr ? 0 : mcapacity - static_cast<size_t>(mend - mcur);
+            }
+            size_t capacity() const noexcept { return mcapacity; } // Usable bytes in all chunks.
+            size_t chunk_count() const noexcept
+            {
+                size_t n = 0;
+                for (const Chunk* c = mchunks; c != nullptr; c = c->mnext) ++n;
+                return n;
+            }
+            // Live objects that have a destructor to run.
+            size_t finalizer_count() const noexcept { return mobjects; }
+
+        private:
+            struct Chunk
+            {
+                Chunk* mnext;
+                size_t msize; // Including this header.
+            };
+            struct Finalizer
+            {
+                void (*mdestroy)(void*) noexcept;
+                void* mobject;
+                Finalizer* mnext;
+            };
+
+            Chunk*     mchunks     = nullptr;
+            std::byte* mcur        = nullptr;
+            std::byte* mend        = nullptr;
+            Finalizer* mfinalizers = nullptr;
+            size_t     mnext_size;
+            size_t     mcapacity   = 0;
+            size_t     mobjects    = 0;
+
+            static std::byte* align_up(std::byte* p, size_t align) noexcept
+            {
+                const uintptr_t u = reinterpret_cast<uintptr_t>(p);
+                return p + (((u + align - 1) & ~(uintptr_t)(align - 1)) - u);
+            }
+
+            void grow(size_t min_size)
+            {
+                const size_t size = (std::max)(mnext_size, sizeof(Chunk) + min_size);
+                Chunk* c = static_cast<Chunk*>(::operator new(size));
+                c->mnext = mchunks;
+                c->msize = size;
+                mchunks = c;
+                // Bytes left in the previous chunk are abandoned; count them as used.
+                mcapacity += size - sizeof(Chunk);
+                mcur = reinterpret_cast<std::byte*>(c + 1);
+                mend = reinterpret_cast<std::byte*>(c) + size;
+                mnext_size = (std::min)(MAX_CHUNK, (std::max)(mnext_size, size) * 2);
+            }
+
+            void finalize() noexcept
+            {
+                for (Finalizer* f = mfinalizers; f != nullptr; f = f->mnext) f->mdestroy(f->mobject);
+                mfinalizers = nullptr;
+                mobjects = 0;
+            }
+    };
+}
+
+#endif // ARENA_HPP
@@ -3,15 +3,27 @@
 #define BINARY_BUFFER_HPP_INCLUDED
 
 #include <vector>
+#include <memory>    // for std::unique_ptr
+#include <algorithm> // for std::min
 #include <span>
 #include <cstdio> // for FILE operations
 #include <cstring> // for std::memcpy
 #include <concepts>
+#include <ranges>
+#include <limits>
 #include <type_traits>
-#include <iostream>
 #include <cstddef> // for std::byte
+#include <cstdint> // for std::uintptr_t
 #include <string_view>
+#include <functional> // for std::function
+#include <utility>    // for std::exchange
 #include "code_util.hpp"
+#include "concept.hpp" // WireSafe
+#include "varint.hpp"
+#include "type_table.hpp"
+#include "endian.hpp"
+#include "byte_order.hpp" // byteswap_in_place
+#include "array.hpp"      // CArray
 
 namespace pensar_digital
 {
@@ -33,34 +45,416 @@ namespace pensar_digital
             { t.read(bb) }  -> std::same_as<BinaryBuffer&>;
         };
 
+        // ---------------------------------------------------------------------------
+        // Struct: GrowthPolicy
+        // ---------------------------------------------------------------------------
+        // Decides the new capacity of a BinaryBuffer's owned storage when a write does
+        // not fit. Trivially copyable, so it can be stored and passed by value.
+        //   GEOMETRIC : grows by mparam percent of the current capacity (100 = doubling).
+        //   CHUNKED   : rounds the required size up to a multiple of mparam bytes.
+        //   FIXED_CAP : grows geometrically (doubling) but never beyond mparam bytes.
+        // ---------------------------------------------------------------------------
+        struct GrowthPolicy
+        {
+            enum Kind : size_t { GEOMETRIC, CHUNKED, FIXED_CAP };
+
+            size_t mparam = 100;
+            Kind   mkind  = GEOMETRIC;
+
+            static constexpr GrowthPolicy geometric(size_t percent = 100) noexcept { return { percent > 0 ? percent : 1, GEOMETRIC }; }
+            static constexpr GrowthPolicy chunked  (size_t chunk   = 64 * 1024) noexcept { return { chunk > 0 ? chunk : 1, CHUNKED }; }
+            static constexpr GrowthPolicy fixed_cap(size_t cap) noexcept { return { cap, FIXED_CAP }; }
+
+            /// \brief New capacity able to hold required bytes, or 0 if the policy forbids it.
+            constexpr size_t next_capacity(size_t current, size_t required) const noexcept
+            {
+                switch (mkind)
+                {
+                    case CHUNKED:
+                        return ((required + mparam - 1) / mparam) * mparam;
+                    case FIXED_CAP:
+                        if (required > mparam) return 0;
+                        return (std::min)((std::max)(required, current * 2), mparam);
+                    case GEOMETRIC:
+                    default:
+                        return (std::max)(required, current + current / 100 * mparam + current % 100 * mparam / 100);
+                }
+            }
+        };
+        static_assert(StdLayoutTriviallyCopyableNoPadding<GrowthPolicy>, "GrowthPolicy must be StdLayoutTriviallyCopyableNoPadding");
+
+        // Number of bytes reserve_for<T> sets aside per object: T::SIZE for classes that
+        // declare it (Object, Command, Generator...), sizeof(T) otherwise.
+        template <typename T>
+        inline constexpr size_t serialized_size() noexcept
+        {
+            if constexpr (requires { { T::SIZE } -> std::convertible_to<size_t>; })
+                return T::SIZE;
+            else
+                return sizeof(T);
+        }
+
+        // Sticky error of a BinaryBuffer: the first failure is kept until clear_error().
+        enum class BufferError : std::uint8_t
+        {
+            NONE,
+            READ_UNDERFLOW,  //!< A read, view or skip asked for more bytes than remain.
+            WRITE_OVERFLOW,  //!< The storage could not grow (or spill) to fit a write.
+            INVALID_VARINT,  //!< Truncated, overlong or out of range varint.
+            INVALID_DATA     //!< Set by readers that reject the bytes (e.g. ClassInfo mismatch).
+        };
+
         // ---------------------------------------------------------------------------
         // Class: BinaryBuffer
         // ---------------------------------------------------------------------------
         // A high-performance binary buffer that avoids std::iostream overhead.
         // Uses C++23 features like 'deduced this'.
+        //
+        // Errors never throw or log: a failed read or write does nothing and sets a
+        // sticky error (see ok(), status()); once set, reads are no-ops, so a malformed
+        // record cannot be half-decoded. Hot deserialization loops can validate a whole
+        // record with ensure(n) and then use the unchecked reads.
         // ---------------------------------------------------------------------------
         class BinaryBuffer {
+        public:
+            // Called when an attached buffer needs at least min_capacity writable bytes.
+            // Returns the (possibly relocated) memory, or an empty span if it cannot grow.
+            using GrowFunction = std::function<std::span<std::byte>(size_t min_capacity)>;
+
+            // Called when a sink (see attach_sink) is full. Consumes the written bytes and
+            // returns fresh memory to continue writing into, or an empty span on failure.
+            using SpillFunction = std::function<std::span<std::byte>(std::span<const std::byte> written, size_t min_capacity)>;
+
+            // Called when a source (see attach_source) runs out of bytes. consumed is the
+            // read position within the current window; returns the next window, starting
+            // at the first unread byte and holding at least min_bytes when that many are left.
+            using RefillFunction = std::function<std::span<const std::byte>(size_t consumed, size_t min_bytes)>;
+
         private:
-            std::vector<std::byte> buffer;
+            // Owned storage (unused while attached). Allocated for overwrite: new bytes
+            // are never value-initialized, they are written before they are read.
+            std::unique_ptr<std::byte[]> buffer;
+            size_t buffer_size = 0;
+            GrowthPolicy mpolicy;
+            std::byte* mbase = nullptr;    // Active storage: buffer.get() or attached memory.
+            size_t mcapacity = 0;          // Writable bytes at mbase (0 for read-only memory).
             size_t write_pos = 0;
             size_t read_pos = 0;
+            bool mattached = false;
+            bool mcompact = false;         // Compact integers mode (see set_compact_integers).
+            std::unique_ptr<TypeTable> mtypes; // Compact types mode (see set_compact_types).
+            BufferError merror = BufferError::NONE;
+            GrowFunction mgrow;
+            SpillFunction mspill;
+            RefillFunction mrefill;
+
+            // Makes room for at least required bytes. Returns false if the storage cannot grow.
+            bool grow(size_t required) {
+                if (mattached) {
+                    if (!mgrow) return false;
+                    std::span<std::byte> memory = mgrow(required);
+                    if (memory.size() < required) return false;
+                    mbase = memory.data();
+                    mcapacity = memory.size();
+                    return true;
+                }
+                const size_t new_capacity = mpolicy.next_capacity(buffer_size, required);
+                if (new_capacity < required) return false;
+                reallocate(new_capacity);
+                return true;
+            }
+
+            // Sink write: copies as much as fits, then hands the full memory to mspill and
+            // continues in the memory it returns. A single write may span several spills.
+            bool spill_write(std::span<const std::byte> src) {
+                while (true) {
+                    const size_t fit = (std::min)(src.size(), mcapacity - write_pos);
+                    if (fit > 0) std::memcpy(mbase + write_pos, src.data(), fit);
+                    write_pos += fit;
+                    src = src.subspan(fit);
+                    if (src.empty()) return true;
+                    std::span<std::byte> memory = mspill(std::span<const std::byte>{ mbase, write_pos }, src.size());
+                    if (memory.empty()) return false;
+                    mbase = memory.data();
+                    mcapacity = memory.size();
+                    write_pos = 0;
+                }
+            }
+
+            // Source read: asks mrefill for a window holding at least n unread bytes.
+            bool refill(size_t n) {
+                if (!mrefill) return false;
+                std::span<const std::byte> window = mrefill(read_pos, n);
+                mbase = const_cast<std::byte*>(window.data()); // Never written: mcapacity is 0.
+                mcapacity = 0;
+                write_pos = window.size();
+                read_pos = 0;
+                return write_pos >= n;
+            }
+
+            // Decodes one varint at the read position, refilling a source one byte at a
+            // time when the varint straddles two windows.
+            bool read_varint_bits(std::uint64_t& v) {
+                size_t used = decode_varint(std::span<const std::byte>{ mbase + read_pos, remaining() }, v);
+                if (used > 0) {
+                    read_pos += used;
+                    return true;
+                }
+                if (remaining() >= VARINT_MAX_BYTES || !mrefill) return false;
+                std::uint64_t result = 0;
+                for (size_t i = 0; i < VARINT_MAX_BYTES; ++i) {
+                    if (remaining() == 0 && !refill(1)) return false;
+                    const std::uint64_t b = static_cast<std::uint8_t>(mbase[read_pos++]);
+                    if (i == VARINT_MAX_BYTES - 1 && b > 1) return false;
+                    result |= (b & 0x7F) << (7 * i);
+                    if (b < 0x80) {
+                        v = result;
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            // Integral types whose byte order depends on the wire endian.
+            template <typename T>
+            static constexpr bool SWAPPABLE = IntegerLike<T> && (sizeof(T) > 1);
+
+            template <typename T>
+            static constexpr bool needs_swap(Endian wire) noexcept {
+                if constexpr (SWAPPABLE<T>)
+                    return wire.known() && !wire.is_native();
+                else
+                    return false;
+            }
+
+            template <typename T>
+            BinaryBuffer& read_array_elements(std::span<T> values, Endian wire) {
+                read(std::as_writable_bytes(values));
+                if constexpr (SWAPPABLE<T>)
+                    if (needs_swap<T>(wire) && merror == BufferError::NONE) byteswap_in_place<T>(std::as_writable_bytes(values));
+                return *this;
+            }
+
+            // Moves the written bytes (only those, not the whole capacity) to new owned storage.
+            void reallocate(size_t new_capacity) {
+                auto storage = std::make_unique_for_overwrite<std::byte[]>(new_capacity);
+                if (write_pos > 0) std::memcpy(storage.get(), mbase, write_pos);
+                buffer = std::move(storage);
+                buffer_size = new_capacity;
+                mbase = buffer.get();
+                mcapacity = buffer_size;
+            }
 
         public:
-            explicit BinaryBuffer(size_t reserve = 4096) {
-                buffer.reserve(reserve);
+            explicit BinaryBuffer(size_t reserve = 4096, GrowthPolicy policy = GrowthPolicy::geometric()) : mpolicy(policy) {
+                if (reserve > 0) reallocate(reserve);
+            }
+
+            // Copies always own their bytes, even when the source is attached. The sticky
+            // error is not copied: a copy starts clean.
+            BinaryBuffer(const BinaryBuffer& other) : BinaryBuffer(other.write_pos, other.mpolicy) {
+                mcompact = other.mcompact;
+                if (other.mtypes) mtypes = std::make_unique<TypeTable>(*other.mtypes);
+                write(other.data());
+                read_pos = other.read_pos;
+            }
+
+            BinaryBuffer(BinaryBuffer&& other) noexcept
+                : buffer(std::move(other.buffer)),
+                  buffer_size(std::exchange(other.buffer_size, 0)),
+                  mpolicy(other.mpolicy),
+                  mbase(std::exchange(other.mbase, nullptr)),
+                  mcapacity(std::exchange(other.mcapacity, 0)),
+                  write_pos(std::exchange(other.write_pos, 0)),
+                  read_pos(std::exchange(other.read_pos, 0)),
+                  mattached(std::exchange(other.mattached, false)),
+                  mcompact(other.mcompact),
+                  mtypes(std::move(other.mtypes)),
+                  merror(std::exchange(other.merror, BufferError::NONE)),
+                  mgrow(std::move(other.mgrow)),
+                  mspill(std::move(other.mspill)),
+                  mrefill(std::move(other.mrefill)) {}
+
+            BinaryBuffer& operator=(const BinaryBuffer& other) {
+                if (this != &other) {
+                    detach();
+                    mpolicy = other.mpolicy;
+                    mcompact = other.mcompact;
+                    mtypes = other.mtypes ? std::make_unique<TypeTable>(*other.mtypes) : nullptr;
+                    clear_error();
+                    write(other.data());
+                    read_pos = other.read_pos;
+                }
+                return *this;
+            }
+
+            BinaryBuffer& operator=(BinaryBuffer&& other) noexcept {
+                if (this != &other) {
+                    buffer      = std::move(other.buffer);
+                    buffer_size = std::exchange(other.buffer_size, 0);
+                    mpolicy     = other.mpolicy;
+                    mbase     = std::exchange(other.mbase, nullptr);
+                    mcapacity = std::exchange(other.mcapacity, 0);
+                    write_pos = std::exchange(other.write_pos, 0);
+                    read_pos  = std::exchange(other.read_pos, 0);
+                    mattached = std::exchange(other.mattached, false);
+                    mcompact  = other.mcompact;
+                    mtypes    = std::move(other.mtypes);
+                    merror    = std::exchange(other.merror, BufferError::NONE);
+                    mgrow     = std::move(other.mgrow);
+                    mspill    = std::move(other.mspill);
+                    mrefill   = std::move(other.mrefill);
+                }
+                return *this;
+            }
+
+            // --- External storage ---
+
+            // Attaches the buffer to writable memory it does not own (e.g. a read-write
+            // memory-mapped file). The first size bytes are readable, writes append after
+            // them and call grow when the memory is full.
+            void attach(std::span<std::byte> memory, size_t size, GrowFunction grow_function = {}) noexcept {
+                mbase = memory.data();
+                mcapacity = memory.size();
+                write_pos = (std::min)(size, memory.size());
+                read_pos = 0;
+                mattached = true;
+                mgrow = std::move(grow_function);
+                mspill = nullptr;
+                mrefill = nullptr;
             }
 
+            // Attaches the buffer to read-only memory it does not own (e.g. a read-only
+            // memory-mapped file). All bytes are readable; writes fail.
+            void attach(std::span<const std::byte> memory) noexcept {
+                mbase = const_cast<std::byte*>(memory.data()); // Never written: mcapacity is 0.
+                mcapacity = 0;
+                write_pos = memory.size();
+                read_pos = 0;
+                mattached = true;
+                mgrow = nullptr;
+                mspill = nullptr;
+                mrefill = nullptr;
+            }
+
+            // Attaches the buffer as a sink over memory it does not own. Writes never grow
+            // the memory: when it is full the written bytes are passed to spill, which
+            // returns the memory to continue in. Used by streaming writers and segmented
+            // buffers to serialize any BinaryBufferIO object without a contiguous copy.
+            void attach_sink(std::span<std::byte> memory, SpillFunction spill) noexcept {
+                attach(memory, 0);
+                mspill = std::move(spill);
+            }
+
+            // Attaches the buffer as a source over a window of bytes it does not own. Reads
+            // that run past the window call refill for the next one, so objects can be
+            // read transparently across window (segment, block) boundaries.
+            void attach_source(std::span<const std::byte> window, RefillFunction refill) noexcept {
+                attach(window);
+                mrefill = std::move(refill);
+            }
+
+            // Goes back to (empty) owned storage.
+            void detach() noexcept {
+                mbase = buffer.get();
+                mcapacity = buffer_size;
+                write_pos = 0;
+                read_pos = 0;
+                mattached = false;
+                mgrow = nullptr;
+                mspill = nullptr;
+                mrefill = nullptr;
+            }
+
+            [[nodiscard]] bool is_attached() const noexcept { return mattached; }
+
             // --- View Data ---
 
             [[nodiscard]] std::span<const std::byte> data() const noexcept {
-                return std::span{ buffer.data(), write_pos };
+                return std::span{ mbase, write_pos };
             }
 
+            // Writable bytes available before the buffer has to grow.
+            [[nodiscard]] size_t capacity() const noexcept { return mcapacity; }
+
+            // --- Capacity management ---
+
+            [[nodiscard]] GrowthPolicy growth_policy() const noexcept { return mpolicy; }
+            void set_growth_policy(GrowthPolicy policy) noexcept { mpolicy = policy; }
+
+            // Ensures the buffer can hold at least new_capacity bytes without growing again.
+            // Returns false if the storage cannot grow that much.
+            bool reserve(size_t new_capacity) {
+                if (new_capacity <= mcapacity) return true;
+                return grow(new_capacity);
+            }
+
+            // Reserves room for count more objects of each of the types Ts, sized from
+            // their static SIZE constant (see serialized_size), e.g.
+            // bb.reserve_for<Object>(objects.size ()).
+            template <typename... Ts>
+            bool reserve_for(size_t count = 1) {
+                return reserve(write_pos + count * (serialized_size<Ts>() + ... + 0));
+            }
+
+            // Compact integers mode: integral values (wider than a byte) written with
+            // write(pod) and read with read(pod) use the varint encoding (see write_varint)
+            // instead of their full width. Writer and reader must use the same mode.
+            // Structs and byte spans (e.g. Object::Data) are not affected.
+            void set_compact_integers(bool on) noexcept { mcompact = on; }
+            [[nodiscard]] bool compact_integers() const noexcept { return mcompact; }
+
+            // Compact types mode: record type tags (see ClassInfo::write_tag) are written
+            // as a varint id into this buffer's TypeTable instead of the full descriptor,
+            // which is only written the first time the type appears. Writer and reader must
+            // use the same mode. Turning it off drops the table.
+            void set_compact_types(bool on) {
+                if (!on) mtypes.reset();
+                else if (!mtypes) mtypes = std::make_unique<TypeTable>();
+            }
+            [[nodiscard]] bool compact_types() const noexcept { return mtypes != nullptr; }
+
+            // --- Errors ---
+
+            [[nodiscard]] bool ok() const noexcept { return merror == BufferError::NONE; }
+            [[nodiscard]] BufferError error() const noexcept { return merror; }
+
+            [[nodiscard]] Result<Bool> status() const {
+                switch (merror) {
+                    case BufferError::NONE:           return Result<Bool>(Bool::T);
+                    case BufferError::READ_UNDERFLOW: return Result<Bool>(W("Buffer underflow while reading"));
+                    case BufferError::WRITE_OVERFLOW: return Result<Bool>(W("Buffer overflow while writing"));
+                    case BufferError::INVALID_VARINT: return Result<Bool>(W("Invalid varint"));
+                    case BufferError::INVALID_DATA:   return Result<Bool>(W("Invalid data"));
+                }
+                return Result<Bool>(W("Unknown buffer error"));
+            }
+
+            // Records e unless an earlier error is pending. Readers call it to reject
+            // malformed input, e.g. bb.fail(BufferError::INVALID_DATA).
+            BinaryBuffer& fail(BufferError e) noexcept {
+                if (merror == BufferError::NONE) merror = e;
+                return *this;
+            }
+
+            void clear_error() noexcept { merror = BufferError::NONE; }
+
             [[nodiscard]] size_t size() const noexcept { return write_pos; }
 
+            // Number of bytes written but not yet read.
+            [[nodiscard]] size_t remaining() const noexcept { return write_pos - read_pos; }
+
             void clear() noexcept {
                 write_pos = 0;
                 read_pos = 0;
+                merror = BufferError::NONE;
+                if (mtypes) mtypes->clear();
+            }
+
+            // Restarts reading from the beginning, keeping the written bytes.
+            void rewind() noexcept {
+                read_pos = 0;
+                if (mtypes) mtypes->rewind();
             }
 
             // ======================================================================
@@ -71,13 +465,20 @@ namespace pensar_digital
             auto write(this auto&& self, std::span<const std::byte> src) -> decltype(auto) {
                 const size_t required = self.write_pos + src.size();
 
-                // Check and resize buffer if necessary
-                if (required > self.buffer.size()) {
-                    self.buffer.resize(required);
+                // Check and grow buffer if necessary
+                if (required > self.mcapacity) {
+                    if (self.mspill) {
+                        if (!self.spill_write(src)) self.fail(BufferError::WRITE_OVERFLOW);
+                        return self;
+                    }
+                    if (!self.grow(required)) {
+                        self.fail(BufferError::WRITE_OVERFLOW);
+                        return self;
+                    }
                 }
 
                 // Copy memory directly (avoids virtual calls/overhead)
-                std::memcpy(self.buffer.data() + self.write_pos, src.data(), src.size());
+                std::memcpy(self.mbase + self.write_pos, src.data(), src.size());
                 self.write_pos += src.size();
 
                 return self;
@@ -101,16 +502,58 @@ namespace pensar_digital
                          (!std::is_same_v<std::remove_cvref_t<T>, std::span<std::byte>>) &&
                          (!std::is_same_v<std::remove_cvref_t<T>, std::span<const std::byte>>)
             {
+                if constexpr (std::is_integral_v<T> && (sizeof(T) > 1)) {
+                    if (self.mcompact) {
+                        self.write_varint(pod);
+                        return self;
+                    }
+                }
                 return self.write(std::as_bytes(std::span{ &pod, 1 }));
             }
 
+            // Writes value as a LEB128 varint: 7 bits per byte, so values below 128 take a
+            // single byte. Signed values are zig-zag encoded first.
+            template <std::integral T>
+            BinaryBuffer& write_varint(T value) {
+                const std::uint64_t u = zigzag_encode(value);
+                if (write_pos + VARINT_MAX_BYTES <= mcapacity) {
+                    write_pos += encode_varint(u, mbase + write_pos);
+                    return *this;
+                }
+                std::byte bytes[VARINT_MAX_BYTES];
+                return write(std::span<const std::byte>(bytes, encode_varint(u, bytes)));
+            }
+
+            template <std::integral T>
+            BinaryBuffer& write_varints(std::span<const T> values) {
+                for (const T& v : values) write_varint(v);
+                return *this;
+            }
+
+            // Appends n bytes for the caller to fill in place, e.g. a decoder writing straight
+            // into the buffer, and returns them. Empty, with WRITE_OVERFLOW, if the storage
+            // cannot grow that much (a sink never can: write through it instead).
+            [[nodiscard]] std::span<std::byte> extend(size_t n) {
+                if (merror != BufferError::NONE) return {};
+                const bool fits = n <= (std::numeric_limits<size_t>::max)() - write_pos;
+                if (!fits || write_pos + n > mcapacity) {
+                    if (!fits || mspill || !grow(write_pos + n)) {
+                        fail(BufferError::WRITE_OVERFLOW);
+                        return {};
+                    }
+                }
+                const std::span<std::byte> tail{ mbase + write_pos, n };
+                write_pos += n;
+                return tail;
+            }
+
             // Save entire buffer to disk (Binary Mode)
             Result<Bool> save_to_file(std::string_view filename) const {
                 // "wb" is crucial for Windows to prevent newline translation
                 FILE* f = fopen(std::string(filename).c_str(), "wb");
                 if (!f) return Result<Bool>(W("Failed to open file for writing"));
 
-                size_t written = fwrite(buffer.data(), sizeof(std::byte), write_pos, f);
+                size_t written = fwrite(mbase, sizeof(std::byte), write_pos, f);
                 fclose(f);
 
                 if (written != write_pos) {
@@ -138,11 +581,12 @@ namespace pensar_digital
                     return Result<Bool>(W("Could not determine file size"));
                 }
 
-                // Resize buffer to fit file contents
-                buffer.resize(static_cast<size_t>(file_size));
+                // Resize buffer to fit file contents (always into owned storage)
+                detach();
+                if (static_cast<size_t>(file_size) > buffer_size) reallocate(static_cast<size_t>(file_size));
 
                 // Read bytes
-                size_t read_bytes = fread(buffer.data(), sizeof(std::byte), static_cast<size_t>(file_size), f);
+                size_t read_bytes = fread(mbase, sizeof(std::byte), static_cast<size_t>(file_size), f);
                 fclose(f);
 
                 if (read_bytes != static_cast<size_t>(file_size)) {
@@ -152,24 +596,212 @@ namespace pensar_digital
                 // Reset positions
                 write_pos = static_cast<size_t>(file_size);
                 read_pos = 0;
+                merror = BufferError::NONE;
+                if (mtypes) mtypes->clear();
                 return Result<Bool>(Bool::T);
             }
 
             // Core read: copies buffer bytes into the destination span
             auto read(this auto&& self, std::span<std::byte> dest) -> decltype(auto) {
-                // Check bounds
-                if (self.read_pos + dest.size() > self.buffer.size()) {
-                    std::cerr << "Error: Buffer underflow while reading!" << std::endl;
-                    return self;
+                // A source copies window by window instead of staging large values.
+                if (dest.size() > self.remaining() && self.mrefill && self.merror == BufferError::NONE) {
+                    while (dest.size() > self.remaining()) {
+                        const size_t n = self.remaining();
+                        std::memcpy(dest.data(), self.mbase + self.read_pos, n);
+                        self.read_pos += n;
+                        dest = dest.subspan(n);
+                        if (!self.refill(1)) {
+                            self.fail(BufferError::READ_UNDERFLOW);
+                            return self;
+                        }
+                    }
                 }
 
+                // Check bounds
+                if (!self.ensure(dest.size())) return self;
+
                 // Copy from buffer to destination
-                std::memcpy(dest.data(), self.buffer.data() + self.read_pos, dest.size());
+                std::memcpy(dest.data(), self.mbase + self.read_pos, dest.size());
                 self.read_pos += dest.size();
 
                 return self;
             }
 
+            // ======================================================================
+            // VIEW METHODS (zero-copy reads)
+            // ======================================================================
+            // Views point directly into the buffer: they stay valid while the buffer
+            // is alive and no write, load or clear happens (a write may reallocate).
+
+            // Returns a view of the next n bytes without advancing the read position.
+            // An empty span is returned if fewer than n bytes remain.
+            [[nodiscard]] std::span<const std::byte> peek(size_t n) const noexcept {
+                if (n > remaining()) return {};
+                return std::span<const std::byte>{ mbase + read_pos, n };
+            }
+
+            // Returns a view of the next n bytes and advances the read position.
+            [[nodiscard]] std::span<const std::byte> view(size_t n) noexcept {
+                if (!ensure(n)) return {};
+                return view_unchecked(n);
+            }
+
+            // Returns a typed view of the next count objects of type T and advances the
+            // read position. An empty span is returned (and nothing is consumed) if the
+            // bytes are not suitably aligned for T; use read() to copy in that case.
+            template <WireSafe T>
+            [[nodiscard]] std::span<const T> view_as(size_t count = 1) noexcept {
+                // An untrusted count must not wrap count * sizeof(T) into a small size.
+                if (count > (std::numeric_limits<size_t>::max)() / sizeof(T)) {
+                    fail(BufferError::READ_UNDERFLOW);
+                    return {};
+                }
+                const size_t n = count * sizeof(T);
+                if (!ensure(n)) return {};
+                const std::byte* p = mbase + read_pos;
+                if (reinterpret_cast<std::uintptr_t>(p) % alignof(T) != 0) return {};
+                read_pos += n;
+                return std::span<const T>{ reinterpret_cast<const T*>(p), count };
+            }
+
+            // Advances the read position by n bytes without copying them.
+            auto skip(this auto&& self, size_t n) -> decltype(auto) {
+                if (self.merror != BufferError::NONE) return self;
+                if (n > self.remaining() && self.mrefill) {
+                    // Skip what is left of the window, then the rest in the next one.
+                    n -= self.remaining();
+                    self.read_pos = self.write_pos;
+                }
+                if (!self.ensure(n)) return self;
+                self.read_pos += n;
+                return self;
+            }
+
+            // ======================================================================
+            // ARRAY METHODS
+            // ======================================================================
+            // An array is written as its element count (a uint64_t, or a varint in compact
+            // integers mode) followed by all elements copied with a single memcpy. Integral
+            // elements can be stored in a given wire endian: when it differs from the
+            // native one they are byte swapped in bulk, in place.
+
+            template <WireSafe T>
+            BinaryBuffer& write_array(std::span<const T> values, Endian wire = Endian::native()) {
+                write(static_cast<std::uint64_t>(values.size()));
+                if constexpr (SWAPPABLE<T>) {
+                    if (needs_swap<T>(wire)) {
+                        const size_t n = values.size_bytes();
+                        if (write_pos + n > mcapacity && !mspill && !grow(write_pos + n)) return fail(BufferError::WRITE_OVERFLOW);
+                        if (write_pos + n > mcapacity) {
+                            // A sink without room for the whole array: swap a block at a time
+                            // on the stack and write it raw (write (pod) would make varints of
+                            // the elements in compact integers mode).
+                            std::byte block[256];
+                            constexpr size_t PER_BLOCK = sizeof(block) / sizeof(T);
+                            for (size_t i = 0; i < values.size() && merror == BufferError::NONE; i += PER_BLOCK) {
+                                const size_t bytes = (std::min)(PER_BLOCK, values.size() - i) * sizeof(T);
+                                std::memcpy(block, values.data() + i, bytes);
+                                byteswap_in_place<T>(std::span<std::byte>{ block, bytes });
+                                write(std::span<const std::byte>{ block, bytes });
+                            }
+                            return *this;
+                        }
+                        std::memcpy(mbase + write_pos, values.data(), n);
+                        byteswap_in_place<T>(std::span<std::byte>{ mbase + write_pos, n });
+                        write_pos += n;
+                        return *this;
+                    }
+                }
+                return write(std::as_bytes(values));
+            }
+
+            // std::vector, std::array, CArray, ... of WireSafe elements.
+            template <std::ranges::contiguous_range R>
+                requires std::ranges::sized_range<R> && WireSafe<std::ranges::range_value_t<R>>
+            BinaryBuffer& write_array(const R& values, Endian wire = Endian::native()) {
+                return write_array(std::span<const std::ranges::range_value_t<R>>(std::ranges::data(values), std::ranges::size(values)), wire);
+            }
+
+            // Reads an array of exactly values.size () elements (INVALID_DATA otherwise),
+            // e.g. into a CArray or a preallocated span.
+            template <WireSafe T>
+            BinaryBuffer& read_array(std::span<T> values, Endian wire = Endian::native()) {
+                std::uint64_t count = 0;
+                read(count);
+                if (merror != BufferError::NONE) return *this;
+                if (count != values.size()) return fail(BufferError::INVALID_DATA);
+                return read_array_elements(values, wire);
+            }
+
+            template <WireSafe T, size_t N>
+            BinaryBuffer& read_array(CArray<N, T>& values, Endian wire = Endian::native()) {
+                return read_array(std::span<T>(values.data(), N), wire);
+            }
+
+            // Reads an array of any length, resizing values.
+            template <WireSafe T>
+                requires (!std::is_same_v<T, bool>)
+            BinaryBuffer& read_array(std::vector<T>& values, Endian wire = Endian::native()) {
+                std::uint64_t count = 0;
+                read(count);
+                if (merror != BufferError::NONE) return *this;
+                if (!mrefill) {
+                    // The count cannot exceed the bytes present: reject before allocating.
+                    if (count > remaining() / sizeof(T)) return fail(BufferError::READ_UNDERFLOW);
+                    values.resize(static_cast<size_t>(count));
+                    return read_array_elements(std::span<T>(values), wire);
+                }
+                // A source's length is unknown: grow in chunks so a corrupt count fails
+                // on the first missing bytes instead of allocating it all up front.
+                constexpr size_t CHUNK = (size_t{ 1 } << 16) / sizeof(T) + 1;
+                values.clear();
+                while (values.size() < count && merror == BufferError::NONE) {
+                    const size_t start = values.size();
+                    values.resize(start + static_cast<size_t>((std::min)(static_cast<std::uint64_t>(CHUNK), count - start)));
+                    read_array_elements(std::span<T>(values).subspan(start), wire);
+                }
+                return *this;
+            }
+
+            // ======================================================================
+            // UNCHECKED READS
+            // ======================================================================
+            // For hot loops: validate a record once with ensure(record size), then read
+            // its fields without per-field bounds checks. Calling these without a
+            // successful ensure() covering them is undefined behavior. Integral values
+            // are always read with their full width (compact integers mode is ignored).
+
+            // True if n bytes can be read (refilling a source if needed). Otherwise sets
+            // the sticky READ_UNDERFLOW error and returns false. Also false after any error.
+            [[nodiscard]] bool ensure(size_t n) noexcept {
+                if (merror != BufferError::NONE) return false;
+                if (n <= remaining() || refill(n)) return true;
+                fail(BufferError::READ_UNDERFLOW);
+                return false;
+            }
+
+            BinaryBuffer& read_unchecked(std::span<std::byte> dest) noexcept {
+                std::memcpy(dest.data(), mbase + read_pos, dest.size());
+                read_pos += dest.size();
+                return *this;
+            }
+
+            template <typename T>
+            BinaryBuffer& read_unchecked(T& pod) noexcept
+                requires std::is_trivially_copyable_v<T> && (!BinaryBufferIO<T>) &&
+                         (!std::is_same_v<std::remove_cvref_t<T>, std::span<std::byte>>)
+            {
+                std::memcpy(&pod, mbase + read_pos, sizeof(T));
+                read_pos += sizeof(T);
+                return *this;
+            }
+
+            [[nodiscard]] std::span<const std::byte> view_unchecked(size_t n) noexcept {
+                const std::span<const std::byte> v{ mbase + read_pos, n };
+                read_pos += n;
+                return v;
+            }
+
             // Read into a BinarySerializable object
             // Note: This overwrites the memory of 'obj'.
             template <BinaryBufferIO T>
@@ -185,9 +817,84 @@ namespace pensar_digital
                          (!std::is_same_v<std::remove_cvref_t<T>, std::span<std::byte>>) &&
                          (!std::is_same_v<std::remove_cvref_t<T>, std::span<const std::byte>>)
             {
+                if constexpr (std::is_integral_v<T> && (sizeof(T) > 1)) {
+                    if (self.mcompact) {
+                        self.read_varint(pod);
+                        return self;
+                    }
+                }
                 auto dest_span = std::as_writable_bytes(std::span{ &pod, 1 });
                 return self.read(dest_span);
             }
+
+            // Reads a varint written by write_varint into value.
+            template <std::integral T>
+            BinaryBuffer& read_varint(T& value) {
+                using U = std::make_unsigned_t<T>;
+                std::uint64_t v = 0;
+                if (merror != BufferError::NONE) return *this;
+                if (!read_varint_bits(v) || v > (std::numeric_limits<U>::max)()) return fail(BufferError::INVALID_VARINT);
+                value = zigzag_decode<T>(static_cast<U>(v));
+                return *this;
+            }
+
+            // Reads values.size () varints. Runs of small values are decoded in bulk (see
+            // decode_varints); the slow path only handles varints crossing a window.
+            template <std::integral T>
+            BinaryBuffer& read_varints(std::span<T> values) {
+                using U = std::make_unsigned_t<T>;
+                const std::span<U> u{ reinterpret_cast<U*>(values.data()), values.size() };
+                if (merror != BufferError::NONE) return *this;
+                size_t n = 0;
+                while (n < u.size()) {
+                    size_t used = 0;
+                    n += decode_varints(std::span<const std::byte>{ mbase + read_pos, remaining() }, u.subspan(n), used);
+                    read_pos += used;
+                    if (n == u.size()) break;
+                    std::uint64_t v = 0;
+                    if (!read_varint_bits(v) || v > (std::numeric_limits<U>::max)()) return fail(BufferError::INVALID_VARINT);
+                    u[n++] = static_cast<U>(v);
+                }
+                if constexpr (std::is_signed_v<T>)
+                    for (size_t i = 0; i < values.size(); ++i) values[i] = zigzag_decode<T>(u[i]);
+                return *this;
+            }
+
+            // ======================================================================
+            // TYPE TAGS
+            // ======================================================================
+            // Used by ClassInfo::write_tag/read_tag. Without compact types a tag is the
+            // definition itself; with them it is the varint type id, followed by the
+            // definition only the first time the type appears in the stream.
+
+            // Writes the tag of the type whose static descriptor is at key.
+            BinaryBuffer& write_type(const void* key, std::span<const std::byte> definition) {
+                if (!mtypes) return write(definition);
+                bool is_new = false;
+                write_varint(mtypes->intern(key, definition, is_new));
+                if (is_new) write(definition);
+                return *this;
+            }
+
+            // Reads a type tag in compact types mode. Returns its table entry, or nullptr
+            // with INVALID_DATA set for an unknown id, a contradicting definition or when
+            // compact types are off (the caller reads definition_size bytes itself then).
+            TypeTable::Entry* read_type(size_t definition_size) {
+                TypeId id = 0;
+                if (!mtypes) {
+                    fail(BufferError::INVALID_DATA);
+                    return nullptr;
+                }
+                if (!read_varint(id).ok()) return nullptr;
+                if (TypeTable::Entry* e = mtypes->find(id)) return e;
+                if (!mtypes->defines(id) || !ensure(definition_size)) {
+                    fail(BufferError::INVALID_DATA);
+                    return nullptr;
+                }
+                TypeTable::Entry* e = mtypes->define(view_unchecked(definition_size));
+                if (e == nullptr) fail(BufferError::INVALID_DATA);
+                return e;
+            }
         };
     } // namespace cpplib
 } // namespace pensar_digital
@@ -0,0 +1,509 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#ifndef BINARY_STREAM_HPP_INCLUDED
+#define BINARY_STREAM_HPP_INCLUDED
+
+#include <span>
+#include <vector>
+#include <future>    // std::async, std::future
+#include <cstring>   // std::memcpy
+#include <cstddef>   // std::byte
+#include <algorithm> // std::min, std::max
+#include <type_traits>
+
+#include "multiplatform.hpp"
+#include "binary_buffer.hpp"
+#include "code_util.hpp"
+#include "frame.hpp"
+
+// Detects and includes the platform-specific file descriptor I/O.
+// #include "linux/fd_io_linux.hpp", "macos/fd_io_macos.hpp" or "windows/fd_io_windows.hpp"
+#include INCLUDE(fd_io)
+
+namespace pensar_digital
+{
+    namespace cpplib
+    {
+        // ---------------------------------------------------------------------------
+        // Class: BinaryWriter
+        // ---------------------------------------------------------------------------
+        // Streams BinaryBufferIO objects to a file descriptor through a bounded window.
+        // Objects are serialized by their usual write(BinaryBuffer&) into a BinaryBuffer
+        // attached as a sink to one of two blocks of window bytes; when a block is full
+        // it is written to the descriptor while encoding continues in the other one
+        // (double buffering), so memory stays at 2 * window bytes for any stream length
+        // and the I/O overlaps with serialization. With async = false blocks are written
+        // synchronously and a single block is used.
+        //
+        // With framed = true the stream uses the framed format of frame.hpp: each block
+        // goes out as a frame with its CRC32C (computed with the write, off the encoding
+        // thread) and close() ends the stream, so a BinaryReader opened with framed = true
+        // detects corrupted or truncated files while streaming. Nothing may be written
+        // after close(). A codec other than NONE (compression.hpp) implies framed and
+        // compresses each block in the background write, in parallel with the encoding
+        // of the next one.
+        //
+        // The descriptor is not owned: the caller opens and closes it (see open_fd).
+        // ---------------------------------------------------------------------------
+        class BinaryWriter
+        {
+            public:
+                inline static constexpr size_t DEFAULT_WINDOW = 1 << 20;
+
+            private:
+                int                        mfd;
+                bool                       masync;
+                bool                       mframed;
+                Codec                      mcodec;
+                bool                       mclosed  = false;
+                size_t                     mheadroom;  // Room for the frame header in front of each block.
+                std::vector<std::byte>     mblocks[2];
+                std::vector<std::byte>     mcompressed[2]; // Frame header and compressed block, per block.
+                size_t                     mcurrent = 0;
+                BinaryBuffer               mbb;
+                std::future<Result<Bool>>  mpending;
+                Result<Bool>               mstatus  = Result<Bool>(Bool::T);
+                size_t                     mflushed = 0;
+
+                // Writes the n bytes at payload, preceded by their frame header when framed and
+                // compressed into compressed when codec is not NONE.
+                static Result<Bool> write_block(int fd, std::byte* payload, size_t n, bool framed, Codec codec, std::span<std::byte> compressed)
+                {
+                    if (!framed) return write_all(fd, { payload, n });
+                    if (codec != Codec::NONE)
+                    {
+                        n = compress_block(codec, { payload, n }, compressed.subspan(sizeof(FrameHeader)));
+                        payload = compressed.data() + sizeof(FrameHeader);
+                    }
+                    const FrameHeader h({ payload, n });
+                    std::memcpy(payload - sizeof(h), &h, sizeof(h));
+                    return write_all(fd, { payload - sizeof(h), n + sizeof(h) });
+                }
+
+                std::byte* payload() noexcept { return mblocks[mcurrent].data() + mheadroom; }
+
+                Result<Bool> write_current(size_t n)
+                {
+                    return write_block(mfd, payload(), n, mframed, mcodec, mcompressed[mcurrent]);
+                }
+
+                // Waits for the block being written in the background, if any.
+                Result<Bool> wait()
+                {
+                    if (!mpending.valid()) return Result<Bool>(Bool::T);
+                    Result<Bool> r = mpending.get();
+                    if (!r) mstatus = r;
+                    return r;
+                }
+
+                // Sink spill: the current block is full.
+                std::span<std::byte> spill(std::span<const std::byte> written)
+                {
+                    if (!wait()) return {};
+                    if (masync)
+                    {
+                        mpending = std::async(std::launch::async, [this, block = mcurrent, n = written.size()]()
+                            { return write_block(mfd, mblocks[block].data() + mheadroom, n, mframed, mcodec, mcompressed[block]); });
+                        mcurrent ^= 1;
+                    }
+                    else
+                    {
+                        Result<Bool> r = write_current(written.size());
+                        if (!r)
+                        {
+                            mstatus = r;
+                            return {};
+                        }
+                    }
+                    mflushed += written.size();
+                    return std::span<std::byte>(mblocks[mcurrent]).subspan(mheadroom);
+                }
+
+                void attach_block()
+                {
+                    mbb.attach_sink(std::span<std::byte>(mblocks[mcurrent]).subspan(mheadroom), [this](std::span<const std::byte> written, size_t) { return spill(written); });
+                }
+
+            public:
+                explicit BinaryWriter(int fd, size_t window = DEFAULT_WINDOW, bool async = true, bool framed = false, Codec codec = Codec::NONE)
+                    : mfd(fd), masync(async), mframed(framed || codec != Codec::NONE), mcodec(codec), mheadroom(mframed ? sizeof(FrameHeader) : 0), mbb(0)
+                {
+                    window = std::clamp<size_t>(window, 64, MAX_FRAME_BLOCK);
+                    for (size_t b = 0; b < (async ? 2 : 1); ++b)
+                    {
+                        mblocks[b].resize(mheadroom + window);
+                        if (codec != Codec::NONE) mcompressed[b].resize(sizeof(FrameHeader) + compress_bound(window));
+                    }
+                    if (mframed)
+                    {
+                        const FrameFileHeader h(static_cast<std::uint32_t>(window), codec);
+                        mstatus = write_all(mfd, std::as_bytes(std::span<const FrameFileHeader>(&h, 1)));
+                    }
+                    attach_block();
+                }
+
+                // The sink calls back into this object: neither copyable nor movable.
+                BinaryWriter(const BinaryWriter&) = delete;
+                BinaryWriter& operator=(const BinaryWriter&) = delete;
+
+                ~BinaryWriter() { close(); }
+
+                /// \brief Writes the buffered bytes and waits until everything reached the descriptor.
+                Result<Bool> flush()
+                {
+                    wait();
+                    if (mstatus && mbb.size() > 0)
+                    {
+                        Result<Bool> r = write_current(mbb.size());
+                        if (!r) mstatus = r;
+                        else mflushed += mbb.size();
+                    }
+                    attach_block();
+                    return mstatus;
+                }
+
+                /// \brief Flushes and, when framed, writes the end frame. Called by the destructor.
+                Result<Bool> close()
+                {
+                    flush();
+                    if (mframed && !mclosed && mstatus)
+                    {
+                        struct { FrameHeader mheader; LEUInt64 mtotal; } end;
+                        end.mheader = FrameHeader::end(mflushed, end.mtotal);
+                        mstatus = write_all(mfd, std::as_bytes(std::span(&end, 1)));
+                    }
+                    mclosed = true;
+                    return mstatus;
+                }
+
+                /// \brief Sticky status: the first I/O error, if any, else the buffer's error
+                /// (e.g. a read past the end of the stream or a rejected record).
+                [[nodiscard]] Result<Bool> status() const { return mstatus ? mbb.status() : mstatus; }
+
+                /// \brief Bytes written so far, including those still buffered.
+                [[nodiscard]] size_t size() const noexcept { return mflushed + mbb.size(); }
+
+                [[nodiscard]] size_t window() const noexcept { return mblocks[0].size() - mheadroom; }
+
+                [[nodiscard]] bool framed() const noexcept { return mframed; }
+
+                [[nodiscard]] Codec codec() const noexcept { return mcodec; }
+
+                // Compact integers mode (see BinaryBuffer::set_compact_integers).
+                void set_compact_integers(bool on) noexcept { mbb.set_compact_integers(on); }
+                [[nodiscard]] bool compact_integers() const noexcept { return mbb.compact_integers(); }
+
+                // Compact types mode (see BinaryBuffer::set_compact_types).
+                void set_compact_types(bool on) { mbb.set_compact_types(on); }
+                [[nodiscard]] bool compact_types() const noexcept { return mbb.compact_types(); }
+
+                // ======================================================================
+                // WRITE METHODS
+                // ======================================================================
+
+                BinaryWriter& write(std::span<const std::byte> src)
+                {
+                    mbb.write(src);
+                    return *this;
+                }
+
+                // Write any object that satisfies BinaryBufferIO
+                template <BinaryBufferIO T>
+                BinaryWriter& write(const T& obj)
+                {
+                    obj.write(mbb);
+                    return *this;
+                }
+
+                // Trivial types (int, float, etc.)
+                template <typename T>
+                BinaryWriter& write(const T& pod)
+                    requires std::is_trivially_copyable_v<T> && (!BinaryBufferIO<T>) &&
+                             (!std::is_same_v<std::remove_cvref_t<T>, std::span<std::byte>>) &&
+                             (!std::is_same_v<std::remove_cvref_t<T>, std::span<const std::byte>>)
+                {
+                    mbb.write(pod);
+                    return *this;
+                }
+        };
+
+        // ---------------------------------------------------------------------------
+        // Class: BinaryReader
+        // ---------------------------------------------------------------------------
+        // Streams BinaryBufferIO objects from a file descriptor through a bounded window.
+        // Objects are deserialized by their usual read(BinaryBuffer&) from a BinaryBuffer
+        // attached as a source to the current block; while it is consumed the next block
+        // is read ahead in the background (async = true). Values that straddle two
+        // blocks are handled by copying the unread tail in front of the next block, into
+        // headroom reserved for that, so the read-ahead never has to wait for it.
+        //
+        // With framed = true the descriptor must hold a stream written by a framed
+        // BinaryWriter: each block is one frame, whose CRC32C is verified as it is read
+        // (in the read-ahead when async), and the window is the writer's block size. A
+        // corrupted frame, or a stream without its end frame, stops the stream with an
+        // error status instead of handing the bytes over. Compressed frames are
+        // decompressed in the read-ahead as well.
+        //
+        // The descriptor is not owned: the caller opens and closes it (see open_fd).
+        // ---------------------------------------------------------------------------
+        class BinaryReader
+        {
+            public:
+                inline static constexpr size_t DEFAULT_WINDOW = 1 << 20;
+
+            private:
+                int                          mfd;
+                bool                         masync;
+                bool                         mframed;
+                size_t                       mwindow;
+                size_t                       mheadroom;
+                std::vector<std::byte>       mblocks[2]; // mheadroom + mwindow bytes each.
+                size_t                       mcurrent     = 0;
+                BinaryBuffer                 mbb;
+                std::future<Result<size_t>>  mpending;   // Read ahead into the other block.
+                Result<Bool>                 mstatus      = Result<Bool>(Bool::T);
+                bool                         mfile_end    = false;
+                size_t                       mwindow_pos  = 0; // Stream position of mbb's window.
+                bool                         mend_frame   = false; // Framed: end frame verified.
+                Codec                        mcodec       = Codec::NONE;
+                std::vector<std::byte>       mcompressed;          // Framed, compressed: frame being read.
+                std::uint64_t                mframe_total = 0;     // Framed: payload bytes verified.
+
+                // Reads the next frame into dest, verifying it; 0 bytes at the end frame.
+                Result<size_t> read_frame(std::span<std::byte> dest)
+                {
+                    FrameHeader h;
+                    Result<size_t> r = read_fill(mfd, std::as_writable_bytes(std::span<FrameHeader>(&h, 1)));
+                    if (!r) return Result<size_t>(r.merror_message, 0);
+                    if (r.mresult < sizeof(h)) return Result<size_t>(W("Truncated framed stream"), 0);
+                    if (h.is_end())
+                    {
+                        LEUInt64 total;
+                        r = read_fill(mfd, std::as_writable_bytes(std::span<LEUInt64>(&total, 1)));
+                        if (!r) return Result<size_t>(r.merror_message, 0);
+                        if (r.mresult < sizeof(total)) return Result<size_t>(W("Truncated framed stream"), 0);
+                        if (Result<Bool> e = h.check_end(total, mframe_total); !e) return Result<size_t>(e.merror_message, 0);
+                        mend_frame = true;
+                        return Result<size_t>(size_t{ 0 });
+                    }
+                    // One read-ahead at a time: frames of any block can share mcompressed.
+                    const std::span<std::byte> into = mcodec == Codec::NONE ? dest : std::span<std::byte>(mcompressed);
+                    const size_t length = h.mlength.value();
+                    if (length > into.size()) return Result<size_t>(W("Frame larger than the block size"), 0);
+                    r = read_fill(mfd, into.first(length));
+                    if (!r) return Result<size_t>(r.merror_message, 0);
+                    if (r.mresult < length) return Result<size_t>(W("Truncated framed stream"), 0);
+                    if (Result<Bool> e = h.check(into.first(length)); !e) return Result<size_t>(e.merror_message, 0);
+                    size_t n = length;
+                    if (mcodec != Codec::NONE)
+                    {
+                        Result<size_t> d = decompress_block(into.first(length), dest);
+                        if (!d) return d;
+                        n = d.mresult;
+                    }
+                    mframe_total += n;
+                    return Result<size_t>(n);
+                }
+
+                // Reads the next block: a frame when framed, else up to dest.size() bytes.
+                Result<size_t> read_block(std::span<std::byte> dest)
+                {
+                    return mframed ? read_frame(dest) : read_fill(mfd, dest);
+                }
+
+                // Records the outcome of a block read: errors and the end of the stream.
+                void note_block(const Result<size_t>& r)
+                {
+                    if (!r) mstatus = Result<Bool>(r.merror_message, Bool::F);
+                    if (!r || (mframed ? mend_frame : r.mresult < mwindow)) mfile_end = true;
+                }
+
+                void read_file_header()
+                {
+                    FrameFileHeader h;
+                    Result<size_t> r = read_fill(mfd, std::as_writable_bytes(std::span<FrameFileHeader>(&h, 1)));
+                    Result<Bool> ok = !r ? Result<Bool>(r.merror_message, Bool::F) :
+                        r.mresult < sizeof(h) ? Result<Bool>(W("Truncated framed stream")) : h.check();
+                    if (!ok)
+                    {
+                        mstatus = ok;
+                        mfile_end = true;
+                        return;
+                    }
+                    mwindow = h.mblock_size.value();
+                    mcodec = h.codec();
+                    if (mcodec != Codec::NONE) mcompressed.resize(h.max_payload());
+                }
+
+                std::span<std::byte> payload(size_t block) noexcept
+                {
+                    return std::span<std::byte>(mblocks[block]).subspan(mheadroom, mwindow);
+                }
+
+                void read_ahead(size_t block)
+                {
+                    if (mfile_end || !masync) return;
+                    mpending = std::async(std::launch::async, [this, dest = payload(block)]() { return read_block(dest); });
+                }
+
+                // Bytes that landed in the payload of block (read ahead or read now).
+                size_t fetch(size_t block)
+                {
+                    if (mfile_end) return 0;
+                    Result<size_t> r = mpending.valid() ? mpending.get() : read_block(payload(block));
+                    note_block(r);
+                    return r.mresult;
+                }
+
+                // Completes a window in staging with blocks read synchronously until it holds
+                // min_bytes, then makes it the current window, growing the headroom to fit.
+                std::span<const std::byte> stage(std::vector<std::byte> staging, size_t min_bytes, size_t next)
+                {
+                    while (staging.size() < min_bytes && !mfile_end && mstatus)
+                    {
+                        const size_t have = staging.size();
+                        staging.resize(have + mwindow);
+                        Result<size_t> r = read_block(std::span<std::byte>(staging).subspan(have));
+                        note_block(r);
+                        staging.resize(have + r.mresult);
+                    }
+                    mheadroom = (std::max)(mheadroom, staging.size());
+                    for (std::vector<std::byte>& b : mblocks)
+                        if (!b.empty()) b.resize(mheadroom + mwindow);
+                    std::vector<std::byte>& block = mblocks[next];
+                    std::memcpy(block.data() + mheadroom - staging.size(), staging.data(), staging.size());
+                    mcurrent = next;
+                    read_ahead(next ^ 1);
+                    return { block.data() + mheadroom - staging.size(), staging.size() };
+                }
+
+                // Source refill: next window starting at the first unread byte.
+                std::span<const std::byte> refill(size_t consumed, size_t min_bytes)
+                {
+                    std::span<const std::byte> old = mbb.data();
+                    consumed = (std::min)(consumed, old.size());
+                    const std::span<const std::byte> tail = old.subspan(consumed);
+                    mwindow_pos += consumed;
+
+                    const size_t next = mcurrent ^ (masync ? 1 : 0);
+                    std::vector<std::byte>& block = mblocks[next];
+                    if (tail.size() > mheadroom || tail.size() + mwindow < min_bytes)
+                    {
+                        // Slow path for values larger than the headroom or the window: grow the
+                        // headroom and read synchronously.
+                        std::vector<std::byte> staging(tail.begin(), tail.end());
+                        const size_t n = fetch(next);
+                        staging.insert(staging.end(), block.begin() + mheadroom, block.begin() + mheadroom + n);
+                        return stage(std::move(staging), min_bytes, next);
+                    }
+
+                    // Tail first: without read ahead the block being refilled is the current one.
+                    std::byte* start = block.data() + mheadroom - tail.size();
+                    if (!tail.empty()) std::memmove(start, tail.data(), tail.size());
+                    const size_t n = fetch(next);
+                    // A short frame (flushed early) may not complete the value: stage the rest.
+                    if (tail.size() + n < min_bytes && !mfile_end && mstatus)
+                        return stage(std::vector<std::byte>(start, start + tail.size() + n), min_bytes, next);
+                    mcurrent = next;
+                    read_ahead(next ^ 1);
+                    return { start, tail.size() + n };
+                }
+
+                void attach_window(std::span<const std::byte> window)
+                {
+                    mbb.attach_source(window, [this](size_t consumed, size_t min_bytes) { return refill(consumed, min_bytes); });
+                }
+
+            public:
+                explicit BinaryReader(int fd, size_t window = DEFAULT_WINDOW, bool async = true, bool framed = false)
+                    : mfd(fd), masync(async), mframed(framed), mwindow((std::max)(window, size_t{ 64 })), mbb(0)
+                {
+                    if (framed) read_file_header();
+                    mheadroom = (std::min)(mwindow, size_t{ 64 * 1024 });
+                    mblocks[0].resize(mheadroom + mwindow);
+                    if (async) mblocks[1].resize(mheadroom + mwindow);
+                    const size_t n = fetch(0);
+                    read_ahead(1);
+                    attach_window({ mblocks[0].data() + mheadroom, n });
+                }
+
+                // The source calls back into this object: neither copyable nor movable.
+                BinaryReader(const BinaryReader&) = delete;
+                BinaryReader& operator=(const BinaryReader&) = delete;
+
+                ~BinaryReader()
+                {
+                    if (mpending.valid()) mpending.wait();
+                }
+
+                /// \brief Sticky status: the first I/O error, if any, else the buffer's error
+                /// (e.g. a read past the end of the stream or a rejected record).
+                [[nodiscard]] Result<Bool> status() const { return mstatus ? mbb.status() : mstatus; }
+
+                /// \brief Bytes consumed so far.
+                [[nodiscard]] size_t position() const noexcept { return mwindow_pos + (mbb.size() - mbb.remaining()); }
+
+                /// \brief True when every byte of the descriptor has been consumed.
+                [[nodiscard]] bool eof()
+                {
+                    if (mbb.remaining() > 0) return false;
+                    if (mfile_end && !mpending.valid()) return true;
+                    attach_window(refill(mbb.size(), 1));
+                    return mbb.remaining() == 0;
+                }
+
+                [[nodiscard]] size_t window() const noexcept { return mwindow; }
+
+                [[nodiscard]] bool framed() const noexcept { return mframed; }
+
+                [[nodiscard]] Codec codec() const noexcept { return mcodec; }
+
+                // Compact integers mode (see BinaryBuffer::set_compact_integers).
+                void set_compact_integers(bool on) noexcept { mbb.set_compact_integers(on); }
+                [[nodiscard]] bool compact_integers() const noexcept { return mbb.compact_integers(); }
+
+                // Compact types mode (see BinaryBuffer::set_compact_types).
+                void set_compact_types(bool on) { mbb.set_compact_types(on); }
+                [[nodiscard]] bool compact_types() const noexcept { return mbb.compact_types(); }
+
+                // ======================================================================
+                // READ METHODS
+                // ======================================================================
+
+                BinaryReader& read(std::span<std::byte> dest)
+                {
+                    mbb.read(dest);
+                    return *this;
+                }
+
+                // Read into a BinarySerializable object
+                template <BinaryBufferIO T>
+                BinaryReader& read(T& obj)
+                {
+                    obj.read(mbb);
+                    return *this;
+                }
+
+                // Read into a trivial type (int, float, etc.)
+                template <typename T>
+                BinaryReader& read(T& pod)
+                    requires std::is_trivially_copyable_v<T> && (!BinaryBufferIO<T>) &&
+                             (!std::is_same_v<std::remove_cvref_t<T>, std::span<std::byte>>) &&
+                             (!std::is_same_v<std::remove_cvref_t<T>, std::span<const std::byte>>)
+                {
+                    mbb.read(pod);
+                    return *this;
+                }
+
+                // Advances the read position by n bytes without copying them.
+                BinaryReader& skip(size_t n)
+                {
+                    mbb.skip(n);
+                    return *this;
+                }
+        };
+    } // namespace cpplib
+} // namespace pensar_digital
+
+#endif // BINARY_STREAM_HPP_INCLUDED
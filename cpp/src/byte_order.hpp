@@ -6,6 +6,22 @@
 
 #include <span>
 #include <bit>
+#include <cstring>   // std::memcpy
+#include <cstdint>
+#include <concepts>
+#include <type_traits>
+#include <algorithm> // std::min, std::reverse
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h> // __cpuid, __cpuidex
+        #define PD_TARGET(isa)
+    #else
+        #define PD_TARGET(isa) __attribute__((target(isa)))
+    #endif
+    #define PD_BYTESWAP_X86 1
+#endif
 
 namespace pensar_digital
 {
@@ -59,27 +75,189 @@ namespace pensar_digital
         inline const ByteOrder big_address_8_byte_order    = ByteOrder (std::endian::big   , ADDRESS_INVARIANCE, sizeof (std::byte) * 8);
         inline const ByteOrder native_byte_order           = ByteOrder (std::endian::native, ADDRESS_INVARIANCE, sizeof (std::byte) * 8);
 
-        template < size_t sz = 18>
-        void convert(std::span<std::byte>& data, size_t original_data_size, const ByteOrder& from, const ByteOrder& to) noexcept
+        // ------------------------------------------------------------
+        // Bulk byte swapping
+        // ------------------------------------------------------------
+        // Reverses the bytes of each 2, 4 or 8 byte element of an array, 16 bytes per
+        // step with SSSE3 or 32 with AVX2 shuffles, the tail with std::byteswap. The
+        // kernel is picked once at run time from what the CPU supports, so the binary
+        // needs no -mavx2 and still runs on older machines.
+
+        enum class SimdLevel : uint8_t { SCALAR, SSSE3, AVX2 };
+
+        // Widest instruction set the byte swap kernels can use on this CPU.
+        inline SimdLevel simd_level() noexcept
         {
-            if ((from != to) && (data.size() > 1) && from.only_endian_differs(to) && (original_data_size > 1))
+            static const SimdLevel level = []() noexcept
             {
-                auto e = data.size() - original_data_size;
-                for (std::span<std::byte>::size_type i = 0; i <= e; i += original_data_size)
+#ifdef PD_BYTESWAP_X86
+    #if defined(_MSC_VER) && !defined(__clang__)
+                int r[4];
+                __cpuid(r, 0);
+                const int max_leaf = r[0];
+                __cpuid(r, 1);
+                const bool ssse3   = (r[2] & (1 << 9)) != 0;
+                const bool osxsave = (r[2] & (1 << 27)) != 0;
+                bool avx2 = false;
+                if (max_leaf >= 7 && osxsave && (_xgetbv(0) & 0x6) == 0x6)
                 {
-                    auto x = original_data_size / 2;
-                    for (auto j = 0; j < x; ++j)
+                    __cpuidex(r, 7, 0);
+                    avx2 = (r[1] & (1 << 5)) != 0;
+                }
+                if (avx2)  return SimdLevel::AVX2;
+                if (ssse3) return SimdLevel::SSSE3;
+    #else
+                __builtin_cpu_init();
+                if (__builtin_cpu_supports("avx2"))  return SimdLevel::AVX2;
+                if (__builtin_cpu_supports("ssse3")) return SimdLevel::SSSE3;
+    #endif
+#endif
+                return SimdLevel::SCALAR;
+            }();
+            return level;
+        }
+
+        // Unsigned integer of N bytes.
+        template <size_t N>
+        using UIntOfSize = std::conditional_t<N == 2, std::uint16_t, std::conditional_t<N == 4, std::uint32_t, std::uint64_t>>;
+
+        template <size_t N>
+        inline void byteswap_scalar(const std::byte* in, std::byte* out, size_t count) noexcept
+        {
+            using U = UIntOfSize<N>;
+            for (size_t i = 0; i < count; ++i, in += N, out += N)
+            {
+                U v;
+                std::memcpy(&v, in, N);
+                v = std::byteswap(v);
+                std::memcpy(out, &v, N);
+            }
+        }
+
+#ifdef PD_BYTESWAP_X86
+        // pshufb control reversing each N byte group of a 16 byte lane.
+        template <size_t N>
+        inline __m128i byteswap_mask() noexcept
+        {
+            alignas(16) std::int8_t m[16];
+            for (int i = 0; i < 16; ++i)
+                m[i] = static_cast<std::int8_t>((i / N) * N + (N - 1 - i % N));
+            return _mm_load_si128(reinterpret_cast<const __m128i*>(m));
+        }
+
+        template <size_t N>
+        PD_TARGET("ssse3") inline void byteswap_ssse3(const std::byte* in, std::byte* out, size_t count) noexcept
+        {
+            const __m128i mask = byteswap_mask<N>();
+            const size_t blocks = count * N / 16;
+            for (size_t b = 0; b < blocks; ++b, in += 16, out += 16)
+            {
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_shuffle_epi8(v, mask));
+            }
+            byteswap_scalar<N>(in, out, count - blocks * 16 / N);
+        }
+
+        template <size_t N>
+        PD_TARGET("avx2") inline void byteswap_avx2(const std::byte* in, std::byte* out, size_t count) noexcept
+        {
+            const __m128i lane = byteswap_mask<N>();
+            const __m256i mask = _mm256_broadcastsi128_si256(lane);
+            const size_t blocks = count * N / 64;
+            // Two independent 32 byte shuffles per step keep both load ports busy.
+            for (size_t b = 0; b < blocks; ++b, in += 64, out += 64)
+            {
+                const __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in));
+                const __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 32));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out),      _mm256_shuffle_epi8(v0, mask));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 32), _mm256_shuffle_epi8(v1, mask));
+            }
+            const size_t done = blocks * 64 / N;
+            size_t rest = count - done;
+            if (rest * N >= 32)
+            {
+                const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_shuffle_epi8(v, mask));
+                in += 32; out += 32; rest -= 32 / N;
+            }
+            if (rest * N >= 16)
+            {
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_shuffle_epi8(v, lane));
+                in += 16; out += 16; rest -= 16 / N;
+            }
+            byteswap_scalar<N>(in, out, rest);
+        }
+#endif
+
+        // Byte swaps count elements of N bytes from in to out with the given kernel.
+        // in and out may be the same memory (in place), they must not partially overlap.
+        template <size_t N>
+        inline void byteswap_copy(const std::byte* in, std::byte* out, size_t count, SimdLevel level) noexcept
+        {
+            static_assert(N == 2 || N == 4 || N == 8, "Elements of 2, 4 or 8 bytes");
+#ifdef PD_BYTESWAP_X86
+            if (level == SimdLevel::AVX2)  return byteswap_avx2 <N>(in, out, count);
+            if (level == SimdLevel::SSSE3) return byteswap_ssse3<N>(in, out, count);
+#else
+            (void)level;
+#endif
+            byteswap_scalar<N>(in, out, count);
+        }
+
+        // Same, with the widest kernel this CPU supports.
+        template <size_t N>
+        inline void byteswap_copy(const std::byte* in, std::byte* out, size_t count) noexcept
+        {
+            byteswap_copy<N>(in, out, count, simd_level());
+        }
+
+        // Byte swaps count elements of element_size bytes. Sizes other than 2, 4 and 8 are
+        // reversed byte by byte.
+        inline void byteswap_copy(const std::byte* in, std::byte* out, size_t count, size_t element_size) noexcept
+        {
+            switch (element_size)
+            {
+                case 2: return byteswap_copy<2>(in, out, count);
+                case 4: return byteswap_copy<4>(in, out, count);
+                case 8: return byteswap_copy<8>(in, out, count);
+                default:
+                    for (size_t i = 0; i < count; ++i, in += element_size, out += element_size)
                     {
-                        pd::swap<std::byte>(data[i + j], data[i - j + original_data_size - 1]);
+                        if (in != out) std::memcpy(out, in, element_size);
+                        std::reverse(out, out + element_size);
                     }
-                }
             }
+        }
 
-        } // convert
-        
-        inline void convert(const std::span<std::byte>& from_data, std::span<std::byte>& to_data, const ByteOrder& from, const ByteOrder& to) noexcept
+        // Reverses the byte order of every sizeof(T) element of bytes in place. The bytes
+        // need not be aligned for T (e.g. a range inside a BinaryBuffer).
+        template <std::integral T>
+        inline void byteswap_in_place(std::span<std::byte> bytes) noexcept
+        {
+            if constexpr (sizeof(T) > 1)
+                byteswap_copy(bytes.data(), bytes.data(), bytes.size() / sizeof(T), sizeof(T));
+        }
+
+        template < size_t sz = 18>
+        void convert(std::span<std::byte>& data, size_t original_data_size, const ByteOrder& from, const ByteOrder& to) noexcept
         {
+            if ((from != to) && (data.size() > 1) && from.only_endian_differs(to) && (original_data_size > 1))
+                byteswap_copy(data.data(), data.data(), data.size() / original_data_size, original_data_size);
+        } // convert
 
+        // Out of place conversion of the elements of original_data_size bytes in from_data into
+        // to_data (min (from_data.size (), to_data.size ()) bytes, whole elements only).
+        // Converting while copying reads and writes each byte once, e.g. from a network or
+        // file buffer into the destination array.
+        inline void convert(std::span<const std::byte> from_data, std::span<std::byte> to_data, size_t original_data_size, const ByteOrder& from, const ByteOrder& to) noexcept
+        {
+            const size_t count = original_data_size == 0 ? 0 : (std::min)(from_data.size(), to_data.size()) / original_data_size;
+            if (count == 0) return;
+            if ((from != to) && from.only_endian_differs(to) && (original_data_size > 1))
+                byteswap_copy(from_data.data(), to_data.data(), count, original_data_size);
+            else
+                std::memcpy(to_data.data(), from_data.data(), count * original_data_size);
         } // convert
 
 
@@ -3,6 +3,8 @@
 #ifndef CLASS_INFO_HPP
 #define CLASS_INFO_HPP
 
+#include "binary_buffer.hpp"
+
 namespace pensar_digital
 {
 	namespace cpplib
@@ -60,6 +62,12 @@ namespace pensar_digital
                 return full_class_name ();
             }
 
+            /// \brief Compares serialized ClassInfo bytes (e.g. a BinaryBuffer view) with this one without copying them.
+            inline bool matches (std::span<const std::byte> b) const noexcept
+            {
+                return (b.size() == sizeof(ClassInfo)) && (std::memcmp(b.data(), this, sizeof(ClassInfo)) == 0);
+            }
+
             inline std::span<const std::byte> bytes () const noexcept 
             {
                 return std::span<const std::byte>(reinterpret_cast<const std::byte*>(this), sizeof(ClassInfo));
@@ -70,6 +78,38 @@ namespace pensar_digital
             {
                 return std::span<std::byte>(reinterpret_cast<std::byte*>(this), sizeof(ClassInfo));
             }
+
+            /// \brief Writes this ClassInfo as the type tag of a record: its bytes or, in compact types mode, a type id (see BinaryBuffer::set_compact_types).
+            inline BinaryBuffer& write_tag (BinaryBuffer& bb) const noexcept
+            {
+                return bb.write_type(this, bytes());
+            }
+
+            /// \brief Reads a type tag written by write_tag and checks it is this class, then ensures payload more bytes
+            /// can be read so the caller may use unchecked reads. Returns false with the buffer error set otherwise.
+            inline bool read_tag (BinaryBuffer& bb, size_t payload = 0) const noexcept
+            {
+                if (!bb.compact_types())
+                {
+                    if (!bb.ensure(sizeof(ClassInfo) + payload)) return false;
+                    if (matches(bb.view_unchecked(sizeof(ClassInfo)))) return true;
+                    bb.fail(BufferError::INVALID_DATA);
+                    return false;
+                }
+                TypeTable::Entry* e = bb.read_type(sizeof(ClassInfo));
+                if (e == nullptr) return false;
+                if (e->mlocal != this)
+                {
+                    // First record of this type in the stream: compare once, then it is a pointer compare.
+                    if (!matches(e->mdefinition))
+                    {
+                        bb.fail(BufferError::INVALID_DATA);
+                        return false;
+                    }
+                    e->mlocal = this;
+                }
+                return bb.ensure(payload);
+            }
         };
 
 
@@ -78,7 +118,7 @@ namespace pensar_digital
         concept HasClassInfo = requires
         {
             // Check for static const ClassInfo* members
-            { T::INFO } -> std::same_as<const ClassInfo>;
+            { T::INFO } -> std::same_as<const ClassInfo&>;
             // Ensure they are static and constant (implicit in the requires clause with ::)
                 requires std::is_same_v<decltype(T::INFO), const ClassInfo>;
         };
@@ -0,0 +1,145 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#ifndef CLASS_INFO_TABLE_HPP
+#define CLASS_INFO_TABLE_HPP
+
+#include <span>
+#include <deque>
+#include <mutex>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include "s.hpp"
+#include "equal.hpp"
+#include "class_info.hpp"
+
+namespace pensar_digital::cpplib
+{
+    // Process wide index of a distinct ClassInfo (see ClassInfoTable). Not serialized: ids
+    // depend on the order classes are first interned.
+    using ClassId = std::uint32_t;
+
+    // A ClassInfo with what is costly to derive from it computed once.
+    struct InternedClass
+    {
+        ClassInfo minfo;
+        size_t    mhash;      //!< Hash of the ClassInfo bytes.
+        S         mfull_name; //!< full_class_name (), built once.
+        ClassId   mid;
+    };
+
+    // ------------------------------------------------------------
+    // ClassInfoTable
+    // ------------------------------------------------------------
+    // Hash-consing table of ClassInfo: equal ClassInfo bytes (versions included) get the
+    // same ClassId, so once interned two classes compare as integers and their name is a
+    // cached string instead of an SStream build. Entries live as long as the process;
+    // find does not add, so lookups of untrusted bytes (e.g. a stream) cannot grow it.
+    //
+    // Thread safe. For a class known at compile time use class_id<T> (), a static after
+    // its first call.
+    class ClassInfoTable
+    {
+        public:
+            // 64-bit multiply-xor over the bytes, 8 at a time.
+            static size_t hash(std::span<const std::byte> b) noexcept
+            {
+                constexpr std::uint64_t M = 0x9E3779B97F4A7C15ull;
+                std::uint64_t h = b.size() * M;
+                size_t i = 0;
+                for (; i + 8 <= b.size(); i += 8)
+                {
+                    std::uint64_t w;
+                    std::memcpy(&w, b.data() + i, 8);
+                    h = (h ^ w) * M;
+                    h ^= h >> 29;
+                }
+                std::uint64_t tail = 0;
+                if (i < b.size()) std::memcpy(&tail, b.data() + i, b.size() - i);
+                h = (h ^ tail) * M;
+                return static_cast<size_t>(h ^ (h >> 32));
+            }
+
+            // The id of info, adding it if new.
+            static ClassId intern(const ClassInfo& info)
+            {
+                const std::span<const std::byte> b = info.bytes();
+                const size_t h = hash(b);
+                State& s = state();
+                {
+                    std::shared_lock lock(s.mmutex);
+                    if (std::optional<ClassId> id = s.lookup(b, h)) return *id;
+                }
+                std::unique_lock lock(s.mmutex);
+                if (std::optional<ClassId> id = s.lookup(b, h)) return *id; // Interned meanwhile.
+                const ClassId id = static_cast<ClassId>(s.mentries.size());
+                s.mentries.push_back(InternedClass{ info, h, info.full_class_name(), id });
+                s.mbuckets.emplace(h, id);
+                return id;
+            }
+
+            // The id of serialized ClassInfo bytes (e.g. a type tag) if already interned.
+            static std::optional<ClassId> find(std::span<const std::byte> b)
+            {
+                if (b.size() != sizeof(ClassInfo)) return std::nullopt;
+                State& s = state();
+                std::shared_lock lock(s.mmutex);
+                return s.lookup(b, hash(b));
+            }
+            static std::optional<ClassId> find(const ClassInfo& info) { return find(info.bytes()); }
+
+            // Entries never move, so the reference stays valid.
+            static const InternedClass& get(ClassId id)
+            {
+                State& s = state();
+                std::shared_lock lock(s.mmutex);
+                return s.mentries[id];
+            }
+
+            static size_t size()
+            {
+                State& s = state();
+                std::shared_lock lock(s.mmutex);
+                return s.mentries.size();
+            }
+
+        private:
+            struct State
+            {
+                std::shared_mutex mmutex;
+                std::deque<InternedClass> mentries; // A deque keeps entry addresses stable.
+                std::unordered_multimap<size_t, ClassId> mbuckets;
+
+                std::optional<ClassId> lookup(std::span<const std::byte> b, size_t h) const noexcept
+                {
+                    auto [first, last] = mbuckets.equal_range(h);
+                    for (auto it = first; it != last; ++it)
+                        if (mentries[it->second].minfo.matches(b)) return it->second;
+                    return std::nullopt;
+                }
+            };
+
+            // Function local, so classes registering themselves during static
+            // initialization (e.g. commands) find it constructed.
+            static State& state()
+            {
+                static State s;
+                return s;
+            }
+    };
+
+    // ClassId of T::INFO, interned on first use.
+    template <HasClassInfo T>
+    inline ClassId class_id()
+    {
+        static const ClassId id = ClassInfoTable::intern(T::INFO);
+        return id;
+    }
+}
+
+#endif // CLASS_INFO_TABLE_HPP
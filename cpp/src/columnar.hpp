@@ -0,0 +1,573 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#ifndef COLUMNAR_HPP
+#define COLUMNAR_HPP
+
+#include <bit>
+#include <span>
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <algorithm>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+
+#include "data.hpp"          // ColumnInfo, DATA_COLUMNS
+#include "endian.hpp"
+#include "varint.hpp"
+#include "byte_order.hpp"    // byteswap_copy
+#include "binary_buffer.hpp"
+
+namespace pensar_digital::cpplib
+{
+    // ------------------------------------------------------------
+    // Columnar file format
+    // ------------------------------------------------------------
+    // Stores Data records (e.g. Person::Data) column by column, one column per member
+    // listed in its COLUMNS (see DATA_COLUMNS in data.hpp), so a scan of one member
+    // reads only that member's bytes. Layout:
+    //
+    //   ColumnarHeader | ColumnEntry x column_count | column chunks (64 byte aligned)
+    //
+    // The header and the directory are little endian. Values are stored in the wire
+    // endian of the header: members whose ColumnInfo has a byte order unit (mswap) are
+    // converted, other members are copied as bytes. Each chunk is encoded on its own:
+    //
+    //   PLAIN      : rows values.
+    //   RLE        : (varint run length, value) pairs.
+    //   DICTIONARY : dictionary_size distinct values, then one index per row
+    //                (uint8 up to 256 values, little endian uint16 up to 65536).
+    //
+    // Over a MappedBinaryBuffer only the pages of the header, the directory and the
+    // chunks being read are faulted in.
+
+    enum class ColumnEncoding : std::uint8_t
+    {
+        AUTO       = 0, //!< Writer only: the smallest of the others.
+        PLAIN      = 1,
+        RLE        = 2,
+        DICTIONARY = 3
+    };
+
+    inline constexpr size_t COLUMNAR_CHUNK_ALIGNMENT = 64;
+    inline constexpr size_t COLUMNAR_MAX_DICTIONARY  = 65536;
+    inline constexpr size_t COLUMNAR_MAX_NAME        = 31;
+
+    struct ColumnarHeader
+    {
+        char          mmagic[4] = { 'P', 'D', 'C', 'F' };
+        std::uint16_t mversion  = 1;
+        std::int8_t   mendian   = Endian::LITTLE; //!< Wire endian of the values.
+        std::uint8_t  mreserved = 0;
+        std::uint32_t mcolumn_count = 0;
+        std::uint32_t mrecord_size  = 0;
+        std::uint64_t mrows = 0;
+    };
+    static_assert(StdLayoutTriviallyCopyableNoPadding<ColumnarHeader> && sizeof(ColumnarHeader) == 24);
+
+    struct ColumnEntry
+    {
+        std::uint64_t moffset = 0;          //!< Chunk offset from the start of the file.
+        std::uint64_t mlength = 0;          //!< Chunk size in bytes.
+        std::uint32_t mmember_offset = 0;   //!< Member offset within the record.
+        std::uint32_t mwidth = 0;           //!< Member size.
+        std::uint32_t mdictionary_size = 0;
+        std::uint8_t  mencoding = static_cast<std::uint8_t>(ColumnEncoding::PLAIN);
+        std::uint8_t  mswap = 0;            //!< Byte order unit (0: plain bytes).
+        std::uint8_t  mreserved[2] = {};
+        char          mname[COLUMNAR_MAX_NAME + 1] = {};
+
+        [[nodiscard]] std::string_view name() const noexcept { return std::string_view(mname, std::find(mname, mname + sizeof(mname), '\0') - mname); }
+        [[nodiscard]] ColumnEncoding encoding() const noexcept { return static_cast<ColumnEncoding>(mencoding); }
+    };
+    static_assert(StdLayoutTriviallyCopyableNoPadding<ColumnEntry> && sizeof(ColumnEntry) == 64);
+
+    namespace columnar
+    {
+        template <std::integral T>
+        inline constexpr T little(T v) noexcept
+        {
+            if constexpr (std::endian::native == std::endian::big && sizeof(T) > 1) return std::byteswap(v);
+            else return v;
+        }
+
+        // Converts the integer fields between native and little endian (an involution).
+        inline void fix_order(ColumnarHeader& h) noexcept
+        {
+            h.mversion      = little(h.mversion);
+            h.mcolumn_count = little(h.mcolumn_count);
+            h.mrecord_size  = little(h.mrecord_size);
+            h.mrows         = little(h.mrows);
+        }
+
+        inline void fix_order(ColumnEntry& e) noexcept
+        {
+            e.moffset          = little(e.moffset);
+            e.mlength          = little(e.mlength);
+            e.mmember_offset   = little(e.mmember_offset);
+            e.mwidth           = little(e.mwidth);
+            e.mdictionary_size = little(e.mdictionary_size);
+        }
+
+        inline size_t rle_size(std::span<const std::byte> values, size_t width) noexcept
+        {
+            const size_t rows = width ? values.size() / width : 0;
+            size_t size = 0;
+            for (size_t i = 0; i < rows;)
+            {
+                size_t j = i + 1;
+                while (j < rows && std::memcmp(&values[j * width], &values[i * width], width) == 0) ++j;
+                size += varint_size(j - i) + width;
+                i = j;
+            }
+            return size;
+        }
+
+        inline void encode_rle(std::span<const std::byte> values, size_t width, std::vector<std::byte>& out)
+        {
+            const size_t rows = width ? values.size() / width : 0;
+            std::byte run[VARINT_MAX_BYTES];
+            for (size_t i = 0; i < rows;)
+            {
+                size_t j = i + 1;
+                while (j < rows && std::memcmp(&values[j * width], &values[i * width], width) == 0) ++j;
+                out.insert(out.end(), run, run + encode_varint(j - i, run));
+                out.insert(out.end(), &values[i * width], &values[i * width] + width);
+                i = j;
+            }
+        }
+
+        // Dictionary of the distinct values in order of first appearance and the index of
+        // each row. False if there are more than COLUMNAR_MAX_DICTIONARY distinct values.
+        inline bool build_dictionary(std::span<const std::byte> values, size_t width, std::vector<std::byte>& dictionary, std::vector<std::uint16_t>& indices)
+        {
+            const size_t rows = width ? values.size() / width : 0;
+            std::unordered_map<std::string_view, std::uint32_t> ids;
+            indices.resize(rows);
+            for (size_t r = 0; r < rows; ++r)
+            {
+                const std::string_view key(reinterpret_cast<const char*>(&values[r * width]), width);
+                auto [it, inserted] = ids.try_emplace(key, static_cast<std::uint32_t>(ids.size()));
+                if (inserted)
+                {
+                    if (ids.size() > COLUMNAR_MAX_DICTIONARY) return false;
+                    dictionary.insert(dictionary.end(), &values[r * width], &values[r * width] + width);
+                }
+                indices[r] = static_cast<std::uint16_t>(it->second);
+            }
+            return true;
+        }
+
+        template <size_t WIDTH>
+        inline void fill(std::byte* out, const std::byte* value, size_t count, size_t stride) noexcept
+        {
+            for (size_t i = 0; i < count; ++i) std::memcpy(out + i * stride, value, WIDTH);
+        }
+
+        // Copies the width bytes at value to count slots stride bytes apart; common
+        // widths get a fixed size copy the compiler turns into plain stores.
+        inline void fill(std::byte* out, const std::byte* value, size_t count, size_t width, size_t stride) noexcept
+        {
+            switch (width)
+            {
+                case 1: return fill<1>(out, value, count, stride);
+                case 2: return fill<2>(out, value, count, stride);
+                case 4: return fill<4>(out, value, count, stride);
+                case 8: return fill<8>(out, value, count, stride);
+                default:
+                    for (size_t i = 0; i < count; ++i) std::memcpy(out + i * stride, value, width);
+            }
+        }
+
+        inline size_t dictionary_index_size(size_t dictionary_size) noexcept { return dictionary_size <= 256 ? 1 : 2; }
+
+        inline void encode_indices(std::span<const std::uint16_t> indices, size_t dictionary_size, std::vector<std::byte>& out)
+        {
+            if (dictionary_index_size(dictionary_size) == 1)
+                for (std::uint16_t i : indices) out.push_back(static_cast<std::byte>(i));
+            else
+                for (std::uint16_t i : indices)
+                {
+                    out.push_back(static_cast<std::byte>(i & 0xFF));
+                    out.push_back(static_cast<std::byte>(i >> 8));
+                }
+        }
+    }
+
+    // ------------------------------------------------------------
+    // ColumnarWriter
+    // ------------------------------------------------------------
+    // Accumulates records column by column and writes them in the columnar format, e.g.
+    //
+    //   ColumnarWriter w(Person::COLUMNS, Person::DATA_SIZE);
+    //   for (const Person& p : people) w.add(p);
+    //   w.save_to_file("people.pdcf");
+    class ColumnarWriter
+    {
+        private:
+            std::vector<ColumnInfo> mcolumns;
+            std::vector<ColumnEncoding> mencodings;
+            std::vector<std::vector<std::byte>> mvalues; // Native values of each column.
+            size_t mrecord_size;
+            size_t mrows = 0;
+            Endian mwire;
+
+            // Encoded chunk of column c in the wire endian; sets the entry's encoding fields.
+            std::vector<std::byte> encode(size_t c, ColumnEntry& e) const
+            {
+                const ColumnInfo& col = mcolumns[c];
+                std::vector<std::byte> values = mvalues[c];
+                if (col.mswap > 1 && col.msize % col.mswap == 0 && mwire != Endian::native() && !values.empty())
+                    byteswap_copy(values.data(), values.data(), values.size() / col.mswap, col.mswap);
+
+                ColumnEncoding enc = mencodings[c];
+                std::vector<std::byte> dictionary;
+                std::vector<std::uint16_t> indices;
+                const bool has_dictionary = (enc == ColumnEncoding::AUTO || enc == ColumnEncoding::DICTIONARY)
+                                            && columnar::build_dictionary(values, col.msize, dictionary, indices);
+                const size_t dictionary_size = col.msize ? dictionary.size() / col.msize : 0;
+                if (enc == ColumnEncoding::AUTO)
+                {
+                    const size_t plain = values.size();
+                    const size_t rle   = columnar::rle_size(values, col.msize);
+                    const size_t dict  = has_dictionary ? dictionary.size() + mrows * columnar::dictionary_index_size(dictionary_size) : plain + 1;
+                    enc = ColumnEncoding::PLAIN;
+                    if (rle < plain && rle <= dict) enc = ColumnEncoding::RLE;
+                    else if (dict < plain)          enc = ColumnEncoding::DICTIONARY;
+                }
+                else if (enc == ColumnEncoding::DICTIONARY && !has_dictionary) enc = ColumnEncoding::PLAIN;
+
+                e.mencoding = static_cast<std::uint8_t>(enc);
+                switch (enc)
+                {
+                    case ColumnEncoding::RLE:
+                    {
+                        std::vector<std::byte> out;
+                        columnar::encode_rle(values, col.msize, out);
+                        return out;
+                    }
+                    case ColumnEncoding::DICTIONARY:
+                        e.mdictionary_size = static_cast<std::uint32_t>(dictionary_size);
+                        columnar::encode_indices(indices, dictionary_size, dictionary);
+                        return dictionary;
+                    default:
+                        return values;
+                }
+            }
+
+        public:
+            ColumnarWriter(std::span<const ColumnInfo> columns, size_t record_size, Endian wire = Endian::little())
+                : mcolumns(columns.begin(), columns.end()), mencodings(columns.size(), ColumnEncoding::AUTO),
+                  mvalues(columns.size()), mrecord_size(record_size), mwire(wire) {}
+
+            [[nodiscard]] size_t rows        () const noexcept { return mrows; }
+            [[nodiscard]] size_t column_count() const noexcept { return mcolumns.size(); }
+            [[nodiscard]] size_t record_size () const noexcept { return mrecord_size; }
+
+            // Encoding of a column (AUTO by default). DICTIONARY falls back to PLAIN when the
+            // column has more than COLUMNAR_MAX_DICTIONARY distinct values.
+            void set_encoding(size_t column, ColumnEncoding encoding) noexcept
+            {
+                if (column < mencodings.size()) mencodings[column] = encoding;
+            }
+
+            // Adds one record of record_size () bytes.
+            void add_record(std::span<const std::byte> record)
+            {
+                for (size_t c = 0; c < mcolumns.size(); ++c)
+                {
+                    const ColumnInfo& col = mcolumns[c];
+                    if (col.moffset + col.msize > record.size()) continue; // Rejected by write.
+                    const std::byte* p = record.data() + col.moffset;
+                    mvalues[c].insert(mvalues[c].end(), p, p + col.msize);
+                }
+                ++mrows;
+            }
+
+            // Adds the Data level of o when T is a hierarchy level (e.g. Person), or o itself
+            // when it is the Data struct.
+            template <typename T>
+            void add(const T& o)
+            {
+                if constexpr (requires { T::DATA_SIZE; o.T::data(); })
+                    add_record(std::span<const std::byte>(reinterpret_cast<const std::byte*>(o.T::data()), T::DATA_SIZE));
+                else
+                {
+                    static_assert(std::is_trivially_copyable_v<T>, "Records must be trivially copyable.");
+                    add_record(std::as_bytes(std::span<const T>(&o, 1)));
+                }
+            }
+
+            template <typename T>
+            void add(std::span<const T> records)
+            {
+                for (const T& r : records) add(r);
+            }
+
+            void clear() noexcept
+            {
+                for (auto& v : mvalues) v.clear();
+                mrows = 0;
+            }
+
+            Result<Bool> write(BinaryBuffer& bb) const
+            {
+                if (!mwire.known()) return Result<Bool>(W("Unknown wire endian"));
+                for (const ColumnInfo& col : mcolumns)
+                {
+                    if (col.moffset + col.msize > mrecord_size || col.msize == 0) return Result<Bool>(W("Column outside of the record"));
+                    if (std::strlen(col.mname) > COLUMNAR_MAX_NAME) return Result<Bool>(W("Column name too long"));
+                }
+
+                ColumnarHeader h;
+                h.mendian       = mwire.value;
+                h.mcolumn_count = static_cast<std::uint32_t>(mcolumns.size());
+                h.mrecord_size  = static_cast<std::uint32_t>(mrecord_size);
+                h.mrows         = mrows;
+
+                std::vector<ColumnEntry> directory(mcolumns.size());
+                std::vector<std::vector<std::byte>> chunks(mcolumns.size());
+                size_t offset = sizeof(ColumnarHeader) + directory.size() * sizeof(ColumnEntry);
+                for (size_t c = 0; c < mcolumns.size(); ++c)
+                {
+                    ColumnEntry& e = directory[c];
+                    chunks[c] = encode(c, e);
+                    offset = (offset + COLUMNAR_CHUNK_ALIGNMENT - 1) / COLUMNAR_CHUNK_ALIGNMENT * COLUMNAR_CHUNK_ALIGNMENT;
+                    e.moffset        = offset;
+                    e.mlength        = chunks[c].size();
+                    e.mmember_offset = static_cast<std::uint32_t>(mcolumns[c].moffset);
+                    e.mwidth         = static_cast<std::uint32_t>(mcolumns[c].msize);
+                    e.mswap          = static_cast<std::uint8_t>(mcolumns[c].mswap);
+                    std::memcpy(e.mname, mcolumns[c].mname, std::strlen(mcolumns[c].mname));
+                    offset += chunks[c].size();
+                }
+
+                const size_t base = bb.size();
+                columnar::fix_order(h);
+                bb.write(std::as_bytes(std::span<const ColumnarHeader>(&h, 1)));
+                for (ColumnEntry e : directory)
+                {
+                    columnar::fix_order(e);
+                    bb.write(std::as_bytes(std::span<const ColumnEntry>(&e, 1)));
+                }
+                static constexpr std::byte ZEROS[COLUMNAR_CHUNK_ALIGNMENT] = {};
+                for (size_t c = 0; c < chunks.size(); ++c)
+                {
+                    bb.write(std::span<const std::byte>(ZEROS, directory[c].moffset - (bb.size() - base)));
+                    bb.write(std::span<const std::byte>(chunks[c]));
+                }
+                return bb.status();
+            }
+
+            Result<Bool> save_to_file(std::string_view filename) const
+            {
+                BinaryBuffer bb;
+                Result<Bool> r = write(bb);
+                if (!r) return r;
+                return bb.save_to_file(filename);
+            }
+    };
+
+    // ------------------------------------------------------------
+    // ColumnarReader
+    // ------------------------------------------------------------
+    // Reads a columnar file from memory, typically a MappedBinaryBuffer's data (). The
+    // bytes must outlive the reader. Columns decode to native values.
+    class ColumnarReader
+    {
+        public:
+            inline static constexpr size_t NPOS = static_cast<size_t>(-1);
+
+        private:
+            std::span<const std::byte> mfile;
+            ColumnarHeader mheader;
+            std::vector<ColumnEntry> mdirectory;
+
+            [[nodiscard]] bool needs_swap(const ColumnEntry& e) const noexcept
+            {
+                return e.mswap > 1 && e.mwidth % e.mswap == 0 && Endian(mheader.mendian) != Endian::native();
+            }
+
+            // Decodes column c into rows () values of its width placed stride bytes apart.
+            Result<Bool> decode(size_t c, std::byte* out, size_t stride) const
+            {
+                const ColumnEntry& e = mdirectory[c];
+                const std::span<const std::byte> chunk = mfile.subspan(e.moffset, e.mlength);
+                const size_t width = e.mwidth;
+                const size_t rows  = static_cast<size_t>(mheader.mrows);
+                switch (e.encoding())
+                {
+                    case ColumnEncoding::PLAIN:
+                        // Divided, not multiplied: a product of header values could wrap.
+                        if (chunk.size() % width != 0 || chunk.size() / width != rows) return Result<Bool>(W("Invalid plain column"));
+                        if (stride == width)
+                        {
+                            if (!chunk.empty()) std::memcpy(out, chunk.data(), chunk.size());
+                        }
+                        else
+                            for (size_t r = 0; r < rows; ++r) std::memcpy(out + r * stride, chunk.data() + r * width, width);
+                        break;
+                    case ColumnEncoding::RLE:
+                    {
+                        size_t r = 0, pos = 0;
+                        while (pos < chunk.size())
+                        {
+                            std::uint64_t run = 0;
+                            const size_t used = decode_varint(chunk.subspan(pos), run);
+                            if (used == 0 || run == 0 || run > rows - r || chunk.size() - pos - used < width)
+                                return Result<Bool>(W("Invalid RLE column"));
+                            pos += used;
+                            columnar::fill(out + r * stride, chunk.data() + pos, static_cast<size_t>(run), width, stride);
+                            r += static_cast<size_t>(run);
+                            pos += width;
+                        }
+                        if (r != rows) return Result<Bool>(W("Invalid RLE column"));
+                        break;
+                    }
+                    case ColumnEncoding::DICTIONARY:
+                    {
+                        const size_t count = e.mdictionary_size;
+                        const size_t index_size = columnar::dictionary_index_size(count);
+                        // count * width cannot wrap: both are bounded (the dictionary and the record size).
+                        if ((count == 0 && rows != 0) || count > COLUMNAR_MAX_DICTIONARY || chunk.size() < count * width)
+                            return Result<Bool>(W("Invalid dictionary column"));
+                        const size_t index_bytes = chunk.size() - count * width;
+                        if (index_bytes % index_size != 0 || index_bytes / index_size != rows)
+                            return Result<Bool>(W("Invalid dictionary column"));
+                        const std::byte* dictionary = chunk.data();
+                        const std::byte* indices = chunk.data() + count * width;
+                        for (size_t r = 0; r < rows; ++r)
+                        {
+                            size_t i = static_cast<size_t>(indices[r * index_size]);
+                            if (index_size == 2) i |= static_cast<size_t>(indices[r * 2 + 1]) << 8;
+                            if (i >= count) return Result<Bool>(W("Invalid dictionary index"));
+                            columnar::fill(out + r * stride, dictionary + i * width, 1, width, stride);
+                        }
+                        break;
+                    }
+                    default:
+                        return Result<Bool>(W("Unknown column encoding"));
+                }
+
+                if (needs_swap(e))
+                {
+                    if (stride == width)
+                        byteswap_copy(out, out, rows * width / e.mswap, e.mswap);
+                    else
+                        for (size_t r = 0; r < rows; ++r) byteswap_copy(out + r * stride, out + r * stride, width / e.mswap, e.mswap);
+                }
+                return Result<Bool>(Bool::T);
+            }
+
+        public:
+            ColumnarReader() = default;
+
+            // Validates the header and the directory of file. Chunks are checked as they are read.
+            Result<Bool> open(std::span<const std::byte> file)
+            {
+                mfile = {};
+                mdirectory.clear();
+                if (file.size() < sizeof(ColumnarHeader)) return Result<Bool>(W("Columnar file too small"));
+                std::memcpy(&mheader, file.data(), sizeof(ColumnarHeader));
+                columnar::fix_order(mheader);
+                if (std::memcmp(mheader.mmagic, "PDCF", 4) != 0) return Result<Bool>(W("Not a columnar file"));
+                if (mheader.mversion != 1) return Result<Bool>(W("Unsupported columnar file version"));
+                if (!Endian(mheader.mendian).known()) return Result<Bool>(W("Unknown columnar file endian"));
+                // rows * record_size must fit a size_t, so sizes derived from the header cannot wrap.
+                if (mheader.mrows > std::numeric_limits<size_t>::max() / (std::max)(mheader.mrecord_size, std::uint32_t{ 1 }))
+                    return Result<Bool>(W("Too many rows"));
+                if (mheader.mcolumn_count > (file.size() - sizeof(ColumnarHeader)) / sizeof(ColumnEntry))
+                    return Result<Bool>(W("Truncated column directory"));
+
+                mdirectory.resize(mheader.mcolumn_count);
+                std::memcpy(mdirectory.data(), file.data() + sizeof(ColumnarHeader), mdirectory.size() * sizeof(ColumnEntry));
+                for (ColumnEntry& e : mdirectory)
+                {
+                    columnar::fix_order(e);
+                    if (e.moffset > file.size() || e.mlength > file.size() - e.moffset)
+                        return Result<Bool>(W("Column chunk outside of the file"));
+                    if (e.mwidth == 0 || static_cast<std::uint64_t>(e.mmember_offset) + e.mwidth > mheader.mrecord_size)
+                        return Result<Bool>(W("Column outside of the record"));
+                }
+                mfile = file;
+                return Result<Bool>(Bool::T);
+            }
+
+            [[nodiscard]] size_t rows        () const noexcept { return static_cast<size_t>(mheader.mrows); }
+            [[nodiscard]] size_t column_count() const noexcept { return mdirectory.size(); }
+            [[nodiscard]] size_t record_size () const noexcept { return mheader.mrecord_size; }
+            [[nodiscard]] Endian endian      () const noexcept { return Endian(mheader.mendian); }
+
+            [[nodiscard]] const ColumnEntry& column(size_t index) const noexcept { return mdirectory[index]; }
+
+            // Index of the column named name, or NPOS.
+            [[nodiscard]] size_t find(std::string_view name) const noexcept
+            {
+                for (size_t c = 0; c < mdirectory.size(); ++c)
+                    if (mdirectory[c].name() == name) return c;
+                return NPOS;
+            }
+
+            // Decodes column index into out (rows () values).
+            template <typename V>
+                requires std::is_trivially_copyable_v<V>
+            Result<Bool> read_column(size_t index, std::span<V> out) const
+            {
+                if (index >= mdirectory.size()) return Result<Bool>(W("Invalid column index"));
+                if (sizeof(V) != mdirectory[index].mwidth) return Result<Bool>(W("Column width mismatch"));
+                if (out.size() < rows()) return Result<Bool>(W("Output too small"));
+                return decode(index, reinterpret_cast<std::byte*>(out.data()), sizeof(V));
+            }
+
+            template <typename V>
+                requires std::is_trivially_copyable_v<V>
+            Result<Bool> read_column(std::string_view name, std::span<V> out) const
+            {
+                const size_t index = find(name);
+                if (index == NPOS) return Result<Bool>(W("Column not found"));
+                return read_column(index, out);
+            }
+
+            // Zero copy view of a PLAIN column already in native order, e.g. for a WireSpan;
+            // empty if the column has to be decoded (use read_column).
+            template <typename V>
+                requires std::is_trivially_copyable_v<V>
+            [[nodiscard]] std::span<const V> view_column(size_t index) const noexcept
+            {
+                if (index >= mdirectory.size()) return {};
+                const ColumnEntry& e = mdirectory[index];
+                if (e.encoding() != ColumnEncoding::PLAIN || sizeof(V) != e.mwidth || e.mlength % sizeof(V) != 0 || e.mlength / sizeof(V) != rows() || needs_swap(e)) return {};
+                const std::byte* p = mfile.data() + e.moffset;
+                if (reinterpret_cast<std::uintptr_t>(p) % alignof(V) != 0) return {};
+                return std::span<const V>(reinterpret_cast<const V*>(p), rows());
+            }
+
+            // Rebuilds rows () records of record_size () bytes from all columns. Bytes no
+            // column covers keep their value, so initialize out first (e.g. with NULL_DATA).
+            Result<Bool> read_records(std::span<std::byte> out) const
+            {
+                if (out.size() < rows() * record_size()) return Result<Bool>(W("Output too small"));
+                for (size_t c = 0; c < mdirectory.size(); ++c)
+                {
+                    Result<Bool> r = decode(c, out.data() + mdirectory[c].mmember_offset, record_size());
+                    if (!r) return r;
+                }
+                return Result<Bool>(Bool::T);
+            }
+
+            template <typename T>
+                requires std::is_trivially_copyable_v<T>
+            Result<Bool> read_records(std::span<T> out) const
+            {
+                if (sizeof(T) != record_size()) return Result<Bool>(W("Record size mismatch"));
+                return read_records(std::as_writable_bytes(out));
+            }
+    };
+}
+
+#endif // COLUMNAR_HPP
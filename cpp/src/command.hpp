@@ -21,6 +21,8 @@
 #include "clone_util.hpp"
 #include "equal.hpp"
 #include "binary_buffer.hpp"
+#include "arena.hpp"
+#include "class_info_table.hpp"
 
 
 namespace pensar_digital
@@ -89,6 +91,11 @@ namespace pensar_digital
             inline static constexpr size_t DATA_SIZE = sizeof(mdata);
             inline static constexpr size_t      SIZE = Object::SIZE + DATA_SIZE + sizeof(ClassInfo) + G::SIZE;
 
+            /// \brief Members of Data, e.g. the columns of a columnar file (see columnar.hpp).
+            inline static constexpr auto COLUMNS = DATA_COLUMNS(Data, mok);
+
+            using Serializer = pd::Serializer<Object, Command>;
+
             protected:
             
             inline static G mgenerator = G();
@@ -135,26 +142,19 @@ namespace pensar_digital
 
             virtual BinaryBuffer& write(BinaryBuffer& bb) const noexcept
             {
-                Object::write(bb);
-                bb.write (INFO.bytes () );
-                bb.write (std::span<const std::byte>((const std::byte*)&mdata, DATA_SIZE));
-                return bb;
+                return Serializer::write(*this, bb);
             }
             virtual BinaryBuffer& read(BinaryBuffer& bb) noexcept
             {
-               // Read Object part
-                Object::read(bb);
+                return Serializer::read(*this, bb);
+            }
 
-                // Read ClassInfo first and verify
-                ClassInfo info;
-                bb.read(std::span<std::byte>((std::byte*)&info, sizeof(ClassInfo)));
-                if (info != INFO)
-                {
-                    LOG(W("ClassInfo mismatch in Command::read"));
-                    return bb;
-                }
-                // Read data bytes - use explicit span to avoid virtual call to derived class
-                return bb.read(std::span<std::byte>((std::byte*)&mdata, DATA_SIZE));
+            /// \brief Reads the command, creating any child commands in arena instead of the heap.
+            /// Commands without children read as usual.
+            virtual BinaryBuffer& read(BinaryBuffer& bb, MonotonicArena& arena) noexcept
+            {
+                (void)arena;
+                return read(bb);
             }
             protected:
 
@@ -184,21 +184,96 @@ namespace pensar_digital
         class CommandRegistry 
         {
             using Creator = std::function<Command*()>;
-            inline static std::unordered_map<S, Creator> registry;
+            using ArenaCreator = Command* (*)(MonotonicArena&);
+            struct Entry
+            {
+                Creator      mcreate;       //!< Heap allocation, owned by the caller.
+                ArenaCreator marena_create; //!< Placement in an arena, destroyed by its release ().
+            };
+            inline static std::unordered_map<S, Entry> registry;   //!< By full class name, so any version resolves.
+            inline static std::vector<const Entry*> registry_by_id; //!< By ClassId of the registered INFO.
+
+            /// \brief The entry for serialized ClassInfo bytes. The registered version is an interned
+            /// id lookup; any other version falls back to the name.
+            static const Entry* find(std::span<const std::byte> info_bytes)
+            {
+                if (std::optional<ClassId> id = ClassInfoTable::find(info_bytes); id && *id < registry_by_id.size() && registry_by_id[*id] != nullptr)
+                    return registry_by_id[*id];
+                if (info_bytes.size() != sizeof(ClassInfo)) return nullptr;
+                ClassInfo info;
+                std::memcpy(info.wbytes().data(), info_bytes.data(), sizeof(ClassInfo));
+                auto it = registry.find(info.full_class_name());
+                return it == registry.end() ? nullptr : &it->second; // Map nodes are stable.
+            }
+
+            /// \brief Reads a command type tag and finds its registry entry.
+            /// In compact types mode the lookup runs once per type and stream, later tags are a table lookup.
+            static const Entry* read_entry(BinaryBuffer& bb)
+            {
+                if (!bb.compact_types())
+                {
+                    if (!bb.ensure(sizeof(ClassInfo))) return nullptr;
+                    const Entry* entry = find(bb.view_unchecked(sizeof(ClassInfo)));
+                    if (entry == nullptr) bb.fail(BufferError::INVALID_DATA);
+                    return entry;
+                }
+                TypeTable::Entry* e = bb.read_type(sizeof(ClassInfo));
+                if (e == nullptr) return nullptr;
+                if (e->mresolved == nullptr)
+                {
+                    const Entry* entry = find(e->mdefinition);
+                    if (entry == nullptr)
+                    {
+                        bb.fail(BufferError::INVALID_DATA);
+                        return nullptr;
+                    }
+                    e->mresolved = entry;
+                }
+                return static_cast<const Entry*>(e->mresolved);
+            }
             
             public:
             template<typename T>
             static void register_type() 
             {
-                registry[T::INFO.full_class_name()] = []() { return new T(); };
+                const ClassId id = class_id<T>();
+                Entry& entry = registry[ClassInfoTable::get(id).mfull_name];
+                entry = { []() -> Command* { return new T(); },
+                          [](MonotonicArena& arena) -> Command* { return arena.create<T>(); } };
+                if (registry_by_id.size() <= id) registry_by_id.resize(id + 1, nullptr);
+                registry_by_id[id] = &entry;
             }
             
             static Command* create(const ClassInfo& info) 
             {
+                const Entry* entry = find(info.bytes());
+                return entry == nullptr ? nullptr : entry->mcreate();
+            }
 
-                auto it = registry.find(info.full_class_name());
-                if (it != registry.end()) return it->second();
-                return nullptr;
+            /// \brief Reads a command type tag (see ClassInfo::write_tag) and creates a command of that type.
+            /// Returns nullptr with the buffer error set for an unknown type.
+            static Command* read_create(BinaryBuffer& bb)
+            {
+                const Entry* e = read_entry(bb);
+                return e == nullptr ? nullptr : e->mcreate();
+            }
+
+            /// \brief As read_create (bb), but the command is placement-constructed in arena: no heap
+            /// allocation and no std::function call per command. The caller must not delete it.
+            static Command* read_create(BinaryBuffer& bb, MonotonicArena& arena)
+            {
+                const Entry* e = read_entry(bb);
+                return e == nullptr ? nullptr : e->marena_create(arena);
+            }
+
+            /// \brief Reads a whole command, tag included, into arena. Its children go to the arena too.
+            /// Returns nullptr if the buffer failed; objects created so far stay in the arena until release ().
+            static Command* read_command(BinaryBuffer& bb, MonotonicArena& arena)
+            {
+                Command* cmd = read_create(bb, arena);
+                if (cmd == nullptr) return nullptr;
+                cmd->read(bb, arena);
+                return bb.ok() ? cmd : nullptr;
             }
         };
 
@@ -218,19 +293,17 @@ namespace pensar_digital
 
                 virtual BinaryBuffer& write(BinaryBuffer& bb) const noexcept override
                 {
-                    // Write NullCommand's ClassInfo FIRST for type identification
-                    bb.write(INFO.bytes());
-                    // Then write base class data
-                    Command::write(bb);
-                    return bb;
+                    // Write NullCommand's type tag FIRST for type identification
+                    INFO.write_tag(bb);
+                    // Then the base class levels
+                    return Command::Serializer::write(*this, bb);
                 }
 
                 virtual BinaryBuffer& read(BinaryBuffer& bb) noexcept override
                 {
                     // ClassInfo was already read by caller for type dispatch
-                    // Just read the base class data
-                    Command::read(bb);
-                    return bb;
+                    // Just read the base class levels
+                    return Command::Serializer::read(*this, bb);
                 }
                  
             private:
@@ -286,6 +359,7 @@ namespace pensar_digital
 
             static_assert(StdLayoutTriviallyCopyableNoPadding<Data>, "Data must be a standard layout and trivially copyable type");
             Data mdata; //!< Member variable mdata contains the object data.
+            bool mowns = true; //!< False when the commands live in an arena (see read (bb, arena)). Not serialized.
 
             public:
             inline const static Data NULL_DATA = { {}, 0 };
@@ -319,18 +393,50 @@ namespace pensar_digital
 
             ~CompositeCommand()
             {
-                mdata.free_commands();
+                if (mowns) mdata.free_commands();
             }
         
             private:
             inline static Factory mfactory = { 3, 10, NULL_ID };
 
+            // Drops the current commands before a read replaces them.
+            void clear_commands() noexcept
+            {
+                if (mowns) mdata.free_commands();
+                mdata.mindex = 0;
+            }
+
+            // Reads the command count and the commands, created in arena if not null.
+            BinaryBuffer& read_commands(BinaryBuffer& bb, MonotonicArena* arena) noexcept
+            {
+                size_t count = 0;
+                if (!bb.read(count).ok()) return bb;
+                if (count > MAX_COMMANDS)
+                {
+                    bb.fail(BufferError::INVALID_DATA);
+                    return bb;
+                }
+                for (size_t i = 0; i < count; ++i)
+                {
+                    // Read the type tag and create the correct type
+                    Command* cmd = arena == nullptr ? CommandRegistry::read_create(bb) : CommandRegistry::read_create(bb, *arena);
+                    if (cmd == nullptr)
+                        return bb;  // Can't continue - unknown type or truncated buffer
+                    mdata.mcommands[mdata.mindex++] = cmd; // Owned (or in the arena) even if its read fails.
+                    if (!(arena == nullptr ? cmd->read(bb) : cmd->read(bb, *arena)).ok()) return bb;
+                }
+                return bb;
+            }
+
             public:
 
             // Implements initialize method from Initializable concept.
             virtual bool initialize (const Id id) noexcept
             {
-
+                // A pooled composite is reused without being destroyed: drop the previous commands,
+                // which may have lived in an arena.
+                clear_commands();
+                mowns = true;
                 this->set_id (id == NULL_ID ? this->mgenerator.get_id() : id);
 
                 return true;
@@ -358,9 +464,16 @@ namespace pensar_digital
             /// <summary>
             /// Adds the command to the composite.
             /// The CompositeCommand will take ownership of the command.
+            /// Throws while the commands live in an arena (see read (bb, arena)), which owns
+            /// them instead: the caller keeps ownership of cmd then.
             /// </summary>
             /// <param name="cmd">Pointer to the command to be added.</param>
-            void add (Command* cmd) { mdata.add (cmd); }
+            void add (Command* cmd)
+            {
+                if (!mowns)
+                    log_and_throw("CompositeCommand::add(Command* cmd) : Cannot add to commands read into an arena.");
+                mdata.add (cmd);
+            }
 
             Command::Ptr clone () const noexcept override
             {
@@ -394,10 +507,10 @@ namespace pensar_digital
 
             virtual BinaryBuffer& write(BinaryBuffer& bb) const noexcept override
             {
-                // Write CompositeCommand's ClassInfo FIRST for type identification
-                bb.write(INFO.bytes());
-                // Then write base class data
-                Command::write(bb);
+                // Write CompositeCommand's type tag FIRST for type identification
+                INFO.write_tag(bb);
+                // Then the base class levels
+                Command::Serializer::write(*this, bb);
                 // Write command count
                 bb.write(mdata.mindex);
                 // Write each command polymorphically
@@ -411,30 +524,28 @@ namespace pensar_digital
             virtual BinaryBuffer& read(BinaryBuffer& bb) noexcept override
             {
                 // ClassInfo was already read by caller for type dispatch (or verify it here)
-                Command::read(bb);
-                
-                // Read command count
-                bb.read(mdata.mindex);
-                
-                // Read each command - need a factory/registry
-                for (size_t i = 0; i < mdata.mindex; ++i)
-                {
-                    // Read ClassInfo to determine type
-                    ClassInfo cmd_info;
-                    bb.read(std::span<std::byte>((std::byte*)&cmd_info, sizeof(ClassInfo)));
-                    
-                    // Create correct type based on info
-                    Command* cmd = CommandRegistry::create(cmd_info);  // Factory pattern
-                    if (cmd == nullptr)
-                    {
-                        LOG(W("Unknown command type in CompositeCommand::read: ") + cmd_info.full_class_name());
-                        return bb;  // Can't continue - unknown type
-                    }
-                    cmd->read(bb);  // Finish reading rest of command data
-                    mdata.mcommands[i] = cmd;
-                }
-                return bb;
-            }        
+                clear_commands();
+                mowns = true;
+                if (!Command::Serializer::read(*this, bb).ok()) return bb;
+                return read_commands(bb, nullptr);
+            }
+
+            /// \brief Reads the composite with its commands placement-constructed in arena, nested
+            /// composites included. The arena must outlive this object: the commands are not deleted
+            /// here but destroyed by arena.release ().
+            virtual BinaryBuffer& read(BinaryBuffer& bb, MonotonicArena& arena) noexcept override
+            {
+                clear_commands();
+                mowns = false;
+                if (!Command::Serializer::read(*this, bb).ok()) return bb;
+                return read_commands(bb, &arena);
+            }
+
+            private:
+                inline static const bool _registered = []() {
+                    CommandRegistry::register_type<CompositeCommand>();
+                    return true;
+                }();
         };  //  class CompositeCommand.
     }
 }
@@ -0,0 +1,342 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#ifndef COMPRESSION_HPP
+#define COMPRESSION_HPP
+
+#include <bit>
+#include <span>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+#include "code_util.hpp" // Result
+
+namespace pensar_digital::cpplib
+{
+    // ------------------------------------------------------------
+    // Block compression
+    // ------------------------------------------------------------
+    // Serialized objects are redundant: class names repeat in every record and fixed
+    // size strings are mostly zeros. Two LZ77 codecs share one block format and one
+    // decoder, which runs at memory speed:
+    //
+    //   FAST  greedy matching through a single hash probe, for streams and IPC.
+    //   HIGH  hash chains and lazy matching: slower to compress, smaller output, same
+    //         decoding speed; for snapshots written once and read many times.
+    //
+    // The encoded sequences follow the LZ4 block layout (token, literals, 16 bit offset,
+    // match length). Blocks are independent, so they compress and decompress in parallel
+    // (see frame.hpp).
+
+    enum class Codec : std::uint8_t { NONE = 0, FAST = 1, HIGH = 2 };
+
+    inline constexpr bool valid_codec(std::uint8_t c) noexcept { return c <= static_cast<std::uint8_t>(Codec::HIGH); }
+
+    namespace lz
+    {
+        inline constexpr size_t MIN_MATCH     = 4;
+        inline constexpr size_t LAST_LITERALS = 5;     // A block ends with at least 5 literals ...
+        inline constexpr size_t MF_LIMIT      = 12;    // ... and no match starts in its last 12 bytes.
+        inline constexpr size_t MAX_OFFSET    = 65535;
+        inline constexpr int    FAST_HASH_LOG = 14;
+        inline constexpr int    HIGH_HASH_LOG = 16;
+        inline constexpr int    HIGH_DEPTH    = 64;    // Chain links searched per position ...
+        inline constexpr size_t HIGH_NICE     = 256;   // ... unless a match this long is found.
+
+        // Largest encoding of n bytes.
+        inline constexpr size_t bound(size_t n) noexcept { return n + n / 255 + 16; }
+
+        inline std::uint32_t read32(const std::byte* p) noexcept
+        {
+            std::uint32_t v;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        template <int LOG>
+        inline std::uint32_t hash(const std::byte* p) noexcept { return (read32(p) * 2654435761u) >> (32 - LOG); }
+
+        // Length of the common prefix of a and b, b stopping at limit.
+        inline size_t match_length(const std::byte* a, const std::byte* b, const std::byte* limit) noexcept
+        {
+            const std::byte* const start = b;
+            while (b + 8 <= limit)
+            {
+                std::uint64_t x, y;
+                std::memcpy(&x, a, 8);
+                std::memcpy(&y, b, 8);
+                if (const std::uint64_t d = x ^ y)
+                    return static_cast<size_t>(b - start) +
+                        (std::endian::native == std::endian::little ? std::countr_zero(d) : std::countl_zero(d)) / 8;
+                a += 8;
+                b += 8;
+            }
+            while (b < limit && *a == *b) { ++a; ++b; }
+            return static_cast<size_t>(b - start);
+        }
+
+        inline std::byte* write_length(std::byte* op, size_t len) noexcept
+        {
+            for (; len >= 255; len -= 255) *op++ = std::byte{ 255 };
+            *op++ = static_cast<std::byte>(len);
+            return op;
+        }
+
+        // One sequence: literals, then a match (match_len 0 for the last sequence).
+        inline std::byte* emit(std::byte* op, const std::byte* literals, size_t lit_len, size_t offset, size_t match_len) noexcept
+        {
+            std::byte* const token = op++;
+            unsigned t = lit_len >= 15 ? 15u << 4 : static_cast<unsigned>(lit_len) << 4;
+            if (lit_len >= 15) op = write_length(op, lit_len - 15);
+            std::memcpy(op, literals, lit_len);
+            op += lit_len;
+            if (match_len > 0)
+            {
+                *op++ = static_cast<std::byte>(offset & 0xFF);
+                *op++ = static_cast<std::byte>(offset >> 8);
+                const size_t ml = match_len - MIN_MATCH;
+                t |= ml >= 15 ? 15u : static_cast<unsigned>(ml);
+                if (ml >= 15) op = write_length(op, ml - 15);
+            }
+            *token = static_cast<std::byte>(t);
+            return op;
+        }
+
+        // Encodes src into dst (at least bound(src.size()) bytes); returns the encoded size.
+        inline size_t compress_fast(std::span<const std::byte> src, std::span<std::byte> dst)
+        {
+            const std::byte* const base = src.data();
+            const std::byte* const end = base + src.size();
+            const std::byte* anchor = base;
+            std::byte* op = dst.data();
+            if (src.size() > MF_LIMIT)
+            {
+                const std::byte* const mflimit = end - MF_LIMIT;
+                const std::byte* const match_limit = end - LAST_LITERALS;
+                // Positions relative to base; stale or empty entries fail the checks below.
+                std::unique_ptr<std::uint32_t[]> table(new std::uint32_t[size_t{ 1 } << FAST_HASH_LOG]());
+                const std::byte* ip = base + 1;
+                while (ip <= mflimit)
+                {
+                    // Find a match, stepping faster through data that does not compress.
+                    const std::byte* ref = nullptr;
+                    for (unsigned misses = 1 << 6; ; )
+                    {
+                        const std::uint32_t h = hash<FAST_HASH_LOG>(ip);
+                        ref = base + table[h];
+                        table[h] = static_cast<std::uint32_t>(ip - base);
+                        if (ref < ip && static_cast<size_t>(ip - ref) <= MAX_OFFSET && read32(ref) == read32(ip)) break;
+                        ip += misses++ >> 6;
+                        if (ip > mflimit) goto last;
+                    }
+                    while (ip > anchor && ref > base && ip[-1] == ref[-1]) { --ip; --ref; }
+                    const size_t len = MIN_MATCH + match_length(ref + MIN_MATCH, ip + MIN_MATCH, match_limit);
+                    op = emit(op, anchor, static_cast<size_t>(ip - anchor), static_cast<size_t>(ip - ref), len);
+                    ip += len;
+                    anchor = ip;
+                    if (ip <= mflimit) table[hash<FAST_HASH_LOG>(ip - 2)] = static_cast<std::uint32_t>(ip - 2 - base);
+                }
+            }
+        last:
+            op = emit(op, anchor, static_cast<size_t>(end - anchor), 0, 0);
+            return static_cast<size_t>(op - dst.data());
+        }
+
+        // As compress_fast, searching up to HIGH_DEPTH earlier positions with the same hash
+        // and deferring a match when the next position has a longer one.
+        inline size_t compress_high(std::span<const std::byte> src, std::span<std::byte> dst)
+        {
+            const std::byte* const base = src.data();
+            const std::byte* const end = base + src.size();
+            const std::byte* anchor = base;
+            std::byte* op = dst.data();
+            if (src.size() > MF_LIMIT)
+            {
+                const std::byte* const mflimit = end - MF_LIMIT;
+                const std::byte* const match_limit = end - LAST_LITERALS;
+                std::unique_ptr<std::uint32_t[]> head(new std::uint32_t[size_t{ 1 } << HIGH_HASH_LOG]()); // Position + 1, 0 if none.
+                std::unique_ptr<std::uint16_t[]> chain(new std::uint16_t[MAX_OFFSET + 1]());            // Distance to the previous one.
+                size_t inserted = 0;
+
+                struct Match { size_t len = 0; const std::byte* ref = nullptr; };
+                auto find = [&](const std::byte* ip)
+                {
+                    const size_t pos = static_cast<size_t>(ip - base);
+                    for (; inserted <= pos; ++inserted)
+                    {
+                        const std::uint32_t h = hash<HIGH_HASH_LOG>(base + inserted);
+                        const size_t delta = head[h] ? inserted + 1 - head[h] : 0;
+                        chain[inserted & MAX_OFFSET] = static_cast<std::uint16_t>(delta <= MAX_OFFSET ? delta : 0);
+                        head[h] = static_cast<std::uint32_t>(inserted + 1);
+                    }
+                    Match best;
+                    const std::uint32_t first = chain[pos & MAX_OFFSET];
+                    const std::uint32_t v = read32(ip);
+                    size_t cand = pos - first;
+                    for (int depth = HIGH_DEPTH; depth > 0 && first != 0 && pos - cand <= MAX_OFFSET; --depth)
+                    {
+                        const std::byte* ref = base + cand;
+                        // Only a candidate matching one byte past the best can beat it.
+                        if ((best.len == 0 || ref[best.len] == ip[best.len]) && read32(ref) == v)
+                        {
+                            const size_t len = MIN_MATCH + match_length(ref + MIN_MATCH, ip + MIN_MATCH, match_limit);
+                            if (len > best.len) { best.len = len; best.ref = ref; }
+                            if (len >= HIGH_NICE) break;
+                        }
+                        const std::uint16_t delta = chain[cand & MAX_OFFSET];
+                        if (delta == 0 || delta > cand) break;
+                        cand -= delta;
+                    }
+                    return best;
+                };
+
+                for (const std::byte* ip = base; ip <= mflimit; )
+                {
+                    Match m = find(ip);
+                    if (m.len == 0) { ++ip; continue; }
+                    while (ip + 1 <= mflimit)
+                    {
+                        const Match next = find(ip + 1);
+                        if (next.len <= m.len) break;
+                        ++ip;
+                        m = next;
+                    }
+                    op = emit(op, anchor, static_cast<size_t>(ip - anchor), static_cast<size_t>(ip - m.ref), m.len);
+                    ip += m.len;
+                    anchor = ip;
+                }
+            }
+            op = emit(op, anchor, static_cast<size_t>(end - anchor), 0, 0);
+            return static_cast<size_t>(op - dst.data());
+        }
+
+        // Decodes src into dst; the decoded size, or an error if src is malformed or
+        // decodes to more than dst.size() bytes.
+        inline Result<size_t> decompress(std::span<const std::byte> src, std::span<std::byte> dst) noexcept
+        {
+            const std::byte* ip = src.data();
+            const std::byte* const iend = ip + src.size();
+            std::byte* op = dst.data();
+            std::byte* const oend = op + dst.size();
+            auto read_length = [&](size_t& len) noexcept
+            {
+                for (std::uint8_t b = 255; b == 255; len += b)
+                {
+                    if (ip == iend) return false;
+                    b = static_cast<std::uint8_t>(*ip++);
+                }
+                return true;
+            };
+            while (true)
+            {
+                if (ip == iend) return Result<size_t>(W("Truncated compressed block"), 0);
+                const unsigned token = static_cast<std::uint8_t>(*ip++);
+                size_t lit = token >> 4;
+                if (lit == 15 && !read_length(lit)) return Result<size_t>(W("Truncated compressed block"), 0);
+                if (lit > static_cast<size_t>(iend - ip) || lit > static_cast<size_t>(oend - op)) return Result<size_t>(W("Corrupt compressed block"), 0);
+                if (lit <= 16 && iend - ip >= 16 && oend - op >= 16)
+                    std::memcpy(op, ip, 16);
+                else
+                    std::memcpy(op, ip, lit);
+                op += lit;
+                ip += lit;
+                if (ip == iend) break; // The last sequence has no match.
+
+                if (iend - ip < 2) return Result<size_t>(W("Truncated compressed block"), 0);
+                const size_t offset = static_cast<size_t>(ip[0]) | static_cast<size_t>(ip[1]) << 8;
+                ip += 2;
+                size_t ml = token & 15;
+                if (ml == 15 && !read_length(ml)) return Result<size_t>(W("Truncated compressed block"), 0);
+                ml += MIN_MATCH;
+                if (offset == 0 || offset > static_cast<size_t>(op - dst.data()) || ml > static_cast<size_t>(oend - op))
+                    return Result<size_t>(W("Corrupt compressed block"), 0);
+
+                const std::byte* m = op - offset;
+                if (static_cast<size_t>(oend - op) >= ml + 8)
+                {
+                    // Eight bytes at a time, each copy reading only bytes already written: the
+                    // output repeats with period offset, so with a short offset the copies
+                    // start once a multiple of it of at least 8 bytes is written.
+                    size_t d = offset, i = 0;
+                    while (d < 8) d += offset;
+                    if (d != offset) for (; i < d && i < ml; ++i) op[i] = m[i];
+                    for (; i < ml; i += 8) std::memcpy(op + i, op + i - d, 8);
+                }
+                else
+                {
+                    for (size_t i = 0; i < ml; ++i) op[i] = m[i];
+                }
+                op += ml;
+            }
+            return Result<size_t>(static_cast<size_t>(op - dst.data()));
+        }
+    }
+
+    // ------------------------------------------------------------
+    // Compressed block: codec (1 byte), decoded size (4 bytes, little endian), data.
+    // ------------------------------------------------------------
+    // A block the codec does not shrink is stored as is, with codec NONE.
+
+    inline constexpr size_t BLOCK_HEADER_SIZE = 5;
+
+    // Largest compressed block for n bytes.
+    inline constexpr size_t compress_bound(size_t n) noexcept { return BLOCK_HEADER_SIZE + lz::bound(n); }
+
+    // Compresses src (at most 4 GiB) into dst (at least compress_bound(src.size()) bytes);
+    // returns the size of the compressed block.
+    inline size_t compress_block(Codec codec, std::span<const std::byte> src, std::span<std::byte> dst)
+    {
+        const std::span<std::byte> body = dst.subspan(BLOCK_HEADER_SIZE);
+        size_t n = src.size();
+        if (src.empty())               codec = Codec::NONE;
+        else if (codec == Codec::FAST) n = lz::compress_fast(src, body);
+        else if (codec == Codec::HIGH) n = lz::compress_high(src, body);
+        if (n >= src.size() && !src.empty())
+        {
+            codec = Codec::NONE;
+            n = src.size();
+            std::memcpy(body.data(), src.data(), n);
+        }
+        dst[0] = static_cast<std::byte>(codec);
+        for (size_t i = 0; i < 4; ++i) dst[1 + i] = static_cast<std::byte>(src.size() >> (8 * i));
+        return BLOCK_HEADER_SIZE + n;
+    }
+
+    // Largest decoded size of a well-formed block of n bytes: no encoded byte expands to
+    // more than 255 (a match length byte), so a larger declared size is corrupt or crafted.
+    inline constexpr size_t max_block_raw_size(size_t n) noexcept { return n * 255; }
+
+    // Decoded size of a compressed block, 0 if it has no valid header.
+    inline size_t block_raw_size(std::span<const std::byte> block) noexcept
+    {
+        if (block.size() < BLOCK_HEADER_SIZE || !valid_codec(static_cast<std::uint8_t>(block[0]))) return 0;
+        size_t n = 0;
+        for (size_t i = 0; i < 4; ++i) n |= static_cast<size_t>(block[1 + i]) << (8 * i);
+        return n;
+    }
+
+    // Decompresses a block into dst; the decoded size, or an error if the block is
+    // corrupt or larger than dst.
+    inline Result<size_t> decompress_block(std::span<const std::byte> block, std::span<std::byte> dst) noexcept
+    {
+        const size_t raw = block_raw_size(block);
+        if (block.size() < BLOCK_HEADER_SIZE || !valid_codec(static_cast<std::uint8_t>(block[0])))
+            return Result<size_t>(W("Invalid compressed block"), 0);
+        if (raw > dst.size()) return Result<size_t>(W("Compressed block larger than the destination"), 0);
+        const std::span<const std::byte> body = block.subspan(BLOCK_HEADER_SIZE);
+        if (static_cast<Codec>(block[0]) == Codec::NONE)
+        {
+            if (body.size() != raw) return Result<size_t>(W("Corrupt stored block"), 0);
+            if (raw > 0) std::memcpy(dst.data(), body.data(), raw);
+            return Result<size_t>(raw);
+        }
+        Result<size_t> r = lz::decompress(body, dst.first(raw));
+        if (r && r.mresult != raw) return Result<size_t>(W("Compressed block size mismatch"), 0);
+        return r;
+    }
+}
+
+#endif // COMPRESSION_HPP
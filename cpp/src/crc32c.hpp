@@ -0,0 +1,156 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#ifndef CRC32C_HPP
+#define CRC32C_HPP
+
+#include <span>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring> // std::memcpy
+
+#include "byte_order.hpp" // PD_TARGET, PD_BYTESWAP_X86
+
+#if defined(__ARM_FEATURE_CRC32)
+    #include <arm_acle.h>
+    #define PD_CRC32C_ARM 1
+#elif defined(PD_BYTESWAP_X86) && (defined(__x86_64__) || defined(_M_X64))
+    #define PD_CRC32C_X86 1
+#endif
+
+namespace pensar_digital::cpplib
+{
+    // ------------------------------------------------------------
+    // CRC32C (Castagnoli)
+    // ------------------------------------------------------------
+    // The checksum of iSCSI, ext4 and most storage formats. x86 CPUs since SSE4.2 and
+    // ARMv8 CPUs with the CRC extension compute it in hardware, 8 bytes per instruction;
+    // the kernel is picked once at run time, with a slicing-by-8 table fallback.
+    //
+    // Checksums chain: crc32c(b, crc32c(a)) == crc32c(a followed by b), so a stream can
+    // be checked block by block as it is read.
+
+    namespace crc32c_detail
+    {
+        inline constexpr std::uint32_t POLY = 0x82F63B78; // Reflected Castagnoli polynomial.
+
+        inline constexpr std::array<std::array<std::uint32_t, 256>, 8> make_tables() noexcept
+        {
+            std::array<std::array<std::uint32_t, 256>, 8> t{};
+            for (std::uint32_t i = 0; i < 256; ++i)
+            {
+                std::uint32_t c = i;
+                for (int k = 0; k < 8; ++k) c = (c >> 1) ^ (POLY & (0u - (c & 1)));
+                t[0][i] = c;
+            }
+            for (size_t i = 0; i < 256; ++i)
+                for (size_t s = 1; s < 8; ++s)
+                    t[s][i] = (t[s - 1][i] >> 8) ^ t[0][t[s - 1][i] & 0xFF];
+            return t;
+        }
+
+        inline constexpr auto TABLES = make_tables();
+
+        inline std::uint32_t update_scalar(std::uint32_t crc, const std::byte* p, size_t n) noexcept
+        {
+            for (; n >= 8; n -= 8, p += 8)
+            {
+                std::uint64_t v;
+                std::memcpy(&v, p, 8);
+                if constexpr (std::endian::native == std::endian::big) v = std::byteswap(v);
+                v ^= crc;
+                crc = TABLES[7][ v        & 0xFF] ^ TABLES[6][(v >>  8) & 0xFF] ^
+                      TABLES[5][(v >> 16) & 0xFF] ^ TABLES[4][(v >> 24) & 0xFF] ^
+                      TABLES[3][(v >> 32) & 0xFF] ^ TABLES[2][(v >> 40) & 0xFF] ^
+                      TABLES[1][(v >> 48) & 0xFF] ^ TABLES[0][ v >> 56        ];
+            }
+            for (; n > 0; --n, ++p)
+                crc = (crc >> 8) ^ TABLES[0][(crc ^ static_cast<std::uint8_t>(*p)) & 0xFF];
+            return crc;
+        }
+
+#ifdef PD_CRC32C_X86
+        PD_TARGET("sse4.2") inline std::uint32_t update_sse42(std::uint32_t crc, const std::byte* p, size_t n) noexcept
+        {
+            std::uint64_t c = crc;
+            for (; n >= 8; n -= 8, p += 8)
+            {
+                std::uint64_t v;
+                std::memcpy(&v, p, 8);
+                c = _mm_crc32_u64(c, v);
+            }
+            std::uint32_t c32 = static_cast<std::uint32_t>(c);
+            for (; n > 0; --n, ++p) c32 = _mm_crc32_u8(c32, static_cast<std::uint8_t>(*p));
+            return c32;
+        }
+
+        inline bool has_sse42() noexcept
+        {
+            static const bool supported = []() noexcept
+            {
+    #if defined(_MSC_VER) && !defined(__clang__)
+                int r[4];
+                __cpuid(r, 1);
+                return (r[2] & (1 << 20)) != 0;
+    #else
+                __builtin_cpu_init();
+                return __builtin_cpu_supports("sse4.2") != 0;
+    #endif
+            }();
+            return supported;
+        }
+#endif
+
+#ifdef PD_CRC32C_ARM
+        inline std::uint32_t update_arm(std::uint32_t crc, const std::byte* p, size_t n) noexcept
+        {
+            for (; n >= 8; n -= 8, p += 8)
+            {
+                std::uint64_t v;
+                std::memcpy(&v, p, 8);
+                crc = __crc32cd(crc, v);
+            }
+            for (; n > 0; --n, ++p) crc = __crc32cb(crc, static_cast<std::uint8_t>(*p));
+            return crc;
+        }
+#endif
+    }
+
+    // True when crc32c runs on the CPU's CRC instructions.
+    inline bool crc32c_hardware() noexcept
+    {
+#if defined(PD_CRC32C_ARM)
+        return true;
+#elif defined(PD_CRC32C_X86)
+        return crc32c_detail::has_sse42();
+#else
+        return false;
+#endif
+    }
+
+    // CRC32C of data continuing from crc, the checksum of the bytes before it (0 to start).
+    inline std::uint32_t crc32c(std::span<const std::byte> data, std::uint32_t crc = 0) noexcept
+    {
+        crc = ~crc;
+#if defined(PD_CRC32C_ARM)
+        crc = crc32c_detail::update_arm(crc, data.data(), data.size());
+#elif defined(PD_CRC32C_X86)
+        if (crc32c_detail::has_sse42())
+            crc = crc32c_detail::update_sse42(crc, data.data(), data.size());
+        else
+            crc = crc32c_detail::update_scalar(crc, data.data(), data.size());
+#else
+        crc = crc32c_detail::update_scalar(crc, data.data(), data.size());
+#endif
+        return ~crc;
+    }
+
+    // Table based CRC32C, e.g. to check the hardware kernels.
+    inline std::uint32_t crc32c_scalar(std::span<const std::byte> data, std::uint32_t crc = 0) noexcept
+    {
+        return ~crc32c_detail::update_scalar(~crc, data.data(), data.size());
+    }
+}
+
+#endif // CRC32C_HPP
@@ -9,6 +9,7 @@
 #include <iostream>
 #include <iomanip>
 #include <string>
+#include <array>
 #include "concept.hpp" // for StdLayoutTriviallyCopyable
 
 namespace pensar_digital
@@ -22,6 +23,24 @@ namespace pensar_digital
         template <>
         struct TailPad<0> {}; // empty if no padding needed
 
+        /// \brief Name, offset and size of a Data member, e.g. a column of a columnar file (see DATA_COLUMNS).
+        struct ColumnInfo
+        {
+            const char* mname;
+            std::size_t moffset;
+            std::size_t msize;
+            std::size_t mswap; //!< Size of the units whose byte order depends on the endian (0: plain bytes).
+        };
+
+        /// \brief Byte order unit of a member of type M: the size of its arithmetic elements, 0 otherwise.
+        template <typename M>
+        inline constexpr std::size_t column_swap_size() noexcept
+        {
+            using E = std::remove_all_extents_t<M>;
+            if constexpr (std::is_arithmetic_v<E> && sizeof(E) > 1) return sizeof(E);
+            else return 0;
+        }
+
         // Runtime dump functions (only available in debug mode)
 #ifndef NDEBUG
         // Helper to dump a single member
@@ -173,8 +192,8 @@ namespace pensar_digital
 #define LAST_10(a, b, c, d, e, f, g, h, i, j) j
 
 // Count number of arguments
-#define COUNT_ARGS(...) COUNT_ARGS_IMPL(__VA_ARGS__, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1)
-#define COUNT_ARGS_IMPL(_1,_2,_3,_4,_5,_6,_7,_8,_9,_10,N,...) N
+#define COUNT_ARGS(...) COUNT_ARGS_IMPL(__VA_ARGS__, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1)
+#define COUNT_ARGS_IMPL(_1,_2,_3,_4,_5,_6,_7,_8,_9,_10,_11,_12,_13,_14,_15,_16,N,...) N
 
 // Concatenation helpers
 #define CONCAT(a, b) CONCAT_IMPL(a, b)
@@ -307,6 +326,43 @@ namespace pensar_digital
     VERIFY_NO_INTERNAL_PADDING(T, __VA_ARGS__); \
     ASSERT_NO_TAIL_PADDING_WRAPPER(T, __VA_ARGS__);
 
+// ============================================================================
+// COLUMN DESCRIPTIONS
+// ============================================================================
+
+#define COLUMN_INFO(T, member) \
+    pensar_digital::cpplib::ColumnInfo{ #member, MEMBER_OFFSET(T, member), MEMBER_SIZE(T, member), \
+        pensar_digital::cpplib::column_swap_size<decltype(std::declval<T>().member)>() }
+
+#define COLUMNS_1(T, m1) COLUMN_INFO(T, m1)
+#define COLUMNS_2(T, m1, ...) COLUMN_INFO(T, m1), COLUMNS_1(T, __VA_ARGS__)
+#define COLUMNS_3(T, m1, ...) COLUMN_INFO(T, m1), COLUMNS_2(T, __VA_ARGS__)
+#define COLUMNS_4(T, m1, ...) COLUMN_INFO(T, m1), COLUMNS_3(T, __VA_ARGS__)
+#define COLUMNS_5(T, m1, ...) COLUMN_INFO(T, m1), COLUMNS_4(T, __VA_ARGS__)
+#define COLUMNS_6(T, m1, ...) COLUMN_INFO(T, m1), COLUMNS_5(T, __VA_ARGS__)
+#define COLUMNS_7(T, m1, ...) COLUMN_INFO(T, m1), COLUMNS_6(T, __VA_ARGS__)
+#define COLUMNS_8(T, m1, ...) COLUMN_INFO(T, m1), COLUMNS_7(T, __VA_ARGS__)
+#define COLUMNS_9(T, m1, ...) COLUMN_INFO(T, m1), COLUMNS_8(T, __VA_ARGS__)
+#define COLUMNS_10(T, m1, ...) COLUMN_INFO(T, m1), COLUMNS_9(T, __VA_ARGS__)
+#define COLUMNS_11(T, m1, ...) COLUMN_INFO(T, m1), COLUMNS_10(T, __VA_ARGS__)
+#define COLUMNS_12(T, m1, ...) COLUMN_INFO(T, m1), COLUMNS_11(T, __VA_ARGS__)
+#define COLUMNS_13(T, m1, ...) COLUMN_INFO(T, m1), COLUMNS_12(T, __VA_ARGS__)
+#define COLUMNS_14(T, m1, ...) COLUMN_INFO(T, m1), COLUMNS_13(T, __VA_ARGS__)
+#define COLUMNS_15(T, m1, ...) COLUMN_INFO(T, m1), COLUMNS_14(T, __VA_ARGS__)
+#define COLUMNS_16(T, m1, ...) COLUMN_INFO(T, m1), COLUMNS_15(T, __VA_ARGS__)
+
+/**
+ * DATA_COLUMNS - Compile-time column list of a data structure (up to 16 members)
+ *
+ * Expands to a std::array<ColumnInfo, N> with the name, offset and size of each
+ * member, e.g. to store the structure column by column (see columnar.hpp).
+ *
+ * Usage:
+ *   inline static constexpr auto COLUMNS = DATA_COLUMNS(MyData, a, b, c, d);
+ */
+#define DATA_COLUMNS(T, ...) \
+    std::array<pensar_digital::cpplib::ColumnInfo, COUNT_ARGS(__VA_ARGS__)>{ CONCAT(COLUMNS_, COUNT_ARGS(__VA_ARGS__))(T, __VA_ARGS__) }
+
  // ============================================================================
  // OPTIONAL: GRANULAR VERIFICATION MACROS (for advanced users)
  // ============================================================================
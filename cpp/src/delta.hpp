@@ -0,0 +1,95 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#ifndef DELTA_HPP
+#define DELTA_HPP
+
+#include <bit>
+#include <span>
+#include <cstddef>
+#include <cstdint>
+#include <cstring> // std::memcpy
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define PD_DELTA_SSE2 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+    #include <arm_neon.h>
+    #define PD_DELTA_NEON 1
+#endif
+
+namespace pensar_digital::cpplib::delta
+{
+    // Changed bytes separated by fewer unchanged ones than this are sent as one run:
+    // a new run costs two varints, so a shorter gap is cheaper to resend.
+    inline constexpr size_t MERGE_GAP = 4;
+
+    // Index of the first byte in [from, n) where a and b differ, or n. Equal spans, the
+    // common case of a small change to a large record, are skipped 16 bytes at a time.
+    inline size_t first_difference(const std::byte* a, const std::byte* b, size_t from, size_t n) noexcept
+    {
+        size_t i = from;
+#if defined(PD_DELTA_SSE2)
+        for (; i + 16 <= n; i += 16)
+        {
+            const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+            const unsigned equal = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)));
+            if (equal != 0xFFFFu) return i + std::countr_zero(~equal);
+        }
+#elif defined(PD_DELTA_NEON)
+        for (; i + 16 <= n; i += 16)
+        {
+            const uint8x16_t d = veorq_u8(vld1q_u8(reinterpret_cast<const uint8_t*>(a + i)),
+                                          vld1q_u8(reinterpret_cast<const uint8_t*>(b + i)));
+            if (vmaxvq_u8(d) != 0) break; // The word loop below finds the byte.
+        }
+#endif
+        // Word-wise XOR: the lowest set byte of the difference is the first changed one.
+        for (; i + 8 <= n; i += 8)
+        {
+            std::uint64_t x, y;
+            std::memcpy(&x, a + i, 8);
+            std::memcpy(&y, b + i, 8);
+            if (const std::uint64_t d = x ^ y; d != 0)
+            {
+                if constexpr (std::endian::native == std::endian::little)
+                    return i + std::countr_zero(d) / 8;
+                else
+                    return i + std::countl_zero(d) / 8;
+            }
+        }
+        for (; i < n; ++i)
+            if (a[i] != b[i]) return i;
+        return n;
+    }
+
+    // Calls f(offset, length) for each run of changed bytes between current and baseline
+    // (same size), in order. Runs closer than MERGE_GAP are merged.
+    template <typename F>
+    void for_each_run(std::span<const std::byte> current, std::span<const std::byte> baseline, F&& f)
+    {
+        const std::byte* a = current.data();
+        const std::byte* b = baseline.data();
+        const size_t n = current.size();
+        size_t i = first_difference(a, b, 0, n);
+        while (i < n)
+        {
+            // Extend the run until MERGE_GAP equal bytes in a row (or the end).
+            size_t end = i + 1, equal = 0;
+            for (size_t k = end; k < n && equal < MERGE_GAP; ++k)
+            {
+                if (a[k] == b[k]) ++equal;
+                else
+                {
+                    equal = 0;
+                    end = k + 1;
+                }
+            }
+            f(i, end - i);
+            i = first_difference(a, b, end, n);
+        }
+    }
+}
+
+#endif // DELTA_HPP
@@ -4,10 +4,17 @@
 #ifndef FACTORY_HPP_INCLUDED
 #define FACTORY_HPP_INCLUDED
 
+#include <bit>
+#include <new>
+#include <mutex>
+#include <atomic>
 #include <memory>
 #include <type_traits>
 #include <vector>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
 
 namespace pensar_digital
 {
@@ -40,85 +47,546 @@ namespace pensar_digital
                 T* mockup_pointer;
          };
 
+        // PoolFactory hands out objects from a pool: get () pops a free slot and release returns it,
+        // both O(1). Each slot also holds the storage for its shared_ptr control block (see Allocator),
+        // so after a refill get () does not allocate. Released objects are not destroyed; get ()
+        // reinitializes them with initialize (args...).
+        //
+        // The slots are owned by a reference counted Core: objects still in use when the factory is
+        // reset or destroyed keep it alive, and it dies with the last of them.
+        //
+        // Not thread safe, as before: get and release on one thread, or serialize them.
         template <class T, typename... Args> //requires Initializable<T, Args...>
         class PoolFactory : public NewFactory <T, Args...>
         {
             private:
                 using P = NewFactory<T, Args...>::P;
-                /// <summary>
-                /// Creates a pool of objects of type T containing pool_size objects created with the arguments args.
-                /// </summary>
-                /// <param name="pool_size">Initial pool size.</param>
-                /// <param name="refill_size">When </param>
-                /// <param name="args"></param>
-                void fill_pool (const size_t& pool_size, const Args& ... args)
+
+                // Room for a shared_ptr control block with our deleter and allocator. A larger
+                // one (another standard library) still works, from the heap.
+                inline static constexpr size_t CONTROL_SIZE = 64;
+
+                struct Slot
+                {
+                    alignas(T) std::byte mobject[sizeof(T)];
+                    alignas(std::max_align_t) std::byte mcontrol[CONTROL_SIZE];
+                    Slot* mnext; // Free list link.
+
+                    T* object() noexcept { return std::launder(reinterpret_cast<T*>(mobject)); }
+                };
+
+                struct Core
                 {
-                    for (size_t i = 0; i < pool_size; ++i)
+                    std::vector<std::unique_ptr<Slot[]>> mchunks;
+                    std::vector<size_t> mchunk_sizes;
+                    Slot*  mfree = nullptr;
+                    size_t mavailable = 0;
+                    size_t msize = 0;
+                    size_t mrefs = 1; // The factory plus one per object in use.
+
+                    ~Core()
                     {
-                        std::shared_ptr<T>&& ptr = std::make_shared<T>(args ...);
-                        pool.push_back(std::move(ptr));
+                        for (size_t c = 0; c < mchunks.size(); ++c)
+                            for (size_t i = 0; i < mchunk_sizes[c]; ++i) mchunks[c][i].object()->~T();
                     }
-                    available_count = pool_size;
-                }
-                void add (const size_t& count, const Args& ... args)
+
+                    void add(size_t count, const Args& ... args)
+                    {
+                        if (count == 0) return;
+                        std::unique_ptr<Slot[]> chunk(new Slot[count]);
+                        size_t constructed = 0;
+                        try
+                        {
+                            for (; constructed < count; ++constructed) ::new (chunk[constructed].mobject) T(args ...);
+                        }
+                        catch (...)
+                        {
+                            while (constructed > 0) chunk[--constructed].object()->~T();
+                            throw;
+                        }
+                        // Pushed in reverse so gets walk the chunk in address order.
+                        for (size_t i = count; i-- > 0; ) push(&chunk[i]);
+                        mchunks.push_back(std::move(chunk));
+                        mchunk_sizes.push_back(count);
+                        msize += count;
+                    }
+
+                    void push(Slot* s) noexcept
+                    {
+                        s->mnext = mfree;
+                        mfree = s;
+                        ++mavailable;
+                    }
+
+                    Slot* pop() noexcept
+                    {
+                        Slot* s = mfree;
+                        mfree = s->mnext;
+                        --mavailable;
+                        return s;
+                    }
+
+                    static void unref(Core* core) noexcept
+                    {
+                        if (--core->mrefs == 0) delete core;
+                    }
+                };
+
+                // The object stays constructed in its slot: nothing to do on release but the
+                // control block deallocation below, the last step of a shared_ptr's life.
+                struct Deleter
+                {
+                    void operator()(T*) const noexcept {}
+                };
+
+                // Allocates the control block in the slot's storage and, on its deallocation,
+                // returns the slot to the free list.
+                template <class U>
+                struct Allocator
                 {
-					for (size_t i = 0; i < count; ++i)
-					{
-                        std::shared_ptr<T>&& ptr = std::make_shared<T>(args ...);
-                        pool.push_back(ptr);
+                    using value_type = U;
+                    Core* mcore;
+                    Slot* mslot;
+
+                    Allocator(Core* core, Slot* slot) noexcept : mcore(core), mslot(slot) {}
+                    template <class V>
+                    Allocator(const Allocator<V>& o) noexcept : mcore(o.mcore), mslot(o.mslot) {}
+
+                    U* allocate(size_t n)
+                    {
+                        if (sizeof(U) * n <= CONTROL_SIZE && alignof(U) <= alignof(std::max_align_t))
+                            return reinterpret_cast<U*>(mslot->mcontrol);
+                        return static_cast<U*>(::operator new(sizeof(U) * n));
                     }
-					available_count += count;
-				}
+
+                    void deallocate(U* p, size_t) noexcept
+                    {
+                        if (reinterpret_cast<std::byte*>(p) != mslot->mcontrol) ::operator delete(p);
+                        mcore->push(mslot);
+                        Core::unref(mcore);
+                    }
+
+                    template <class V>
+                    bool operator==(const Allocator<V>& o) const noexcept { return mslot == o.mslot; }
+                };
+
+                Core* mcore;
+                size_t refill_size;
+
         public:
             //inline static const Version::Ptr VERSION = pd::Version::get (1, 1, 1);
             PoolFactory (const size_t initial_pool_size, const size_t a_refill_size, const Args& ... args) :
-                         available_count (0), 
+                         mcore (new Core()), 
                          refill_size(a_refill_size)
             {
-                fill_pool(initial_pool_size, args ...);
+                mcore->add(initial_pool_size, args ...);
             };
             
             PoolFactory(const Args& ... args) : PoolFactory (10, 10, args ...) { };
+
+            PoolFactory(const PoolFactory&) = delete;
+            PoolFactory& operator=(const PoolFactory&) = delete;
             
-            virtual ~PoolFactory() {}
+            virtual ~PoolFactory() { Core::unref(mcore); }
 
-            virtual P get(const Args& ... args) 
+            // Const as NewFactory::get, which it overrides: the pool lives behind mcore.
+            P get(const Args& ... args) const override
             { 
-                // Iterate through the pool to find an available object.
-                for (auto& ptr : pool)
-                {
-					if (ptr.use_count () < 2)
-					{
-                        ptr->initialize (args ...);
-                        available_count--;
-
-                        // Need to copy to increase the use count.
-						return * new (std::shared_ptr<T>) (ptr); 
-					}
-				}
-                assert(available_count <= 0);
-    			add (refill_size, args ...);
-                return get (args ...);
+                if (mcore->mfree == nullptr) mcore->add(refill_size > 0 ? refill_size : 1, args ...);
+                Slot* s = mcore->pop();
+                T* object = s->object();
+                object->initialize (args ...);
+                ++mcore->mrefs;
+                try
+                {
+                    return P(object, Deleter(), Allocator<T>(mcore, s));
+                }
+                catch (...) // Only an oversized control block allocates.
+                {
+                    mcore->push(s);
+                    --mcore->mrefs;
+                    throw;
+                }
             }
-            size_t get_available_count() const { return available_count; }
+            size_t get_available_count() const { return mcore->mavailable; }
 
-            size_t get_pool_size() const { return pool.size(); }
+            size_t get_pool_size() const { return mcore->msize; }
 
             size_t get_refill_size() const { return refill_size; }
 
             void set_refill_size(const size_t& value) { refill_size = value; }
 
+            /// Starts over with a new pool. Objects in use stay valid; they return to the old pool,
+            /// which is freed with the last of them.
             void reset(const size_t& initial_pool_size, const size_t& a_refill_size, const Args& ... args)
 			{
-				pool.clear();
-				fill_pool(initial_pool_size, args ...);
-				available_count = initial_pool_size;
+                Core* fresh = new Core();
+                try { fresh->add(initial_pool_size, args ...); }
+                catch (...) { delete fresh; throw; }
+                Core::unref(mcore);
+                mcore = fresh;
 				refill_size = a_refill_size;
 			}
-        private:
-            std::vector<typename std::shared_ptr<T>> pool;
-            size_t available_count;
-            size_t refill_size;
+        };
+
+        // ConcurrentPoolFactory is the thread safe PoolFactory for factories shared by threads, e.g.
+        // a class's static mfactory (see Factory::set_factory). Each thread takes and returns objects
+        // through its own cache of free slots, with no synchronization; caches trade batches of BATCH
+        // slots with a global depot, a lock-free stack. Only growing the pool takes a mutex. An object
+        // may be released on any thread.
+        //
+        // Objects in use are not counted one by one (that would be a shared counter per get): the
+        // core counts the slots outside the depot, updated a chain at a time, in the same atomic as
+        // its references. When the factory dies before all objects are back, the pool is freed by
+        // whichever thread brings that count to zero.
+        template <class T, typename... Args> //requires Initializable<T, Args...>
+        class ConcurrentPoolFactory : public NewFactory <T, Args...>
+        {
+            private:
+                using P = NewFactory<T, Args...>::P;
+
+                inline static constexpr size_t CONTROL_SIZE = 64; // See PoolFactory.
+                inline static constexpr size_t BATCH = 64;        // Slots per depot transfer.
+
+                struct Slot
+                {
+                    alignas(T) std::byte mobject[sizeof(T)];
+                    alignas(std::max_align_t) std::byte mcontrol[CONTROL_SIZE];
+                    Slot* mnext;                              // Next in a chain, owned by one thread.
+                    std::atomic<std::uint32_t> mnext_chain;   // Index of the next chain in the depot, on a chain's head.
+                    size_t mchain_size;                       // On a chain's head.
+                    std::uint32_t mindex;                     // Index of this slot in the core.
+
+                    T* object() noexcept { return std::launder(reinterpret_cast<T*>(mobject)); }
+                };
+
+                struct Core
+                {
+                    // Depot head: the index of a slot in the low 32 bits and an ABA tag in the high
+                    // ones. An index, not a pointer: the high bits of a pointer are not free on every
+                    // platform (tagged heap pointers on Android, 5-level paging on x86-64).
+                    std::atomic<std::uint64_t> mdepot{ NONE };
+                    std::atomic<size_t> mdepot_size{ 0 };
+                    std::atomic<size_t> msize{ 0 };
+                    // REF per reference (the factory plus one per thread cache) plus one per slot
+                    // outside the depot. One atomic, so deleting the core is a single transition to 0.
+                    std::atomic<std::uint64_t> mholds{ REF };
+                    std::mutex mgrow;
+                    std::vector<std::pair<std::unique_ptr<Slot[]>, size_t>> mchunks;
+                    // Slot of each index, readable without the lock: segment k holds indices
+                    // 2^k - 1 to 2^(k+1) - 2, allocated by grow before any of them is published.
+                    std::atomic<Slot**> msegments[32]{};
+                    std::uint32_t mslot_count = 0; // Under mgrow.
+
+                    static constexpr std::uint64_t REF = std::uint64_t{ 1 } << 40;
+                    static constexpr std::uint32_t NONE = UINT32_MAX; // No slot: an empty depot, the last chain.
+
+                    static std::uint32_t head(std::uint64_t v) noexcept { return static_cast<std::uint32_t>(v); }
+                    static std::uint64_t pack(std::uint32_t index, std::uint64_t old) noexcept
+                    {
+                        return index | (((old >> 32) + 1) << 32);
+                    }
+
+                    Slot* slot(std::uint32_t index) const noexcept
+                    {
+                        const unsigned k = std::bit_width(std::uint64_t{ index } + 1) - 1;
+                        return msegments[k].load(std::memory_order_acquire)[index + 1 - (std::uint64_t{ 1 } << k)];
+                    }
+
+                    ~Core()
+                    {
+                        for (auto& [chunk, count] : mchunks)
+                            for (size_t i = 0; i < count; ++i) chunk[i].object()->~T();
+                        for (auto& segment : msegments) delete[] segment.load(std::memory_order_relaxed);
+                    }
+
+                    // Gives the slots of chunk their indices. Called under mgrow.
+                    void number(Slot* chunk, size_t count)
+                    {
+                        if (count >= NONE - mslot_count) throw std::bad_alloc();
+                        for (size_t i = 0; i < count; ++i)
+                        {
+                            const std::uint32_t index = mslot_count++;
+                            const unsigned k = std::bit_width(std::uint64_t{ index } + 1) - 1;
+                            Slot** segment = msegments[k].load(std::memory_order_relaxed);
+                            if (segment == nullptr)
+                            {
+                                segment = new Slot*[size_t{ 1 } << k];
+                                msegments[k].store(segment, std::memory_order_release);
+                            }
+                            segment[index + 1 - (std::uint64_t{ 1 } << k)] = &chunk[i];
+                            chunk[i].mindex = index;
+                        }
+                    }
+
+                    void push_chain(Slot* first, size_t count) noexcept
+                    {
+                        first->mchain_size = count;
+                        std::uint64_t old = mdepot.load(std::memory_order_relaxed);
+                        do first->mnext_chain.store(head(old), std::memory_order_relaxed);
+                        while (!mdepot.compare_exchange_weak(old, pack(first->mindex, old), std::memory_order_release, std::memory_order_relaxed));
+                        mdepot_size.fetch_add(count, std::memory_order_relaxed);
+                    }
+
+                    Slot* pop_chain() noexcept
+                    {
+                        std::uint64_t old = mdepot.load(std::memory_order_acquire);
+                        // Slots are never freed while the core lives, so reading a head popped
+                        // meanwhile is safe; the tag makes the exchange fail.
+                        for (std::uint32_t index = head(old); index != NONE; index = head(old))
+                        {
+                            Slot* s = slot(index);
+                            if (mdepot.compare_exchange_weak(old, pack(s->mnext_chain.load(std::memory_order_relaxed), old), std::memory_order_acquire, std::memory_order_acquire))
+                            {
+                                // The caller's cache holds a reference: the count cannot be 0 meanwhile.
+                                mholds.fetch_add(s->mchain_size, std::memory_order_relaxed);
+                                mdepot_size.fetch_sub(s->mchain_size, std::memory_order_relaxed);
+                                return s;
+                            }
+                        }
+                        return nullptr;
+                    }
+
+                    // New slots, returned as a chain to the calling thread.
+                    Slot* grow(size_t count, size_t& chain_size, const Args& ... args)
+                    {
+                        std::unique_ptr<Slot[]> chunk(new Slot[count]);
+                        size_t constructed = 0;
+                        try
+                        {
+                            for (; constructed < count; ++constructed) ::new (chunk[constructed].mobject) T(args ...);
+                        }
+                        catch (...)
+                        {
+                            while (constructed > 0) chunk[--constructed].object()->~T();
+                            throw;
+                        }
+                        for (size_t i = 0; i + 1 < count; ++i) chunk[i].mnext = &chunk[i + 1];
+                        chunk[count - 1].mnext = nullptr;
+                        Slot* first = &chunk[0];
+                        {
+                            std::lock_guard lock(mgrow);
+                            try
+                            {
+                                number(chunk.get(), count);
+                                mchunks.emplace_back(std::move(chunk), count);
+                            }
+                            catch (...) // Out of indices or memory: the indices taken are never published.
+                            {
+                                for (size_t i = 0; i < count; ++i) chunk[i].object()->~T();
+                                throw;
+                            }
+                        }
+                        mholds.fetch_add(count, std::memory_order_relaxed);
+                        msize.fetch_add(count, std::memory_order_relaxed);
+                        chain_size = count;
+                        return first;
+                    }
+
+                    void ref() noexcept { mholds.fetch_add(REF, std::memory_order_relaxed); }
+
+                    // Drops n holds; the caller bringing the count to 0 (no references, every slot
+                    // in the depot) deletes the core. Nothing touches it after its own drop.
+                    static void release(Core* core, std::uint64_t n) noexcept
+                    {
+                        if (core->mholds.fetch_sub(n, std::memory_order_acq_rel) == n) delete core;
+                    }
+
+                    static void unref(Core* core) noexcept { release(core, REF); }
+
+                    // Returns a chain to the depot.
+                    static void give_back(Core* core, Slot* first, size_t count) noexcept
+                    {
+                        core->push_chain(first, count);
+                        release(core, count);
+                    }
+                };
+
+                // A thread's free slots for one core.
+                struct Cache
+                {
+                    Core*  mcore;
+                    Slot*  mfree = nullptr;
+                    size_t mcount = 0;
+
+                    void push(Slot* s) noexcept
+                    {
+                        s->mnext = mfree;
+                        mfree = s;
+                        if (++mcount < 2 * BATCH) return;
+                        // Keep BATCH, hand the rest to the depot.
+                        Slot* last = mfree;
+                        for (size_t i = 1; i < BATCH; ++i) last = last->mnext;
+                        Core::give_back(mcore, last->mnext, mcount - BATCH);
+                        last->mnext = nullptr;
+                        mcount = BATCH;
+                    }
+
+                    void flush() noexcept
+                    {
+                        if (mcount > 0) Core::give_back(mcore, mfree, mcount);
+                        mfree = nullptr;
+                        mcount = 0;
+                    }
+                };
+
+                struct Caches
+                {
+                    std::vector<std::unique_ptr<Cache>> mcaches;
+                    Cache* mlast = nullptr;
+
+                    ~Caches()
+                    {
+                        for (auto& c : mcaches)
+                        {
+                            c->flush();
+                            Core::unref(c->mcore);
+                        }
+                        dead() = true;
+                    }
+
+                    // After this thread's caches are gone (thread exit, static destruction).
+                    static bool& dead() noexcept
+                    {
+                        thread_local bool d = false;
+                        return d;
+                    }
+
+                    Cache& get(Core* core)
+                    {
+                        if (mlast != nullptr && mlast->mcore == core) return *mlast;
+                        for (auto& c : mcaches)
+                            if (c->mcore == core) return *(mlast = c.get());
+                        core->ref();
+                        mcaches.push_back(std::make_unique<Cache>(Cache{ core }));
+                        return *(mlast = mcaches.back().get());
+                    }
+
+                    void remove(Core* core) noexcept
+                    {
+                        for (size_t i = 0; i < mcaches.size(); ++i)
+                        {
+                            if (mcaches[i]->mcore != core) continue;
+                            mcaches[i]->flush();
+                            if (mlast == mcaches[i].get()) mlast = nullptr;
+                            mcaches.erase(mcaches.begin() + i);
+                            Core::unref(core);
+                            return;
+                        }
+                    }
+                };
+
+                static Caches& caches()
+                {
+                    thread_local Caches c;
+                    return c;
+                }
+
+                struct Deleter
+                {
+                    void operator()(T*) const noexcept {}
+                };
+
+                // Control block storage in the slot, as in PoolFactory; deallocation returns the
+                // slot to the releasing thread's cache.
+                template <class U>
+                struct Allocator
+                {
+                    using value_type = U;
+                    Core* mcore;
+                    Slot* mslot;
+
+                    Allocator(Core* core, Slot* slot) noexcept : mcore(core), mslot(slot) {}
+                    template <class V>
+                    Allocator(const Allocator<V>& o) noexcept : mcore(o.mcore), mslot(o.mslot) {}
+
+                    U* allocate(size_t n)
+                    {
+                        if (sizeof(U) * n <= CONTROL_SIZE && alignof(U) <= alignof(std::max_align_t))
+                            return reinterpret_cast<U*>(mslot->mcontrol);
+                        return static_cast<U*>(::operator new(sizeof(U) * n));
+                    }
+
+                    void deallocate(U* p, size_t) noexcept
+                    {
+                        if (reinterpret_cast<std::byte*>(p) != mslot->mcontrol) ::operator delete(p);
+                        if (!Caches::dead())
+                        {
+                            caches().get(mcore).push(mslot);
+                            return;
+                        }
+                        // The slot is itself a hold, so the core is alive until this drop.
+                        Core::give_back(mcore, mslot, 1);
+                    }
+
+                    template <class V>
+                    bool operator==(const Allocator<V>& o) const noexcept { return mslot == o.mslot; }
+                };
+
+                Core* mcore;
+                size_t refill_size;
+
+        public:
+            ConcurrentPoolFactory (const size_t initial_pool_size, const size_t a_refill_size, const Args& ... args) :
+                                   mcore (new Core()),
+                                   refill_size (a_refill_size > 0 ? a_refill_size : 1)
+            {
+                if (initial_pool_size == 0) return;
+                size_t n = 0;
+                Slot* chain = mcore->grow(initial_pool_size, n, args ...);
+                Core::give_back(mcore, chain, n);
+            };
+
+            ConcurrentPoolFactory(const Args& ... args) : ConcurrentPoolFactory (10, BATCH, args ...) { };
+
+            ConcurrentPoolFactory(const ConcurrentPoolFactory&) = delete;
+            ConcurrentPoolFactory& operator=(const ConcurrentPoolFactory&) = delete;
+
+            virtual ~ConcurrentPoolFactory()
+            {
+                if (!Caches::dead()) caches().remove(mcore);
+                Core::unref(mcore);
+            }
+
+            // Overrides NewFactory::get, so a Factory set to this pool uses it.
+            virtual P get(const Args& ... args) const override
+            {
+                Cache& c = caches().get(mcore);
+                if (c.mfree == nullptr)
+                {
+                    if (Slot* chain = mcore->pop_chain())
+                    {
+                        c.mfree = chain;
+                        c.mcount = chain->mchain_size;
+                    }
+                    else c.mfree = mcore->grow(refill_size, c.mcount, args ...);
+                }
+                Slot* s = c.mfree;
+                c.mfree = s->mnext;
+                --c.mcount;
+                T* object = s->object();
+                object->initialize (args ...);
+                try
+                {
+                    return P(object, Deleter(), Allocator<T>(mcore, s));
+                }
+                catch (...) // Only an oversized control block allocates.
+                {
+                    c.push(s);
+                    throw;
+                }
+            }
+
+            size_t get_pool_size() const { return mcore->msize.load(std::memory_order_relaxed); }
+
+            // Free objects in the depot and in the calling thread's cache; other threads'
+            // caches are not counted.
+            size_t get_available_count() const
+            {
+                return mcore->mdepot_size.load(std::memory_order_relaxed) + caches().get(mcore).mcount;
+            }
+
+            size_t get_refill_size() const { return refill_size; }
         };
 
         template <class T, typename... Args>
@@ -135,7 +603,9 @@ namespace pensar_digital
 				std::shared_ptr<T> singleton;
         };
 
-        // Factory can be configured to be a NewFactory, MockupFactory, PoolFactory or SingletonFactory.   
+        // Factory can be configured to be a NewFactory, MockupFactory, PoolFactory or SingletonFactory.
+        // By default it is a NewFactory: every get () returns a newly constructed object. Pooling is
+        // opt in through set_factory, for types whose initialize resets all of their state.
 		template <class T, typename... Args>
 		class Factory
 		{
@@ -143,9 +613,10 @@ namespace pensar_digital
                 using P = NewFactory<T, Args...>::P;
                 //inline static const Version::Ptr VERSION = pd::Version::get (1, 1, 1);
                 
-                Factory (const size_t pool_size, const size_t refill_size, const Args& ... args) 
+                // The pool sizes are kept for the callers' sake; a pool is chosen with set_factory.
+                Factory (const size_t, const size_t, const Args& ...) 
                 { 
-                    mfactory_ptr = std::make_shared<PoolFactory<T, Args...>>(pool_size, refill_size, args ...);
+                    mfactory_ptr = std::make_shared<NewFactory<T, Args...>>();
                 };
 
                 virtual ~Factory() { }
@@ -153,7 +624,9 @@ namespace pensar_digital
                 virtual P get (const Args& ... args) { return mfactory_ptr->get(args ...); }
                 NewFactory<T, Args...>& get_factory () const { return *mfactory_ptr.get(); }
                                 
-				void set_factory (const NewFactory<T, Args...>* afactory) { mfactory_ptr = afactory; }
+                /// Replaces the factory behind get (), e.g. with a ConcurrentPoolFactory for a factory
+                /// shared by threads. Call it before the factory is in use: the swap itself is not synchronized.
+				void set_factory (std::shared_ptr<NewFactory<T, Args...>> afactory) { mfactory_ptr = std::move(afactory); }
 			private:
                 std::shared_ptr<NewFactory<T, Args...>> mfactory_ptr;
 		};  
@@ -0,0 +1,283 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#ifndef FRAME_HPP
+#define FRAME_HPP
+
+#include <span>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+#include "endian.hpp"
+#include "concept.hpp"
+#include "wire_int.hpp"
+#include "crc32c.hpp"
+#include "parallel.hpp"
+#include "compression.hpp"
+#include "code_util.hpp" // Result
+
+namespace pensar_digital::cpplib
+{
+    // ------------------------------------------------------------
+    // Framed format
+    // ------------------------------------------------------------
+    // A byte stream split in frames, each checked by a CRC32C, so a torn or corrupted
+    // file is detected frame by frame as it is read instead of as a bad record later:
+    //
+    //   FrameFileHeader | FrameHeader payload | ... | FrameHeader(length 0) total
+    //
+    // Payloads hold at most block_size bytes. The end frame has length 0, the CRC32C of
+    // the 8 byte total that follows, and the total payload size, so a file cut at a
+    // frame boundary is detected too. All fields are little endian.
+    //
+    // The flags of the file header name a Codec (compression.hpp). With a codec other
+    // than NONE each payload is a compressed block of at most block_size bytes once
+    // decompressed; checksums cover the compressed bytes and the total counts the
+    // decompressed ones. Blocks are independent, so frame() compresses and
+    // unframe_parallel() verifies and decompresses them on several threads.
+
+    inline constexpr size_t        DEFAULT_FRAME_BLOCK = 1 << 20;
+    inline constexpr std::uint32_t MAX_FRAME_BLOCK     = 1u << 30;
+
+    using LEUInt16 = Int<std::uint16_t, Endian::little()>;
+    using LEUInt32 = Int<std::uint32_t, Endian::little()>;
+    using LEUInt64 = Int<std::uint64_t, Endian::little()>;
+
+    struct FrameFileHeader
+    {
+        char     mmagic[4] = { 'P', 'D', 'F', 'R' };
+        LEUInt16 mversion{ 1 };
+        LEUInt16 mflags{ 0 };
+        LEUInt32 mblock_size{ 0 };
+        LEUInt32 mcrc{ 0 };        //!< CRC32C of the fields above.
+
+        FrameFileHeader() = default;
+        explicit FrameFileHeader(std::uint32_t block_size, Codec codec = Codec::NONE) noexcept
+            : mflags(static_cast<std::uint16_t>(codec)), mblock_size(block_size) { mcrc = checksum(); }
+
+        [[nodiscard]] Codec codec() const noexcept { return static_cast<Codec>(mflags.value()); }
+
+        // Largest payload of a frame.
+        [[nodiscard]] size_t max_payload() const noexcept
+        {
+            return codec() == Codec::NONE ? mblock_size.value() : compress_bound(mblock_size.value());
+        }
+
+        [[nodiscard]] std::uint32_t checksum() const noexcept
+        {
+            return crc32c(std::as_bytes(std::span<const FrameFileHeader>(this, 1)).first(offsetof(FrameFileHeader, mcrc)));
+        }
+
+        [[nodiscard]] Result<Bool> check() const
+        {
+            if (std::memcmp(mmagic, "PDFR", 4) != 0) return Result<Bool>(W("Not a framed stream"));
+            if (mcrc.value() != checksum())          return Result<Bool>(W("Frame header checksum mismatch"));
+            if (mversion.value() != 1)               return Result<Bool>(W("Unsupported framed stream version"));
+            if (mflags.value() > 0xFF || !valid_codec(static_cast<std::uint8_t>(mflags.value()))) return Result<Bool>(W("Unknown frame codec"));
+            if (mblock_size.value() == 0 || mblock_size.value() > MAX_FRAME_BLOCK) return Result<Bool>(W("Invalid frame block size"));
+            return Result<Bool>(Bool::T);
+        }
+    };
+    static_assert(WireSafe<FrameFileHeader> && sizeof(FrameFileHeader) == 16);
+
+    struct FrameHeader
+    {
+        LEUInt32 mlength{ 0 };
+        LEUInt32 mcrc{ 0 };
+
+        FrameHeader() = default;
+        explicit FrameHeader(std::span<const std::byte> payload) noexcept
+            : mlength(static_cast<std::uint32_t>(payload.size())), mcrc(crc32c(payload)) {}
+
+        // End frame of a stream of total payload bytes; total_bytes receives the trailer.
+        static FrameHeader end(std::uint64_t total, LEUInt64& total_bytes) noexcept
+        {
+            total_bytes = total;
+            FrameHeader h;
+            h.mcrc = crc32c(std::as_bytes(std::span<const LEUInt64>(&total_bytes, 1)));
+            return h;
+        }
+
+        [[nodiscard]] bool is_end() const noexcept { return mlength.value() == 0; }
+
+        [[nodiscard]] Result<Bool> check(std::span<const std::byte> payload) const
+        {
+            if (crc32c(payload) != mcrc.value()) return Result<Bool>(W("Frame checksum mismatch"));
+            return Result<Bool>(Bool::T);
+        }
+
+        // Checks an end frame against its trailer and the payload bytes read before it.
+        [[nodiscard]] Result<Bool> check_end(const LEUInt64& total_bytes, std::uint64_t total) const
+        {
+            if (crc32c(std::as_bytes(std::span<const LEUInt64>(&total_bytes, 1))) != mcrc.value()) return Result<Bool>(W("End frame checksum mismatch"));
+            if (total_bytes.value() != total) return Result<Bool>(W("Framed stream size mismatch"));
+            return Result<Bool>(Bool::T);
+        }
+    };
+    static_assert(WireSafe<FrameHeader> && sizeof(FrameHeader) == 8);
+
+    inline constexpr size_t FRAME_OVERHEAD = sizeof(FrameFileHeader) + sizeof(FrameHeader) + sizeof(LEUInt64);
+
+    // Size of data once framed in blocks of block_size bytes, without compression.
+    inline constexpr size_t framed_size(size_t size, size_t block_size) noexcept
+    {
+        return FRAME_OVERHEAD + size + (size + block_size - 1) / block_size * sizeof(FrameHeader);
+    }
+
+    // Appends data to out as a complete framed stream, compressing the blocks with codec
+    // on up to threads threads (0: one per core).
+    inline void frame(std::span<const std::byte> data, std::vector<std::byte>& out, size_t block_size = DEFAULT_FRAME_BLOCK,
+                      Codec codec = Codec::NONE, unsigned threads = 0)
+    {
+        block_size = std::clamp<size_t>(block_size, 1, MAX_FRAME_BLOCK);
+        auto append = [&out](const auto& pod) { const auto b = std::as_bytes(std::span(&pod, 1)); out.insert(out.end(), b.begin(), b.end()); };
+        const size_t blocks = (data.size() + block_size - 1) / block_size;
+        auto block = [&](size_t i) { return data.subspan(i * block_size, (std::min)(block_size, data.size() - i * block_size)); };
+
+        std::vector<std::vector<std::byte>> compressed(codec == Codec::NONE ? 0 : blocks);
+        parallel_for(compressed.size(), threads, [&](size_t i)
+        {
+            compressed[i].resize(compress_bound(block(i).size()));
+            compressed[i].resize(compress_block(codec, block(i), compressed[i]));
+        });
+
+        size_t size = FRAME_OVERHEAD + blocks * sizeof(FrameHeader);
+        for (size_t i = 0; i < blocks; ++i) size += codec == Codec::NONE ? block(i).size() : compressed[i].size();
+        out.reserve(out.size() + size);
+        append(FrameFileHeader(static_cast<std::uint32_t>(block_size), codec));
+        for (size_t i = 0; i < blocks; ++i)
+        {
+            const std::span<const std::byte> payload = codec == Codec::NONE ? block(i) : std::span<const std::byte>(compressed[i]);
+            append(FrameHeader(payload));
+            out.insert(out.end(), payload.begin(), payload.end());
+        }
+        LEUInt64 total;
+        append(FrameHeader::end(data.size(), total));
+        append(total);
+    }
+
+    // Verifies a complete framed stream, passing each decompressed payload to sink
+    // (span<const std::byte>) once its checksum matched. Stops at the first error.
+    template <typename Sink>
+    Result<Bool> unframe(std::span<const std::byte> framed, Sink&& sink)
+    {
+        FrameFileHeader fh;
+        if (framed.size() < sizeof(fh)) return Result<Bool>(W("Truncated framed stream"));
+        std::memcpy(&fh, framed.data(), sizeof(fh));
+        if (Result<Bool> r = fh.check(); !r) return r;
+        std::vector<std::byte> raw(fh.codec() == Codec::NONE ? 0 : fh.mblock_size.value());
+        size_t pos = sizeof(fh);
+        std::uint64_t total = 0;
+        while (true)
+        {
+            FrameHeader h;
+            if (framed.size() - pos < sizeof(h)) return Result<Bool>(W("Truncated framed stream"));
+            std::memcpy(&h, framed.data() + pos, sizeof(h));
+            pos += sizeof(h);
+            if (h.is_end())
+            {
+                LEUInt64 total_bytes;
+                if (framed.size() - pos < sizeof(total_bytes)) return Result<Bool>(W("Truncated framed stream"));
+                std::memcpy(&total_bytes, framed.data() + pos, sizeof(total_bytes));
+                return h.check_end(total_bytes, total);
+            }
+            const size_t length = h.mlength.value();
+            if (length > fh.max_payload()) return Result<Bool>(W("Frame larger than the block size"));
+            if (framed.size() - pos < length) return Result<Bool>(W("Truncated framed stream"));
+            std::span<const std::byte> payload = framed.subspan(pos, length);
+            if (Result<Bool> r = h.check(payload); !r) return r;
+            if (fh.codec() != Codec::NONE)
+            {
+                Result<size_t> n = decompress_block(payload, raw);
+                if (!n) return Result<Bool>(n.merror_message, Bool::F);
+                payload = std::span<const std::byte>(raw).first(n.mresult);
+            }
+            sink(payload);
+            pos += length;
+            total += payload.size();
+        }
+    }
+
+    // Frame positions of a framed stream, read from the frame headers without verifying
+    // the payloads (see unframe_parallel).
+    struct FrameIndex
+    {
+        struct Entry
+        {
+            size_t mpos;        //!< Payload position in the stream.
+            size_t mlength;     //!< Payload size in the stream.
+            size_t mraw_pos;    //!< Position of the decompressed payload.
+            size_t mraw_size;   //!< Size of the decompressed payload.
+        };
+
+        FrameFileHeader    mheader;
+        std::vector<Entry> mframes;
+        size_t             mraw_size = 0; //!< Decompressed size of the whole stream.
+
+        // Indexes framed, failing if its decompressed size would exceed max_raw_size, so a
+        // crafted header cannot make the caller allocate far more than the file holds.
+        Result<Bool> build(std::span<const std::byte> framed, size_t max_raw_size = SIZE_MAX)
+        {
+            mframes.clear();
+            mraw_size = 0;
+            if (framed.size() < sizeof(mheader)) return Result<Bool>(W("Truncated framed stream"));
+            std::memcpy(&mheader, framed.data(), sizeof(mheader));
+            if (Result<Bool> r = mheader.check(); !r) return r;
+            for (size_t pos = sizeof(mheader); ; )
+            {
+                FrameHeader h;
+                if (framed.size() - pos < sizeof(h)) return Result<Bool>(W("Truncated framed stream"));
+                std::memcpy(&h, framed.data() + pos, sizeof(h));
+                pos += sizeof(h);
+                if (h.is_end())
+                {
+                    LEUInt64 total_bytes;
+                    if (framed.size() - pos < sizeof(total_bytes)) return Result<Bool>(W("Truncated framed stream"));
+                    std::memcpy(&total_bytes, framed.data() + pos, sizeof(total_bytes));
+                    return h.check_end(total_bytes, mraw_size);
+                }
+                const size_t length = h.mlength.value();
+                if (length > mheader.max_payload()) return Result<Bool>(W("Frame larger than the block size"));
+                if (framed.size() - pos < length) return Result<Bool>(W("Truncated framed stream"));
+                const size_t raw = mheader.codec() == Codec::NONE ? length : block_raw_size(framed.subspan(pos, length));
+                if (raw > mheader.mblock_size.value()) return Result<Bool>(W("Frame larger than the block size"));
+                if (raw > max_block_raw_size(length)) return Result<Bool>(W("Frame larger than its payload can decode to"));
+                if (raw > max_raw_size - mraw_size) return Result<Bool>(W("Framed stream larger than the limit"));
+                mframes.push_back({ pos, length, mraw_size, raw });
+                mraw_size += raw;
+                pos += length;
+            }
+        }
+    };
+
+    // Verifies and decompresses the frames of index into out (index.mraw_size bytes) on up
+    // to threads threads (0: one per core).
+    inline Result<Bool> unframe_parallel(std::span<const std::byte> framed, const FrameIndex& index, std::span<std::byte> out, unsigned threads = 0)
+    {
+        if (out.size() < index.mraw_size) return Result<Bool>(W("Output smaller than the framed stream"));
+        std::vector<Result<Bool>> results(index.mframes.size(), Result<Bool>(Bool::T));
+        parallel_for(index.mframes.size(), threads, [&](size_t i)
+        {
+            const FrameIndex::Entry& e = index.mframes[i];
+            const std::span<const std::byte> payload = framed.subspan(e.mpos, e.mlength);
+            FrameHeader h;
+            std::memcpy(&h, framed.data() + e.mpos - sizeof(h), sizeof(h));
+            if (Result<Bool> r = h.check(payload); !r) { results[i] = r; return; }
+            const std::span<std::byte> dest = out.subspan(e.mraw_pos, e.mraw_size);
+            if (index.mheader.codec() == Codec::NONE)
+            {
+                std::memcpy(dest.data(), payload.data(), payload.size());
+                return;
+            }
+            if (Result<size_t> n = decompress_block(payload, dest); !n) results[i] = Result<Bool>(n.merror_message, Bool::F);
+        });
+        for (const Result<Bool>& r : results)
+            if (!r) return r;
+        return Result<Bool>(Bool::T);
+    }
+}
+
+#endif // FRAME_HPP
@@ -0,0 +1,83 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#ifndef FRAMED_IO_HPP
+#define FRAMED_IO_HPP
+
+#include <span>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "frame.hpp"
+#include "binary_buffer.hpp"
+#include "code_util.hpp" // Result
+
+namespace pensar_digital::cpplib
+{
+    // ------------------------------------------------------------
+    // Framed files
+    // ------------------------------------------------------------
+    // BinaryBuffer contents saved in the framed format of frame.hpp. Kept out of
+    // binary_buffer.hpp so the core buffer does not pull in compression and threads.
+
+    // Saves the written bytes of bb as a framed stream: a CRC32C per block of block_size
+    // bytes lets load_framed detect a torn or corrupted file. Blocks are compressed with
+    // codec, on several threads.
+    inline Result<Bool> save_framed(const BinaryBuffer& bb, std::string_view filename, size_t block_size = DEFAULT_FRAME_BLOCK, Codec codec = Codec::NONE)
+    {
+        std::vector<std::byte> framed;
+        frame(bb.data(), framed, block_size, codec);
+        FILE* f = fopen(std::string(filename).c_str(), "wb");
+        if (!f) return Result<Bool>(W("Failed to open file for writing"));
+
+        size_t written = fwrite(framed.data(), sizeof(std::byte), framed.size(), f);
+        fclose(f);
+
+        if (written != framed.size()) return Result<Bool>(W("Failed to write all bytes to disk"));
+        return Result<Bool>(Bool::T);
+    }
+
+    // Loads a file written by save_framed into bb, verifying and decompressing the frames
+    // on several threads. On error bb is left empty. Fails before allocating if the file
+    // would decompress to more than max_size bytes.
+    inline Result<Bool> load_framed(BinaryBuffer& bb, std::string_view filename, size_t max_size = SIZE_MAX)
+    {
+        FILE* f = fopen(std::string(filename).c_str(), "rb");
+        if (!f) return Result<Bool>(W("Failed to open file for reading"));
+
+        fseek(f, 0, SEEK_END);
+        long file_size = ftell(f);
+        fseek(f, 0, SEEK_SET);
+        if (file_size < 0)
+        {
+            fclose(f);
+            return Result<Bool>(W("Could not determine file size"));
+        }
+
+        std::vector<std::byte> framed(static_cast<size_t>(file_size));
+        size_t read_bytes = fread(framed.data(), sizeof(std::byte), framed.size(), f);
+        fclose(f);
+        if (read_bytes != framed.size()) return Result<Bool>(W("Read mismatch: read less bytes than expected"));
+
+        bb.detach();
+        bb.clear();
+        FrameIndex index;
+        Result<Bool> r = index.build(framed, max_size);
+        if (!r) return r;
+        const std::span<std::byte> out = bb.extend(index.mraw_size);
+        if (out.size() != index.mraw_size)
+        {
+            bb.clear();
+            return Result<Bool>(W("Framed stream larger than the buffer can grow"));
+        }
+        r = unframe_parallel(framed, index, out);
+        if (!r) bb.clear();
+        return r;
+    }
+}
+
+#endif // FRAMED_IO_HPP
@@ -15,6 +15,8 @@
 #include <iosfwd>   // istream, ostream
 #include <bit>      // endian
 #include <concepts> // std::convertible_to
+#include <atomic>   // atomic_ref
+#include <vector>
 
 namespace pensar_digital
 {
@@ -36,6 +38,11 @@ namespace pensar_digital
       ///
       ///  };
       /// \endcode
+      ///
+      /// Generators are usually shared statics, so drawing ids is thread safe: get_id () is an atomic
+      /// fetch_add on the current value. Threads drawing many ids can take them a block at a time
+      /// with reserve () or get_local_id (), touching the shared value once per block. The value is
+      /// still the plain T in Data, so the BinaryBuffer format is unchanged.
       template <typename Type = Id, typename T = Id>
       class Generator : public Object     
       {
@@ -58,7 +65,32 @@ namespace pensar_digital
           }; // struct Data
           Data mdata;
           static_assert(WireSafe<Data>, "Data must be a WireSafe type");
+          static_assert(std::integral<T> && alignof(T) >= std::atomic_ref<T>::required_alignment, "Generator values must be atomically accessible");
+
+          std::atomic_ref<T> value_ref() const noexcept { return std::atomic_ref<T>(const_cast<T&>(mdata.mvalue)); }
+
+          // Identifies this generator's blocks in get_local_id (): unlike the address, never reused.
+          std::uint64_t mkey = new_key();
+          static std::uint64_t new_key() noexcept
+          {
+              static std::atomic<std::uint64_t> last{ 0 };
+              return last.fetch_add(1, std::memory_order_relaxed) + 1;
+          }
+
           public:
+            /// \brief A block of ids reserved by reserve (): first, first + step, ..., count ids in all.
+            struct IdRange
+            {
+                T mfirst;
+                T mstep;
+                T mcount;
+
+                T operator[] (T i) const noexcept { return mfirst + i * mstep; }
+                bool empty () const noexcept { return mcount == 0; }
+            };
+
+            /// Ids a thread takes at a time in get_local_id ().
+            inline static constexpr T DEFAULT_BLOCK = 1024;
 
             inline static const ClassInfo INFO = { CPPLIB_NAMESPACE, W("Generator"), 2, 1, 1 };
             inline virtual const ClassInfo* info_ptr() const noexcept { return &INFO; }
@@ -66,6 +98,8 @@ namespace pensar_digital
             inline static constexpr size_t DATA_SIZE = sizeof(mdata);
             inline static constexpr size_t      SIZE = DATA_SIZE + sizeof(INFO) + Object::SIZE;
 
+            using Serializer = pd::Serializer<Object, G>;
+
           inline const   pd::Data* generator_data     () const noexcept { return &mdata   ; }
           virtual const pd::Data* data() const noexcept { return &mdata; }
 		  virtual size_t data_size() const noexcept { return DATA_SIZE; }
@@ -78,19 +112,48 @@ namespace pensar_digital
             /// \param [in] astep Step to be used when incrementing the generator, defaults to 1.
             Generator (T aid = null_value<T>(), T initial_value = 0, T step = 1) noexcept : Object(aid == null_value<T>() ? 0 : aid), mdata(initial_value, step) {};
 
+            Generator (const Generator& o) noexcept : Object(o), mdata(o.mdata) {}
+
+            Generator& operator= (const Generator& o) noexcept { Object::operator=(o); mdata = o.mdata; return *this; }
+
             virtual ~Generator () = default;
 
-            /// \brief Increments value and return the new value.
+            /// \brief Increments value and return the new value. Thread safe.
             /// \return The new value.
-            inline virtual T get_id () { mdata.mvalue += mdata.mstep; return mdata.mvalue; }
+            inline virtual T get_id () { return value_ref().fetch_add(mdata.mstep, std::memory_order_relaxed) + mdata.mstep; }
+
+            /// \brief Reserves count consecutive ids with one atomic add, as count get_id () calls would.
+            /// Derived generators that cannot hand the ids out return an empty range.
+            inline virtual IdRange reserve (T count)
+            {
+                const T before = value_ref().fetch_add(mdata.mstep * count, std::memory_order_relaxed);
+                return IdRange{ before + mdata.mstep, mdata.mstep, count };
+            }
+
+            /// \brief An id from the calling thread's block, reserving block more when it runs out.
+            /// Ids are unique across threads but only increase within one thread: other threads'
+            /// blocks interleave, and ids left in a block when its thread exits are never used.
+            inline T get_local_id (T block = DEFAULT_BLOCK)
+            {
+                LocalBlock& b = local_block();
+                if (b.mnext == b.mrange.mcount)
+                {
+                    b = LocalBlock{ reserve(block), 0 };
+                    if (b.mrange.empty()) return null_value<T>();
+                }
+                return b.mrange[b.mnext++];
+            }
 
             /// \brief Gets the next value without incrementing the current one.
             /// \return The next value.
-            inline virtual const T next() { return (mdata.mvalue + mdata.mstep); }
+            inline virtual const T next() { return (current() + mdata.mstep); }
 
             /// \brief Gets the current value.
             /// \return The current value.
-            inline virtual const T current () const { return mdata.mvalue; }
+            inline virtual const T current () const { return value_ref().load(std::memory_order_relaxed); }
+
+            /// \brief Gets the step added by each get_id ().
+            inline T step () const noexcept { return mdata.mstep; }
             
             /// \brief Initialize a Generator.
             /// \param [in] initial_value Initial value for the generator, defaults to 0.
@@ -106,36 +169,31 @@ namespace pensar_digital
             
            inline virtual BinaryBuffer&write (BinaryBuffer& bb) const noexcept
             {
-                // Add Object part
-                Object::write(bb);
-                // Add INFO.bytes and data_bytes together
-                bb.write(INFO.bytes());
-                bb.write(data_bytes());
-                return bb;                  
+                return Serializer::write(*this, bb);
             }
 
             inline virtual BinaryBuffer& read (BinaryBuffer& bb) noexcept
             {
-                // Read Object part
-                Object::read(bb);
+                return Serializer::read(*this, bb);
+            }
 
-                // Read ClassInfo first and verify
-                ClassInfo info;
-                bb.read(std::span<std::byte>((std::byte*)&info, sizeof(ClassInfo)));
-                if (info != INFO)
-                {
-                    LOG(W("ClassInfo mismatch in Generator::read"));
-                    return bb;
-                }
-                // Read data bytes
-                return bb.read(data_wbytes());
+            /// \brief Writes only what changed since baseline, e.g. the value after a few get_id () calls.
+            inline BinaryBuffer& write_delta (const G& baseline, BinaryBuffer& bb) const noexcept
+            {
+                return Serializer::write_delta(*this, baseline, bb);
+            }
+
+            /// \brief Applies a delta written by write_delta. This generator must hold the delta's baseline.
+            inline BinaryBuffer& read_delta (BinaryBuffer& bb) noexcept
+            {
+                return Serializer::read_delta(*this, bb);
             }
            
             /// \brief Create a new Generator using the factory method.
 
             /// \brief Set value. Next call to get will get value + 1.
             /// \param val New value to set
-            inline virtual void set_value(T val) { mdata.mvalue = val; }
+            inline virtual void set_value(T val) { value_ref().store(val, std::memory_order_relaxed); }
 
              void set_id (const T& aid) { Object::set_id (aid); }
 
@@ -162,6 +220,29 @@ namespace pensar_digital
             inline virtual OutStream& write (OutStream& os) const { Object::write(os); return os << mdata.minitial_value
                                                                                                  << mdata.mstep << W(" ")
                                                                                                  << mdata.mvalue; }
+
+          private:
+            struct LocalBlock
+            {
+                IdRange mrange{ 0, 0, 0 };
+                T mnext = 0;
+            };
+
+            // The calling thread's block for this generator. Threads usually draw from one or two
+            // generators, so a short list beats a map; past MAX_LOCAL_BLOCKS the oldest is dropped.
+            inline static constexpr size_t MAX_LOCAL_BLOCKS = 8;
+            LocalBlock& local_block ()
+            {
+                thread_local std::vector<std::pair<std::uint64_t, LocalBlock>> blocks;
+                thread_local size_t oldest = 0;
+                for (auto& [key, block] : blocks)
+                    if (key == mkey) return block;
+                if (blocks.size() < MAX_LOCAL_BLOCKS) return blocks.emplace_back(mkey, LocalBlock{}).second;
+                auto& slot = blocks[oldest];
+                oldest = (oldest + 1) % MAX_LOCAL_BLOCKS;
+                slot = { mkey, LocalBlock{} };
+                return slot.second;
+            }
        }; // class Generator
 
       /// Makes Generator Streamable.
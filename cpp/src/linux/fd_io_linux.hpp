@@ -0,0 +1,10 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#ifndef FD_IO_LINUX_HPP
+#define FD_IO_LINUX_HPP
+
+// Linux uses the shared POSIX implementation.
+#include "../posix/fd_io_posix.hpp"
+
+#endif  // FD_IO_LINUX_HPP
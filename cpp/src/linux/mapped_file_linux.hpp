@@ -0,0 +1,10 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#ifndef MAPPED_FILE_LINUX_HPP
+#define MAPPED_FILE_LINUX_HPP
+
+// Linux uses the shared POSIX implementation.
+#include "../posix/mapped_file_posix.hpp"
+
+#endif  // MAPPED_FILE_LINUX_HPP
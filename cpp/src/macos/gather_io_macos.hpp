@@ -0,0 +1,10 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#ifndef GATHER_IO_MACOS_HPP
+#define GATHER_IO_MACOS_HPP
+
+// macOS uses the shared POSIX implementation.
+#include "../posix/gather_io_posix.hpp"
+
+#endif  // GATHER_IO_MACOS_HPP
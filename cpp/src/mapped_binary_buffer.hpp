@@ -0,0 +1,105 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#ifndef MAPPED_BINARY_BUFFER_HPP_INCLUDED
+#define MAPPED_BINARY_BUFFER_HPP_INCLUDED
+
+#include <span>
+#include <cstddef> // for std::byte
+#include <string_view>
+#include <algorithm> // for std::max
+
+#include "multiplatform.hpp"
+#include "binary_buffer.hpp"
+#include "code_util.hpp"
+
+// Detects and includes the platform-specific MappedFile implementation.
+// #include "linux/mapped_file_linux.hpp", "macos/mapped_file_macos.hpp" or "windows/mapped_file_windows.hpp"
+#include INCLUDE(mapped_file)
+
+namespace pensar_digital
+{
+    namespace cpplib
+    {
+        // ---------------------------------------------------------------------------
+        // Class: MappedBinaryBuffer
+        // ---------------------------------------------------------------------------
+        // A BinaryBuffer whose bytes live in a memory-mapped file instead of the heap.
+        // Opening is O(1) regardless of the file size: pages are faulted in lazily as
+        // they are read, so a multi-GB snapshot costs neither startup time nor a second
+        // copy in RSS. Being a BinaryBuffer, it can be passed to Object::read/write.
+        //
+        // READ_ONLY  : all bytes of the file are readable; writes fail.
+        // READ_WRITE : existing bytes are readable and writes append after them; the file
+        //              grows geometrically and is truncated to size() on close().
+        // ---------------------------------------------------------------------------
+        class MappedBinaryBuffer : public BinaryBuffer
+        {
+            public:
+                using Mode   = MappedFile::Mode;
+                using Advice = MappedFile::Advice;
+
+                inline static constexpr size_t MIN_GROWTH = 1 << 20; //!< Minimum file growth step in READ_WRITE mode.
+
+            private:
+                MappedFile mfile;
+
+                std::span<std::byte> grow_file(size_t min_capacity)
+                {
+                    const size_t new_size = (std::max)({ min_capacity, mfile.size() * 2, MIN_GROWTH });
+                    if (!mfile.resize(new_size)) return {};
+                    return mfile.wbytes();
+                }
+
+            public:
+                MappedBinaryBuffer() : BinaryBuffer(0) {}
+
+                // Attached to this object's own mapping: neither copyable nor movable.
+                MappedBinaryBuffer(const MappedBinaryBuffer&) = delete;
+                MappedBinaryBuffer& operator=(const MappedBinaryBuffer&) = delete;
+
+                ~MappedBinaryBuffer() { close(); }
+
+                /// \brief Maps filename and attaches the buffer to it.
+                /// \param advice Access pattern hint; SEQUENTIAL enables aggressive read-ahead for scans.
+                Result<Bool> open(std::string_view filename, Mode mode = Mode::READ_ONLY, Advice advice = Advice::SEQUENTIAL)
+                {
+                    close();
+                    Result<Bool> r = mfile.open(filename, mode);
+                    if (!r) return r;
+                    mfile.advise(advice);
+                    if (mode == Mode::READ_WRITE)
+                        attach(mfile.wbytes(), mfile.size(), [this](size_t min_capacity) { return grow_file(min_capacity); });
+                    else
+                        attach(mfile.bytes());
+                    return Result<Bool>(Bool::T);
+                }
+
+                /// \brief Hints the access pattern for a byte range (e.g. WILL_NEED before a random lookup).
+                Result<Bool> advise(Advice advice, size_t offset = 0, size_t length = 0) noexcept
+                {
+                    return mfile.advise(advice, offset, length);
+                }
+
+                /// \brief Flushes written bytes to disk.
+                Result<Bool> sync() noexcept { return mfile.sync(); }
+
+                /// \brief Trims the file to the written size (READ_WRITE) and unmaps it.
+                Result<Bool> close()
+                {
+                    Result<Bool> r(Bool::T);
+                    if (mfile.is_open() && mfile.is_writable() && mfile.size() != size())
+                        r = mfile.resize(size());
+                    detach();
+                    mfile.close();
+                    return r;
+                }
+
+                [[nodiscard]] bool is_open() const noexcept { return mfile.is_open(); }
+
+                [[nodiscard]] const MappedFile& file() const noexcept { return mfile; }
+        };
+    } // namespace cpplib
+} // namespace pensar_digital
+
+#endif // MAPPED_BINARY_BUFFER_HPP_INCLUDED
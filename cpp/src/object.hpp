@@ -29,6 +29,7 @@
 #include "concept.hpp"
 #include "class_info.hpp"
 #include "binary_buffer.hpp"
+#include "serializer.hpp"
 
 namespace pensar_digital
 {
@@ -133,6 +134,12 @@ namespace pensar_digital
             inline static constexpr size_t DATA_SIZE = sizeof(mdata);
             inline static constexpr size_t      SIZE = DATA_SIZE + sizeof(ClassInfo);
 
+            /// \brief Members of Data, e.g. the columns of a columnar file (see columnar.hpp).
+            inline static constexpr auto COLUMNS = DATA_COLUMNS(Data, mid);
+
+            /// \brief Binary layout of the hierarchy levels, base first (see Serializer).
+            using Serializer = pd::Serializer<Object>;
+
             virtual const pd::Data* data() const noexcept { return &this->mdata; }
             virtual size_t data_size() const noexcept { return DATA_SIZE; }
             virtual size_t size     () const noexcept { return SIZE     ; }
@@ -158,10 +165,11 @@ namespace pensar_digital
 
             /// Copy constructor
             /// \param other Object to copy from
-            Object(const Object& o) { assign(o); }
+            /// Copies Object's own Data: a virtual data () call on o would see the derived class's.
+            Object(const Object& o) noexcept : mdata(o.mdata) {}
 
             /// Move constructor
-            Object(Object&& o) noexcept { assign(o); }
+            Object(Object&& o) noexcept : mdata(o.mdata) {}
 
             /** Default destructor */
             virtual ~Object() = default;
@@ -182,25 +190,12 @@ namespace pensar_digital
 
             inline virtual BinaryBuffer& write (BinaryBuffer& bb) const noexcept
             {
-                // Add INFO.bytes and data_bytes together
-                bb.write (INFO.bytes () );
-                bb.write (std::span<const std::byte>((const std::byte*)&mdata, DATA_SIZE));
-                return bb;                  
+                return Serializer::write (*this, bb);
             }
 
             inline virtual BinaryBuffer& read (BinaryBuffer& bb) noexcept
             {
-                // Read ClassInfo first and verify
-                ClassInfo info;
-                bb.read(std::span<std::byte>((std::byte*)&info, sizeof(ClassInfo)));
-                if (info != INFO)
-                {
-                    LOG(W("ClassInfo mismatch in Object::read"));
-                    return bb;
-                }
-                // Read data bytes
-                auto byte_span = ByteSpan((std::byte*)(&mdata), DATA_SIZE);
-               return bb.read(byte_span);
+                return Serializer::read (*this, bb);
             }
                        
             inline virtual std::string sclass_name() const
@@ -268,10 +263,11 @@ namespace pensar_digital
             /// Assignment operator
             /// \param o Object to assign from
             /// \return A reference to this
-            inline Object& operator=(const Object& o) noexcept { return assign(o); }
+            /// Assigns Object's own Data, as the copy constructor: derived levels assign theirs.
+            inline Object& operator=(const Object& o) noexcept { mdata = o.mdata; return *this; }
 
             /// Move assignment operator
-            inline Object& operator=(Object&& o) noexcept { return assign(o); }
+            inline Object& operator=(Object&& o) noexcept { mdata = o.mdata; return *this; }
 
             static inline Factory::P  get(const Data& data = NULL_DATA)
             {
@@ -0,0 +1,46 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <atomic>
+#include <future>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+
+namespace pensar_digital::cpplib
+{
+    // Number of worker threads to use when the caller passes 0.
+    inline unsigned default_threads() noexcept
+    {
+        const unsigned n = std::thread::hardware_concurrency();
+        return n > 0 ? n : 1;
+    }
+
+    // Calls f(i) for every i in [0, n) on up to threads threads (0: one per core), the
+    // calling thread included. Indices are handed out one at a time, so blocks of uneven
+    // cost balance themselves. f must not throw.
+    template <typename F>
+    void parallel_for(size_t n, unsigned threads, F&& f)
+    {
+        if (threads == 0) threads = default_threads();
+        const size_t workers = (std::min)(n, static_cast<size_t>(threads));
+        if (workers <= 1)
+        {
+            for (size_t i = 0; i < n; ++i) f(i);
+            return;
+        }
+        std::atomic<size_t> next{ 0 };
+        auto work = [&]() { for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < n; ) f(i); };
+        std::vector<std::future<void>> others;
+        others.reserve(workers - 1);
+        for (size_t t = 1; t < workers; ++t) others.push_back(std::async(std::launch::async, work));
+        work();
+        for (std::future<void>& o : others) o.wait();
+    }
+}
+
+#endif // PARALLEL_HPP
@@ -0,0 +1,195 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#ifndef PERSISTENT_GENERATOR_HPP
+#define PERSISTENT_GENERATOR_HPP
+
+#include <mutex>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string_view>
+
+#include "multiplatform.hpp"
+#include "generator.hpp"
+#include "crc32c.hpp"
+#include "code_util.hpp"
+
+// #include "linux/mapped_file_linux.hpp", "macos/mapped_file_macos.hpp" or "windows/mapped_file_windows.hpp"
+#include INCLUDE(mapped_file)
+
+namespace pensar_digital::cpplib
+{
+    // ------------------------------------------------------------
+    // PersistentGenerator
+    // ------------------------------------------------------------
+    // A Generator whose ids are never handed out twice, even across a crash. Ids are
+    // still drawn in memory (an atomic add); what is made durable is a high-water mark a
+    // chunk of ids ahead of the current value, synced to a small mapped file once per
+    // chunk. An id is returned only when the mark on disk covers it, so after a restart
+    // the generator resumes from the mark: a crash skips at most a chunk of ids.
+    //
+    // The mark is written to two slots, alternately, each on its own page and checked by
+    // a sequence number and a CRC32C. A write torn by a crash spoils only the slot being
+    // written, whose ids were not yet handed out, so the other one is a valid mark.
+    //
+    // The step must be positive. When the mark cannot be written (or the file is not
+    // open) get_id () returns null_value<T> (), reserve () an empty range, and error ()
+    // tells why; like BinaryBuffer, the error sticks until clear_error ().
+    template <typename Type = Id, typename T = Id>
+    class PersistentGenerator : public Generator<Type, T>
+    {
+        public:
+            using G       = Generator<Type, T>;
+            using IdRange = typename G::IdRange;
+
+            inline static constexpr T DEFAULT_CHUNK = 4096;           //!< Ids made durable by each sync.
+            inline static constexpr std::uint64_t MAGIC = 0x4e45475344505044ull; // "DPPDSGEN"
+
+        private:
+            struct Slot
+            {
+                std::uint64_t mmagic;
+                std::uint64_t mseq;
+                T             mlimit;
+                T             mstep;
+                std::uint32_t mcrc;   //!< CRC32C of the fields above.
+            };
+            // One page per slot, so a torn page write cannot reach the other slot.
+            inline static constexpr size_t SLOT_STRIDE = 4096;
+            inline static constexpr size_t FILE_SIZE   = 2 * SLOT_STRIDE;
+
+            MappedFile     mfile;
+            std::mutex     mmutex;     // Serializes mark writes.
+            std::atomic<T> mlimit{ 0 }; // Ids up to here are covered by the mark on disk.
+            std::uint64_t  mseq   = 0;
+            T              mchunk = DEFAULT_CHUNK;
+            Result<Bool>   merror = Result<Bool>(Bool::T);
+
+            static std::uint32_t slot_crc(const Slot& s) noexcept
+            {
+                return crc32c(std::span<const std::byte>(reinterpret_cast<const std::byte*>(&s), offsetof(Slot, mcrc)));
+            }
+
+            // The slot at index i, if it holds a mark.
+            std::optional<Slot> load_slot(size_t i) const noexcept
+            {
+                Slot s;
+                std::memcpy(&s, mfile.bytes().data() + i * SLOT_STRIDE, sizeof(Slot));
+                if (s.mmagic != MAGIC || s.mcrc != slot_crc(s)) return std::nullopt;
+                return s;
+            }
+
+            Result<Bool> store_mark(T limit)
+            {
+                Slot s{};
+                s.mmagic = MAGIC;
+                s.mseq   = mseq + 1;
+                s.mlimit = limit;
+                s.mstep  = this->step();
+                s.mcrc   = slot_crc(s);
+                std::memcpy(mfile.wbytes().data() + (s.mseq % 2) * SLOT_STRIDE, &s, sizeof(Slot));
+                Result<Bool> r = mfile.sync();
+                if (r) mseq = s.mseq;
+                return r;
+            }
+
+            // True when id is covered by the mark, moving the mark a chunk past it if not.
+            bool covered(T id)
+            {
+                if (id <= mlimit.load(std::memory_order_acquire)) return true;
+                std::lock_guard lock(mmutex);
+                if (id <= mlimit.load(std::memory_order_relaxed)) return true; // Moved meanwhile.
+                if (!merror) return false;
+                if (!mfile.is_open())
+                {
+                    merror = Result<Bool>(W("PersistentGenerator is not open"));
+                    return false;
+                }
+                const T limit = id + mchunk * this->step();
+                if (Result<Bool> r = store_mark(limit); !r)
+                {
+                    merror = r;
+                    return false;
+                }
+                mlimit.store(limit, std::memory_order_release);
+                return true;
+            }
+
+        public:
+            /// \brief As Generator: the ids continue from initial_value unless open () finds a mark.
+            PersistentGenerator(T aid = null_value<T>(), T initial_value = 0, T step = 1) noexcept : G(aid, initial_value, step) {}
+
+            // Owns the file: neither copyable nor movable.
+            PersistentGenerator(const PersistentGenerator&) = delete;
+            PersistentGenerator& operator=(const PersistentGenerator&) = delete;
+
+            ~PersistentGenerator() { close(); }
+
+            /// \brief Opens (or creates) the mark file and resumes after the mark it holds.
+            /// \param chunk Ids made durable by each sync: larger means fewer syncs and more ids
+            /// skipped by a crash.
+            Result<Bool> open(std::string_view filename, T chunk = DEFAULT_CHUNK)
+            {
+                close();
+                if (this->step() <= 0) return Result<Bool>(W("PersistentGenerator needs a positive step"));
+                if (chunk <= 0) return Result<Bool>(W("PersistentGenerator needs a positive chunk"));
+                Result<Bool> r = mfile.open(filename, MappedFile::Mode::READ_WRITE, FILE_SIZE);
+                if (!r) return r;
+                if (mfile.size() < FILE_SIZE)
+                {
+                    mfile.close();
+                    return Result<Bool>(W("PersistentGenerator file is too small"));
+                }
+
+                std::optional<Slot> mark = load_slot(0);
+                if (std::optional<Slot> other = load_slot(1); other && (!mark || other->mseq > mark->mseq)) mark = other;
+                mseq = mark ? mark->mseq : 0;
+                if (mark && mark->mlimit > this->current()) this->set_value(mark->mlimit);
+                mlimit.store(this->current(), std::memory_order_release);
+                mchunk = chunk;
+                merror = Result<Bool>(Bool::T);
+                return merror;
+            }
+
+            /// \brief Records the current value as the mark, so a clean shutdown skips no ids,
+            /// and closes the file. Call it when no thread is drawing ids.
+            Result<Bool> close()
+            {
+                if (!mfile.is_open()) return Result<Bool>(Bool::T);
+                Result<Bool> r(Bool::T);
+                if (merror && this->current() < mlimit.load(std::memory_order_relaxed))
+                    r = store_mark(this->current());
+                mfile.close();
+                mlimit.store(0, std::memory_order_relaxed);
+                return r;
+            }
+
+            [[nodiscard]] bool is_open() const noexcept { return mfile.is_open(); }
+
+            /// \brief Ids up to this value are covered by the mark on disk.
+            [[nodiscard]] T durable_limit() const noexcept { return mlimit.load(std::memory_order_acquire); }
+
+            [[nodiscard]] const Result<Bool>& error() const noexcept { return merror; }
+            void clear_error() { std::lock_guard lock(mmutex); merror = Result<Bool>(Bool::T); }
+
+            /// \brief As Generator::get_id (), or null_value<T> () if the id cannot be made durable.
+            inline T get_id() override
+            {
+                const T id = G::get_id();
+                return covered(id) ? id : null_value<T>();
+            }
+
+            /// \brief As Generator::reserve (), or an empty range if the ids cannot be made durable.
+            inline IdRange reserve(T count) override
+            {
+                const IdRange r = G::reserve(count);
+                if (r.empty() || covered(r[count - 1])) return r;
+                return IdRange{ 0, 0, 0 };
+            }
+    };
+}
+
+#endif // PERSISTENT_GENERATOR_HPP
@@ -0,0 +1,79 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#ifndef FD_IO_POSIX_HPP
+#define FD_IO_POSIX_HPP
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <cerrno>
+#include <cstddef>   // std::byte
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "../code_util.hpp"
+
+namespace pensar_digital
+{
+    namespace cpplib
+    {
+        enum class FdMode { READ, WRITE, APPEND };
+
+        /// \brief Opens filename and returns its file descriptor.
+        /// \param mode WRITE creates or truncates the file, APPEND creates it or writes at its end.
+        inline Result<int> open_fd(std::string_view filename, FdMode mode)
+        {
+            int flags = O_RDONLY;
+            if (mode == FdMode::WRITE ) flags = O_WRONLY | O_CREAT | O_TRUNC;
+            if (mode == FdMode::APPEND) flags = O_WRONLY | O_CREAT | O_APPEND;
+            const int fd = ::open(std::string(filename).c_str(), flags | O_CLOEXEC, 0644);
+            if (fd < 0) return Result<int>(W("Failed to open file"), -1);
+            return Result<int>(fd);
+        }
+
+        inline Result<Bool> close_fd(int fd) noexcept
+        {
+            if (::close(fd) != 0) return Result<Bool>(W("Failed to close file"));
+            return Result<Bool>(Bool::T);
+        }
+
+        /// \brief Writes all bytes to fd. Partial writes and EINTR are retried.
+        inline Result<Bool> write_all(int fd, std::span<const std::byte> bytes) noexcept
+        {
+            while (!bytes.empty())
+            {
+                const ssize_t n = ::write(fd, bytes.data(), bytes.size());
+                if (n < 0)
+                {
+                    if (errno == EINTR) continue;
+                    return Result<Bool>(W("write failed"));
+                }
+                bytes = bytes.subspan(static_cast<size_t>(n));
+            }
+            return Result<Bool>(Bool::T);
+        }
+
+        /// \brief Reads up to dest.size () bytes from fd, retrying short reads until dest is
+        /// full or the end of the file is reached. Returns the number of bytes read.
+        inline Result<size_t> read_fill(int fd, std::span<std::byte> dest) noexcept
+        {
+            size_t total = 0;
+            while (total < dest.size())
+            {
+                const ssize_t n = ::read(fd, dest.data() + total, dest.size() - total);
+                if (n < 0)
+                {
+                    if (errno == EINTR) continue;
+                    return Result<size_t>(W("read failed"), total);
+                }
+                if (n == 0) break; // End of file.
+                total += static_cast<size_t>(n);
+            }
+            return Result<size_t>(total);
+        }
+    }   // namespace cpplib
+}       // namespace pensar_digital
+
+#endif  // FD_IO_POSIX_HPP
@@ -0,0 +1,82 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#ifndef GATHER_IO_POSIX_HPP
+#define GATHER_IO_POSIX_HPP
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm> // std::min
+#include <cerrno>
+#include <cstddef>   // std::byte
+
+#include <climits>   // IOV_MAX
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "../code_util.hpp"
+
+namespace pensar_digital
+{
+    namespace cpplib
+    {
+#ifdef IOV_MAX
+        inline constexpr size_t GATHER_MAX_PARTS = IOV_MAX;
+#else
+        inline constexpr size_t GATHER_MAX_PARTS = 1024;
+#endif
+
+        /// \brief Writes all parts, in order, to the file descriptor fd with writev (one system call
+        /// per GATHER_MAX_PARTS parts). Partial writes and EINTR are retried.
+        inline Result<Bool> write_gather(int fd, std::span<const std::span<const std::byte>> parts)
+        {
+            std::vector<iovec> iov;
+            iov.reserve((std::min)(parts.size(), GATHER_MAX_PARTS));
+            size_t part   = 0; // First part not completely written.
+            size_t offset = 0; // Bytes of parts[part] already written.
+            while (part < parts.size())
+            {
+                iov.clear();
+                for (size_t i = part; i < parts.size() && iov.size() < GATHER_MAX_PARTS; ++i)
+                {
+                    const size_t skip = (i == part) ? offset : 0;
+                    if (parts[i].size() > skip)
+                        iov.push_back({ const_cast<std::byte*>(parts[i].data()) + skip, parts[i].size() - skip });
+                }
+                if (iov.empty()) break;
+
+                const ssize_t n = ::writev(fd, iov.data(), static_cast<int>(iov.size()));
+                if (n < 0)
+                {
+                    if (errno == EINTR) continue;
+                    return Result<Bool>(W("writev failed"));
+                }
+
+                size_t left = static_cast<size_t>(n);
+                while (part < parts.size() && left >= parts[part].size() - offset)
+                {
+                    left -= parts[part].size() - offset;
+                    offset = 0;
+                    ++part;
+                }
+                offset += left;
+            }
+            return Result<Bool>(Bool::T);
+        }
+
+        /// \brief Creates (or truncates) filename and writes all parts to it with write_gather.
+        inline Result<Bool> save_gather(std::string_view filename, std::span<const std::span<const std::byte>> parts)
+        {
+            const int fd = ::open(std::string(filename).c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            if (fd < 0) return Result<Bool>(W("Failed to open file for writing"));
+            Result<Bool> r = write_gather(fd, parts);
+            if (::close(fd) != 0 && r) return Result<Bool>(W("Failed to close file"));
+            return r;
+        }
+    }   // namespace cpplib
+}       // namespace pensar_digital
+
+#endif  // GATHER_IO_POSIX_HPP
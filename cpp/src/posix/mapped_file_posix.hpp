@@ -0,0 +1,201 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#ifndef MAPPED_FILE_POSIX_HPP
+#define MAPPED_FILE_POSIX_HPP
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>   // std::exchange
+#include <cstddef>   // std::byte
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../code_util.hpp"
+
+namespace pensar_digital
+{
+    namespace cpplib
+    {
+        // MappedFile: a file mapped into memory with mmap (Linux and macOS). Pages are loaded lazily on first access.
+        class MappedFile
+        {
+            public:
+                enum class Mode   { READ_ONLY, READ_WRITE };
+                enum class Advice { NORMAL, SEQUENTIAL, RANDOM, WILL_NEED, DONT_NEED };
+
+            private:
+                int         mfd   = -1;
+                std::byte*  mdata = nullptr;
+                size_t      msize = 0;
+                Mode        mmode = Mode::READ_ONLY;
+
+                // Maps the first size bytes of the file; MAP_FAILED on failure.
+                void* map_view(size_t size) const noexcept
+                {
+                    const int prot = (mmode == Mode::READ_WRITE) ? (PROT_READ | PROT_WRITE) : PROT_READ;
+                    return ::mmap(nullptr, size, prot, MAP_SHARED, mfd, 0);
+                }
+
+                Result<Bool> map(size_t size)
+                {
+                    msize = size;
+                    if (size == 0) return Result<Bool>(Bool::T); // mmap rejects empty mappings.
+                    void* p = map_view(size);
+                    if (p == MAP_FAILED)
+                    {
+                        msize = 0;
+                        return Result<Bool>(W("mmap failed"));
+                    }
+                    mdata = static_cast<std::byte*>(p);
+                    return Result<Bool>(Bool::T);
+                }
+
+            public:
+                MappedFile() noexcept = default;
+                MappedFile(const MappedFile&) = delete;
+                MappedFile& operator=(const MappedFile&) = delete;
+
+                MappedFile(MappedFile&& o) noexcept
+                    : mfd(std::exchange(o.mfd, -1)), mdata(std::exchange(o.mdata, nullptr)),
+                      msize(std::exchange(o.msize, 0)), mmode(o.mmode) {}
+
+                MappedFile& operator=(MappedFile&& o) noexcept
+                {
+                    if (this != &o)
+                    {
+                        close();
+                        mfd   = std::exchange(o.mfd, -1);
+                        mdata = std::exchange(o.mdata, nullptr);
+                        msize = std::exchange(o.msize, 0);
+                        mmode = o.mmode;
+                    }
+                    return *this;
+                }
+
+                ~MappedFile() { close(); }
+
+                /// \brief Maps filename into memory.
+                /// \param mode READ_WRITE creates the file if it does not exist.
+                /// \param min_size In READ_WRITE mode the file is extended to at least this size.
+                Result<Bool> open(std::string_view filename, Mode mode = Mode::READ_ONLY, size_t min_size = 0)
+                {
+                    close();
+                    mmode = mode;
+                    const int flags = (mode == Mode::READ_WRITE) ? (O_RDWR | O_CREAT) : O_RDONLY;
+                    mfd = ::open(std::string(filename).c_str(), flags | O_CLOEXEC, 0644);
+                    if (mfd < 0) return Result<Bool>(W("Failed to open file for mapping"));
+
+                    struct stat st;
+                    if (::fstat(mfd, &st) != 0)
+                    {
+                        close();
+                        return Result<Bool>(W("Could not determine file size"));
+                    }
+                    size_t size = static_cast<size_t>(st.st_size);
+                    if ((mode == Mode::READ_WRITE) && (size < min_size))
+                    {
+                        if (::ftruncate(mfd, static_cast<off_t>(min_size)) != 0)
+                        {
+                            close();
+                            return Result<Bool>(W("Failed to extend mapped file"));
+                        }
+                        size = min_size;
+                    }
+                    Result<Bool> r = map(size);
+                    if (!r) close();
+                    return r;
+                }
+
+                /// \brief Changes the file size and remaps it (READ_WRITE only). The mapping may move.
+                /// On failure the old mapping is left intact.
+                Result<Bool> resize(size_t new_size)
+                {
+                    if (mfd < 0 || mmode != Mode::READ_WRITE) return Result<Bool>(W("File is not mapped for writing"));
+                    // Grow the file before mapping past its old end, shrink it only once the tail is unmapped.
+                    const bool grow = (mdata == nullptr) || (new_size > msize);
+                    if (grow && ::ftruncate(mfd, static_cast<off_t>(new_size)) != 0) return Result<Bool>(W("Failed to resize mapped file"));
+                    if (mdata == nullptr) return map(new_size);
+                    if (new_size == 0)
+                    {
+                        ::munmap(mdata, msize);
+                        mdata = nullptr;
+                        msize = 0;
+                    }
+                    else
+                    {
+#ifdef __APPLE__
+                        // macOS has no mremap: map the new size before unmapping the old view.
+                        void* p = map_view(new_size);
+                        if (p != MAP_FAILED) ::munmap(mdata, msize);
+#else
+                        void* p = ::mremap(mdata, msize, new_size, MREMAP_MAYMOVE);
+#endif
+                        if (p == MAP_FAILED) return Result<Bool>(W("Remapping the file failed"));
+                        mdata = static_cast<std::byte*>(p);
+                        msize = new_size;
+                    }
+                    if (!grow && ::ftruncate(mfd, static_cast<off_t>(new_size)) != 0) return Result<Bool>(W("Failed to resize mapped file"));
+                    return Result<Bool>(Bool::T);
+                }
+
+                /// \brief Hints the kernel about the expected access pattern for [offset, offset + length).
+                /// A length of 0 means up to the end of the mapping.
+                Result<Bool> advise(Advice advice, size_t offset = 0, size_t length = 0) noexcept
+                {
+                    if (mdata == nullptr || offset >= msize) return Result<Bool>(Bool::T);
+                    if (length == 0 || offset + length > msize) length = msize - offset;
+                    // madvise requires a page aligned address.
+                    const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+                    const size_t aligned = offset - (offset % page);
+                    int native = MADV_NORMAL;
+                    switch (advice)
+                    {
+                        case Advice::NORMAL:     native = MADV_NORMAL    ; break;
+                        case Advice::SEQUENTIAL: native = MADV_SEQUENTIAL; break;
+                        case Advice::RANDOM:     native = MADV_RANDOM    ; break;
+                        case Advice::WILL_NEED:  native = MADV_WILLNEED  ; break;
+                        case Advice::DONT_NEED:  native = MADV_DONTNEED  ; break;
+                    }
+                    if (::madvise(mdata + aligned, length + (offset - aligned), native) != 0)
+                        return Result<Bool>(W("madvise failed"));
+                    return Result<Bool>(Bool::T);
+                }
+
+                /// \brief Flushes modified pages to disk (blocking).
+                /// On macOS msync and fsync stop at the drive's cache; F_FULLFSYNC flushes it too.
+                Result<Bool> sync() noexcept
+                {
+                    if (mdata == nullptr || mmode != Mode::READ_WRITE) return Result<Bool>(Bool::T);
+                    if (::msync(mdata, msize, MS_SYNC) != 0) return Result<Bool>(W("msync failed"));
+#ifdef __APPLE__
+                    // Some file systems (e.g. network ones) do not support it: fsync is the best left.
+                    if (::fcntl(mfd, F_FULLFSYNC) != 0 && ::fsync(mfd) != 0) return Result<Bool>(W("fsync failed"));
+#endif
+                    return Result<Bool>(Bool::T);
+                }
+
+                void close() noexcept
+                {
+                    if (mdata != nullptr) ::munmap(mdata, msize);
+                    if (mfd >= 0) ::close(mfd);
+                    mdata = nullptr;
+                    msize = 0;
+                    mfd = -1;
+                }
+
+                [[nodiscard]] bool   is_open     () const noexcept { return mfd >= 0; }
+                [[nodiscard]] bool   is_writable () const noexcept { return mmode == Mode::READ_WRITE; }
+                [[nodiscard]] size_t size        () const noexcept { return msize; }
+
+                [[nodiscard]] std::span<      std::byte> wbytes()       noexcept { return { mdata, msize }; }
+                [[nodiscard]] std::span<const std::byte> bytes () const noexcept { return { mdata, msize }; }
+        };
+    }   // namespace cpplib
+}       // namespace pensar_digital
+
+#endif  // MAPPED_FILE_POSIX_HPP
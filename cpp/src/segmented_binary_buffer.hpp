@@ -0,0 +1,374 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#ifndef SEGMENTED_BINARY_BUFFER_HPP_INCLUDED
+#define SEGMENTED_BINARY_BUFFER_HPP_INCLUDED
+
+#include <span>
+#include <vector>
+#include <memory>    // std::unique_ptr
+#include <mutex>
+#include <cstring>   // std::memcpy
+#include <cstddef>   // std::byte
+#include <algorithm> // std::min
+#include <string_view>
+#include <type_traits>
+
+#include "multiplatform.hpp"
+#include "binary_buffer.hpp"
+#include "code_util.hpp"
+
+// Detects and includes the platform-specific scatter/gather writes.
+// #include "linux/gather_io_linux.hpp", "macos/gather_io_macos.hpp" or "windows/gather_io_windows.hpp"
+#include INCLUDE(gather_io)
+
+namespace pensar_digital
+{
+    namespace cpplib
+    {
+        // ---------------------------------------------------------------------------
+        // Class: SegmentPool
+        // ---------------------------------------------------------------------------
+        // Recycles the fixed-size segments used by SegmentedBinaryBuffer, so batch exports
+        // that create and drop buffers do not hit the allocator for every segment.
+        // Thread safe; at most max_free released segments are kept.
+        // ---------------------------------------------------------------------------
+        class SegmentPool
+        {
+            public:
+                inline static constexpr size_t DEFAULT_SEGMENT_SIZE = 64 * 1024;
+                inline static constexpr size_t DEFAULT_MAX_FREE     = 256;
+
+                using Segment = std::unique_ptr<std::byte[]>;
+
+            private:
+                size_t               msegment_size;
+                size_t               mmax_free;
+                std::vector<Segment> mfree;
+                mutable std::mutex   mmutex;
+
+            public:
+                explicit SegmentPool(size_t segment_size = DEFAULT_SEGMENT_SIZE, size_t max_free = DEFAULT_MAX_FREE)
+                    : msegment_size(segment_size > 0 ? segment_size : DEFAULT_SEGMENT_SIZE), mmax_free(max_free) {}
+
+                SegmentPool(const SegmentPool&) = delete;
+                SegmentPool& operator=(const SegmentPool&) = delete;
+
+                /// \brief Returns a segment of segment_size() bytes (contents unspecified).
+                [[nodiscard]] Segment acquire()
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(mmutex);
+                        if (!mfree.empty())
+                        {
+                            Segment s = std::move(mfree.back());
+                            mfree.pop_back();
+                            return s;
+                        }
+                    }
+                    return std::make_unique_for_overwrite<std::byte[]>(msegment_size);
+                }
+
+                /// \brief Gives a segment obtained from acquire() back to the pool.
+                void release(Segment s)
+                {
+                    if (!s) return;
+                    std::lock_guard<std::mutex> lock(mmutex);
+                    if (mfree.size() < mmax_free) mfree.push_back(std::move(s));
+                }
+
+                [[nodiscard]] size_t segment_size() const noexcept { return msegment_size; }
+
+                [[nodiscard]] size_t free_count() const
+                {
+                    std::lock_guard<std::mutex> lock(mmutex);
+                    return mfree.size();
+                }
+
+                /// \brief Process wide pool of DEFAULT_SEGMENT_SIZE segments.
+                static SegmentPool& default_pool()
+                {
+                    static SegmentPool pool;
+                    return pool;
+                }
+        };
+
+        // ---------------------------------------------------------------------------
+        // Class: SegmentedBinaryBuffer
+        // ---------------------------------------------------------------------------
+        // A binary buffer made of a chain (rope) of fixed-size segments taken from a
+        // SegmentPool. Growing appends a segment: bytes already written are never copied,
+        // so serializing a huge CompositeCommand tree or a batch export costs no
+        // multi-hundred-MB reallocations.
+        //
+        // Objects are written and read through an internal BinaryBuffer attached as a
+        // sink/source to the current segment, so any BinaryBufferIO type works unchanged
+        // and values may straddle segment boundaries. Reads continue transparently in the
+        // next segment; only a value that straddles a boundary is copied (to a small
+        // staging area) for a BinaryBufferIO read.
+        //
+        // segments() exports the written bytes as a gather list for write_gather (writev).
+        // ---------------------------------------------------------------------------
+        class SegmentedBinaryBuffer
+        {
+            private:
+                SegmentPool*                      mpool;
+                size_t                            msegment_size;
+                std::vector<SegmentPool::Segment> msegments;    // All but the last are full.
+                BinaryBuffer                      mwriter;      // Sink over the last segment.
+                BinaryBuffer                      mreader;      // Source used by BinaryBufferIO reads.
+                size_t                            mread_pos     = 0;
+                size_t                            mwindow_start = 0; // Position of mreader's window.
+                std::vector<std::byte>            mstaging;     // Window for values that straddle segments.
+
+                // Spill callback: the last segment is full, continue in a new one.
+                std::span<std::byte> next_segment(std::span<const std::byte>, size_t)
+                {
+                    msegments.push_back(mpool->acquire());
+                    return { msegments.back().get(), msegment_size };
+                }
+
+                // Refill callback: next window for mreader, starting at the first unread byte.
+                std::span<const std::byte> window(size_t consumed, size_t min_bytes)
+                {
+                    const size_t pos = mwindow_start + consumed;
+                    mwindow_start = pos;
+                    const size_t total = size();
+                    if (pos >= total) return {};
+
+                    const size_t seg = pos / msegment_size;
+                    const size_t off = pos % msegment_size;
+                    const size_t available = (std::min)(msegment_size - off, total - pos);
+                    if (available >= min_bytes) return { msegments[seg].get() + off, available };
+
+                    // The value straddles a boundary: stage exactly the bytes it needs.
+                    mstaging.resize((std::min)(min_bytes, total - pos));
+                    copy_out(pos, mstaging);
+                    return mstaging;
+                }
+
+                // Copies dest.size () bytes starting at pos into dest.
+                void copy_out(size_t pos, std::span<std::byte> dest) const noexcept
+                {
+                    while (!dest.empty())
+                    {
+                        const size_t off = pos % msegment_size;
+                        const size_t n = (std::min)(dest.size(), msegment_size - off);
+                        std::memcpy(dest.data(), msegments[pos / msegment_size].get() + off, n);
+                        dest = dest.subspan(n);
+                        pos += n;
+                    }
+                }
+
+                // Runs f on mreader attached as a source at the read position.
+                template <typename F>
+                void read_source(F&& f)
+                {
+                    if (!mreader.ok()) return;
+                    mwindow_start = mread_pos;
+                    mreader.attach_source(window(0, 0), [this](size_t consumed, size_t min_bytes) { return window(consumed, min_bytes); });
+                    f(mreader);
+                    mread_pos = mwindow_start + (mreader.size() - mreader.remaining());
+                    mreader.detach();
+                }
+
+                void attach_writer()
+                {
+                    mwriter.attach_sink({}, [this](std::span<const std::byte> written, size_t min_capacity) { return next_segment(written, min_capacity); });
+                }
+
+            public:
+                explicit SegmentedBinaryBuffer(SegmentPool& pool = SegmentPool::default_pool())
+                    : mpool(&pool), msegment_size(pool.segment_size()), mwriter(0), mreader(0)
+                {
+                    attach_writer();
+                }
+
+                // The internal buffers call back into this object: neither copyable nor movable.
+                SegmentedBinaryBuffer(const SegmentedBinaryBuffer&) = delete;
+                SegmentedBinaryBuffer& operator=(const SegmentedBinaryBuffer&) = delete;
+
+                ~SegmentedBinaryBuffer() { release_segments(); }
+
+                [[nodiscard]] size_t size() const noexcept
+                {
+                    return msegments.empty() ? 0 : (msegments.size() - 1) * msegment_size + mwriter.size();
+                }
+
+                // Number of bytes written but not yet read.
+                [[nodiscard]] size_t remaining() const noexcept { return size() - mread_pos; }
+
+                [[nodiscard]] size_t segment_size () const noexcept { return msegment_size; }
+                [[nodiscard]] size_t segment_count() const noexcept { return msegments.size(); }
+
+                // Compact integers mode (see BinaryBuffer::set_compact_integers).
+                void set_compact_integers(bool on) noexcept
+                {
+                    mwriter.set_compact_integers(on);
+                    mreader.set_compact_integers(on);
+                }
+                [[nodiscard]] bool compact_integers() const noexcept { return mwriter.compact_integers(); }
+
+                // Compact types mode (see BinaryBuffer::set_compact_types). Writer and reader
+                // keep their own type table, rebuilt by the reader as it goes.
+                void set_compact_types(bool on)
+                {
+                    mwriter.set_compact_types(on);
+                    mreader.set_compact_types(on);
+                }
+                [[nodiscard]] bool compact_types() const noexcept { return mwriter.compact_types(); }
+
+                // --- Errors (sticky, see BinaryBuffer) ---
+
+                [[nodiscard]] bool ok() const noexcept { return mwriter.ok() && mreader.ok(); }
+                [[nodiscard]] BufferError error() const noexcept { return mwriter.ok() ? mreader.error() : mwriter.error(); }
+                [[nodiscard]] Result<Bool> status() const { return mwriter.ok() ? mreader.status() : mwriter.status(); }
+
+                void clear_error() noexcept
+                {
+                    mwriter.clear_error();
+                    mreader.clear_error();
+                }
+
+                // Gives all segments back to the pool.
+                void clear()
+                {
+                    release_segments();
+                    mread_pos = 0;
+                    clear_error();
+                    if (compact_types())
+                    {
+                        // New stream: types are defined again on first use.
+                        set_compact_types(false);
+                        set_compact_types(true);
+                    }
+                }
+
+                // Restarts reading from the beginning, keeping the written bytes.
+                void rewind()
+                {
+                    mread_pos = 0;
+                    if (mreader.compact_types())
+                    {
+                        mreader.set_compact_types(false); // The reader meets the type definitions again.
+                        mreader.set_compact_types(true);
+                    }
+                }
+
+                // Written bytes as a gather list, one span per segment. The spans stay
+                // valid until the buffer is cleared or destroyed (writes never move them).
+                [[nodiscard]] std::vector<std::span<const std::byte>> segments() const
+                {
+                    std::vector<std::span<const std::byte>> parts;
+                    parts.reserve(msegments.size());
+                    const size_t total = size();
+                    for (size_t i = 0; i < msegments.size(); ++i)
+                        parts.emplace_back(msegments[i].get(), (std::min)(msegment_size, total - i * msegment_size));
+                    return parts;
+                }
+
+                // Save the whole buffer to disk with a single gather write per IOV_MAX segments.
+                Result<Bool> save_to_file(std::string_view filename) const
+                {
+                    return save_gather(filename, segments());
+                }
+
+                // ======================================================================
+                // WRITE METHODS
+                // ======================================================================
+
+                SegmentedBinaryBuffer& write(std::span<const std::byte> src)
+                {
+                    mwriter.write(src);
+                    return *this;
+                }
+
+                // Write any object that satisfies BinaryBufferIO
+                template <BinaryBufferIO T>
+                SegmentedBinaryBuffer& write(const T& obj)
+                {
+                    obj.write(mwriter);
+                    return *this;
+                }
+
+                // Trivial types (int, float, etc.)
+                template <typename T>
+                SegmentedBinaryBuffer& write(const T& pod)
+                    requires std::is_trivially_copyable_v<T> && (!BinaryBufferIO<T>) &&
+                             (!std::is_same_v<std::remove_cvref_t<T>, std::span<std::byte>>) &&
+                             (!std::is_same_v<std::remove_cvref_t<T>, std::span<const std::byte>>)
+                {
+                    mwriter.write(pod);
+                    return *this;
+                }
+
+                // ======================================================================
+                // READ METHODS
+                // ======================================================================
+
+                // Copies the next dest.size () bytes, crossing segment boundaries as needed.
+                SegmentedBinaryBuffer& read(std::span<std::byte> dest)
+                {
+                    if (!mreader.ok()) return *this;
+                    if (dest.size() > remaining())
+                    {
+                        mreader.fail(BufferError::READ_UNDERFLOW);
+                        return *this;
+                    }
+                    copy_out(mread_pos, dest);
+                    mread_pos += dest.size();
+                    return *this;
+                }
+
+                // Read into a BinarySerializable object
+                template <BinaryBufferIO T>
+                SegmentedBinaryBuffer& read(T& obj)
+                {
+                    read_source([&obj](BinaryBuffer& bb) { obj.read(bb); });
+                    return *this;
+                }
+
+                // Read into a trivial type (int, float, etc.)
+                template <typename T>
+                SegmentedBinaryBuffer& read(T& pod)
+                    requires std::is_trivially_copyable_v<T> && (!BinaryBufferIO<T>) &&
+                             (!std::is_same_v<std::remove_cvref_t<T>, std::span<std::byte>>) &&
+                             (!std::is_same_v<std::remove_cvref_t<T>, std::span<const std::byte>>)
+                {
+                    if constexpr (std::is_integral_v<T>)
+                    {
+                        if (compact_integers())
+                        {
+                            read_source([&pod](BinaryBuffer& bb) { bb.read(pod); });
+                            return *this;
+                        }
+                    }
+                    return read(std::as_writable_bytes(std::span{ &pod, 1 }));
+                }
+
+                // Advances the read position by n bytes without copying them.
+                SegmentedBinaryBuffer& skip(size_t n)
+                {
+                    if (!mreader.ok()) return *this;
+                    if (n > remaining())
+                    {
+                        mreader.fail(BufferError::READ_UNDERFLOW);
+                        return *this;
+                    }
+                    mread_pos += n;
+                    return *this;
+                }
+
+            private:
+                void release_segments()
+                {
+                    mreader.detach();
+                    for (SegmentPool::Segment& s : msegments) mpool->release(std::move(s));
+                    msegments.clear();
+                    attach_writer();
+                }
+        };
+    } // namespace cpplib
+} // namespace pensar_digital
+
+#endif // SEGMENTED_BINARY_BUFFER_HPP_INCLUDED
@@ -0,0 +1,188 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#ifndef SERIALIZER_HPP
+#define SERIALIZER_HPP
+
+#include <span>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring> // std::memcpy
+#include <concepts>
+#include <type_traits>
+
+#include "constant.hpp"   // Data
+#include "concept.hpp"    // StdLayoutTriviallyCopyableNoPadding
+#include "s.hpp"
+#include "equal.hpp"
+#include "binary_buffer.hpp"
+#include "class_info.hpp"
+#include "crc32c.hpp"
+#include "delta.hpp"
+
+namespace pensar_digital::cpplib
+{
+    // ------------------------------------------------------------
+    // Concept: SerializableLevel
+    // ------------------------------------------------------------
+    // A class adding one level to an Object hierarchy: its own INFO and a Data struct
+    // (mdata) returned by its data () and sized DATA_SIZE.
+    template <class L>
+    concept SerializableLevel = HasClassInfo<L> &&
+        StdLayoutTriviallyCopyableNoPadding<typename L::DataType> &&
+        (L::DATA_SIZE == sizeof(typename L::DataType)) &&
+        requires (const L& l) { { l.L::data() } -> std::convertible_to<const Data*>; };
+
+    // ------------------------------------------------------------
+    // Serializer
+    // ------------------------------------------------------------
+    // Writes and reads a class hierarchy from its Data levels, base first, e.g.
+    // Serializer<Object, Command>. Each level is its type tag (see ClassInfo::write_tag)
+    // followed by its Data with a single copy. Levels are expanded at compile time and
+    // each level's data is reached through a qualified, hence non-virtual, data () call.
+    //
+    // The byte layout is the one the hand-written write/read chains produced, so
+    // streams written before are read unchanged.
+    //
+    // write_delta/read_delta send only what changed against a baseline the reader holds,
+    // e.g. for replication or audit streams. A delta is the most derived level's type tag,
+    // the CRC32C of the baseline's Data levels, then runs of changed bytes over the levels
+    // taken as one block: (unchanged bytes skipped, run length) varints followed by the
+    // run's new bytes, ended by a (0, 0) pair.
+    template <class... Levels>
+    struct Serializer
+    {
+        // Record size without compact type tags.
+        static constexpr size_t SIZE = ((sizeof(ClassInfo) + Levels::DATA_SIZE) + ... + 0);
+        // Size of the Data levels alone, the block a delta patches.
+        static constexpr size_t DATA_SIZE = (Levels::DATA_SIZE + ... + 0);
+        // The most derived level, whose tag identifies a delta.
+        using Last = typename decltype((std::type_identity<Levels>{}, ...))::type;
+
+        template <class T>
+            requires (std::derived_from<T, Levels> && ...)
+        static BinaryBuffer& write(const T& o, BinaryBuffer& bb) noexcept
+        {
+            static_assert((SerializableLevel<Levels> && ...), "Every level needs INFO, DataType, DATA_SIZE and data ().");
+            (write_level<Levels>(o, bb), ...);
+            return bb;
+        }
+
+        template <class T>
+            requires (std::derived_from<T, Levels> && ...)
+        static BinaryBuffer& read(T& o, BinaryBuffer& bb) noexcept
+        {
+            static_assert((SerializableLevel<Levels> && ...), "Every level needs INFO, DataType, DATA_SIZE and data ().");
+            // The record size is fixed without compact type tags: one bounds check for all levels.
+            if (!bb.compact_types() && !bb.ensure(SIZE)) return bb;
+            (read_level<Levels>(o, bb) && ...);
+            return bb;
+        }
+
+        // Writes what changed in o since baseline, an earlier state of the same object.
+        template <class T>
+            requires (std::derived_from<T, Levels> && ...)
+        static BinaryBuffer& write_delta(const T& o, const T& baseline, BinaryBuffer& bb) noexcept
+        {
+            Last::INFO.write_tag(bb);
+            std::uint32_t crc = 0;
+            ((crc = crc32c(level_bytes<Levels>(baseline), crc)), ...);
+            bb.write(crc);
+            size_t offset = 0, last_end = 0;
+            (write_level_delta<Levels>(o, baseline, bb, offset, last_end), ...);
+            bb.write_varint(size_t{ 0 });
+            bb.write_varint(size_t{ 0 });
+            return bb;
+        }
+
+        // Applies a delta written by write_delta to o, which must hold the delta's baseline.
+        // A delta for another class, another baseline (CRC mismatch) or running past the
+        // record fails with INVALID_DATA. o is unchanged unless the whole delta applies.
+        template <class T>
+            requires (std::derived_from<T, Levels> && ...)
+        static BinaryBuffer& read_delta(T& o, BinaryBuffer& bb) noexcept
+        {
+            if (!Last::INFO.read_tag(bb)) return bb;
+            std::uint32_t crc = 0;
+            if (!bb.read(crc).ok()) return bb;
+            std::array<std::byte, DATA_SIZE> block;
+            size_t offset = 0;
+            ((std::memcpy(block.data() + offset, level_bytes<Levels>(o).data(), Levels::DATA_SIZE), offset += Levels::DATA_SIZE), ...);
+            if (crc32c(block) != crc)
+            {
+                bb.fail(BufferError::INVALID_DATA);
+                return bb;
+            }
+            size_t pos = 0;
+            for (;;)
+            {
+                size_t skip = 0, length = 0;
+                if (!bb.read_varint(skip).read_varint(length).ok()) return bb;
+                if (length == 0)
+                {
+                    if (skip != 0) bb.fail(BufferError::INVALID_DATA);
+                    break;
+                }
+                if (skip > DATA_SIZE - pos || length > DATA_SIZE - pos - skip)
+                {
+                    bb.fail(BufferError::INVALID_DATA);
+                    return bb;
+                }
+                pos += skip;
+                if (!bb.read(std::span<std::byte>(block.data() + pos, length)).ok()) return bb;
+                pos += length;
+            }
+            if (!bb.ok()) return bb;
+            offset = 0;
+            ((std::memcpy(level_wbytes<Levels>(o).data(), block.data() + offset, Levels::DATA_SIZE), offset += Levels::DATA_SIZE), ...);
+            return bb;
+        }
+
+    private:
+        template <class L>
+        static std::span<const std::byte> level_bytes(const L& o) noexcept
+        {
+            return std::span<const std::byte>(reinterpret_cast<const std::byte*>(o.L::data()), L::DATA_SIZE);
+        }
+
+        template <class L>
+        static std::span<std::byte> level_wbytes(L& o) noexcept
+        {
+            // data () const is the accessor every level has; the object itself is not const.
+            return std::span<std::byte>(const_cast<std::byte*>(reinterpret_cast<const std::byte*>(static_cast<const L&>(o).L::data())), L::DATA_SIZE);
+        }
+
+        // Runs of one level, offsets continuing across levels; a run never spans two.
+        template <class L>
+        static void write_level_delta(const L& o, const L& baseline, BinaryBuffer& bb, size_t& offset, size_t& last_end) noexcept
+        {
+            const std::span<const std::byte> current = level_bytes<L>(o);
+            delta::for_each_run(current, level_bytes<L>(baseline), [&](size_t at, size_t length)
+            {
+                bb.write_varint(offset + at - last_end);
+                bb.write_varint(length);
+                bb.write(current.subspan(at, length));
+                last_end = offset + at + length;
+            });
+            offset += L::DATA_SIZE;
+        }
+
+        template <class L>
+        static void write_level(const L& o, BinaryBuffer& bb) noexcept
+        {
+            L::INFO.write_tag(bb);
+            bb.write(level_bytes<L>(o));
+        }
+
+        template <class L>
+        static bool read_level(L& o, BinaryBuffer& bb) noexcept
+        {
+            if (!L::INFO.read_tag(bb, L::DATA_SIZE)) return false;
+            bb.read_unchecked(level_wbytes<L>(o));
+            return true;
+        }
+    };
+}
+
+#endif // SERIALIZER_HPP
@@ -0,0 +1,330 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include <span>
+#include <vector>
+#include <cstdio>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <string_view>
+#include <type_traits>
+
+#include "frame.hpp"       // LEUInt*
+#include "crc32c.hpp"
+#include "parallel.hpp"
+#include "compression.hpp"
+#include "binary_buffer.hpp"
+#include "mapped_binary_buffer.hpp"
+#include "code_util.hpp"   // Result
+
+namespace pensar_digital::cpplib
+{
+    // ------------------------------------------------------------
+    // Snapshot
+    // ------------------------------------------------------------
+    // A collection of objects saved as independent shards, so both saving and loading
+    // run on every core:
+    //
+    //   SnapshotHeader | shard 0 | shard 1 | ... | SnapshotShard[shards] | SnapshotFooter
+    //
+    // A shard is the usual write(BinaryBuffer&) of a contiguous range of the collection,
+    // compressed as one block (compression.hpp) when a codec is set. The index at the end
+    // gives the position, size, object count and CRC32C of each shard; the footer, at a
+    // fixed distance from the end of the file, gives the position of the index. Loading
+    // maps the file, then verifies, decompresses and reads the shards in parallel, each
+    // into its own range of the output. All fields are little endian.
+
+    struct SnapshotHeader
+    {
+        char     mmagic[4] = { 'P', 'D', 'S', 'N' };
+        LEUInt16 mversion{ 1 };
+        LEUInt16 mflags{ 0 };      //!< Codec in the low byte, COMPACT_TYPES.
+
+        inline static constexpr std::uint16_t COMPACT_TYPES = 0x100;
+
+        [[nodiscard]] Codec codec() const noexcept { return static_cast<Codec>(mflags.value() & 0xFF); }
+        [[nodiscard]] bool compact_types() const noexcept { return (mflags.value() & COMPACT_TYPES) != 0; }
+    };
+    static_assert(WireSafe<SnapshotHeader> && sizeof(SnapshotHeader) == 8);
+
+    struct SnapshotShard
+    {
+        LEUInt64 moffset{ 0 };     //!< Position of the shard in the file.
+        LEUInt64 msize{ 0 };       //!< Stored size.
+        LEUInt64 mraw_size{ 0 };   //!< Serialized size, before compression.
+        LEUInt64 mcount{ 0 };      //!< Objects in the shard.
+        LEUInt32 mcrc{ 0 };        //!< CRC32C of the stored bytes.
+        LEUInt32 mreserved{ 0 };
+    };
+    static_assert(WireSafe<SnapshotShard> && sizeof(SnapshotShard) == 40);
+
+    struct SnapshotFooter
+    {
+        LEUInt64 mindex_offset{ 0 };
+        LEUInt64 mobject_count{ 0 };
+        LEUInt32 mshard_count{ 0 };
+        LEUInt32 mindex_crc{ 0 };  //!< CRC32C of the index.
+        LEUInt32 mcrc{ 0 };        //!< CRC32C of the fields above.
+        char     mmagic[4] = { 'P', 'D', 'S', 'N' };
+
+        [[nodiscard]] std::uint32_t checksum() const noexcept
+        {
+            return crc32c(std::as_bytes(std::span<const SnapshotFooter>(this, 1)).first(offsetof(SnapshotFooter, mcrc)));
+        }
+    };
+    static_assert(WireSafe<SnapshotFooter> && sizeof(SnapshotFooter) == 32);
+
+    struct SnapshotOptions
+    {
+        Codec    mcodec         = Codec::NONE;
+        bool     mcompact_types = false; //!< Type tags once per shard (see BinaryBuffer::set_compact_types).
+        size_t   mshard_objects = 0;     //!< Objects per shard; 0: four shards per thread.
+        unsigned mthreads       = 0;     //!< 0: one per core.
+    };
+
+    namespace snapshot_detail
+    {
+        // Elements may be objects or (smart) pointers to objects.
+        template <typename E>
+        decltype(auto) object(E& e) noexcept
+        {
+            if constexpr (requires { *e; }) return (*e);
+            else return (e);
+        }
+    }
+
+    // Saves objects to filename, serializing the shards on several threads. Elements are
+    // objects or (smart) pointers to objects with write(BinaryBuffer&) const.
+    template <typename E>
+    Result<Bool> save_snapshot(std::string_view filename, std::span<const E> objects, const SnapshotOptions& options = {})
+    {
+        const unsigned threads = options.mthreads == 0 ? default_threads() : options.mthreads;
+        const size_t per_shard = options.mshard_objects > 0 ? options.mshard_objects :
+            (std::max)(size_t{ 1 }, (objects.size() + threads * 4 - 1) / (threads * 4));
+        const size_t shards = (objects.size() + per_shard - 1) / per_shard;
+
+        SnapshotHeader header;
+        header.mflags = static_cast<std::uint16_t>(static_cast<std::uint16_t>(options.mcodec) | (options.mcompact_types ? SnapshotHeader::COMPACT_TYPES : 0));
+
+        std::vector<std::vector<std::byte>> stored(shards);
+        std::vector<SnapshotShard> index(shards);
+        std::vector<Result<Bool>> results(shards, Result<Bool>(Bool::T));
+        parallel_for(shards, threads, [&](size_t s)
+        {
+            const std::span<const E> range = objects.subspan(s * per_shard, (std::min)(per_shard, objects.size() - s * per_shard));
+            BinaryBuffer bb;
+            bb.set_compact_types(options.mcompact_types);
+            for (const E& e : range) snapshot_detail::object(e).write(bb);
+            if (!bb.status()) { results[s] = bb.status(); return; }
+            index[s].mraw_size = bb.size();
+            index[s].mcount = range.size();
+            if (options.mcodec == Codec::NONE)
+                stored[s].assign(bb.data().begin(), bb.data().end());
+            else if (bb.size() > UINT32_MAX)
+            {
+                results[s] = Result<Bool>(W("Snapshot shard too large to compress: use smaller shards"));
+                return;
+            }
+            else
+            {
+                stored[s].resize(compress_bound(bb.size()));
+                stored[s].resize(compress_block(options.mcodec, bb.data(), stored[s]));
+            }
+            index[s].msize = stored[s].size();
+            index[s].mcrc = crc32c(stored[s]);
+        });
+        for (const Result<Bool>& r : results)
+            if (!r) return r;
+
+        SnapshotFooter footer;
+        std::uint64_t offset = sizeof(header);
+        for (SnapshotShard& shard : index)
+        {
+            shard.moffset = offset;
+            offset += shard.msize.value();
+        }
+        footer.mindex_offset = offset;
+        footer.mobject_count = objects.size();
+        footer.mshard_count = static_cast<std::uint32_t>(shards);
+        footer.mindex_crc = crc32c(std::as_bytes(std::span<const SnapshotShard>(index)));
+        footer.mcrc = footer.checksum();
+
+        FILE* f = fopen(std::string(filename).c_str(), "wb");
+        if (!f) return Result<Bool>(W("Failed to open file for writing"));
+        bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+        for (size_t s = 0; ok && s < shards; ++s)
+            ok = stored[s].empty() || fwrite(stored[s].data(), 1, stored[s].size(), f) == stored[s].size();
+        ok = ok && (index.empty() || fwrite(index.data(), sizeof(SnapshotShard), index.size(), f) == index.size());
+        ok = ok && fwrite(&footer, sizeof(footer), 1, f) == 1;
+        ok = (fclose(f) == 0) && ok;
+        if (!ok) return Result<Bool>(W("Failed to write all bytes to disk"));
+        return Result<Bool>(Bool::T);
+    }
+
+    template <typename E>
+    Result<Bool> save_snapshot(std::string_view filename, const std::vector<E>& objects, const SnapshotOptions& options = {})
+    {
+        return save_snapshot(filename, std::span<const E>(objects), options);
+    }
+
+    // ---------------------------------------------------------------------------
+    // Class: SnapshotReader
+    // ---------------------------------------------------------------------------
+    // Maps a snapshot and checks its footer and index on open(); load() verifies and
+    // reads the shards in parallel.
+    // ---------------------------------------------------------------------------
+    class SnapshotReader
+    {
+        MappedBinaryBuffer         mfile;
+        SnapshotHeader             mheader;
+        SnapshotFooter             mfooter;
+        std::vector<SnapshotShard> mindex;
+
+        // Stored bytes of shard s, after checking its checksum.
+        Result<Bool> stored(size_t s, std::span<const std::byte>& bytes) const
+        {
+            bytes = mfile.data().subspan(mindex[s].moffset.value(), mindex[s].msize.value());
+            if (crc32c(bytes) != mindex[s].mcrc.value()) return Result<Bool>(W("Snapshot shard checksum mismatch"));
+            return Result<Bool>(Bool::T);
+        }
+
+    public:
+        SnapshotReader() = default;
+        SnapshotReader(const SnapshotReader&) = delete;
+        SnapshotReader& operator=(const SnapshotReader&) = delete;
+
+        Result<Bool> open(std::string_view filename)
+        {
+            mindex.clear();
+            Result<Bool> r = mfile.open(filename, MappedBinaryBuffer::Mode::READ_ONLY, MappedBinaryBuffer::Advice::WILL_NEED);
+            if (!r) return r;
+            const std::span<const std::byte> file = mfile.data();
+            if (file.size() < sizeof(mheader) + sizeof(mfooter)) return Result<Bool>(W("Truncated snapshot"));
+            std::memcpy(&mheader, file.data(), sizeof(mheader));
+            std::memcpy(&mfooter, file.data() + file.size() - sizeof(mfooter), sizeof(mfooter));
+            if (std::memcmp(mheader.mmagic, "PDSN", 4) != 0 || std::memcmp(mfooter.mmagic, "PDSN", 4) != 0)
+                return Result<Bool>(W("Not a snapshot"));
+            if (mheader.mversion.value() != 1) return Result<Bool>(W("Unsupported snapshot version"));
+            if (!valid_codec(static_cast<std::uint8_t>(mheader.codec()))) return Result<Bool>(W("Unknown snapshot codec"));
+            if (mfooter.mcrc.value() != mfooter.checksum()) return Result<Bool>(W("Snapshot footer checksum mismatch"));
+
+            const std::uint64_t index_offset = mfooter.mindex_offset.value();
+            const std::uint64_t index_size = std::uint64_t{ mfooter.mshard_count.value() } * sizeof(SnapshotShard);
+            // The footer CRC is not a guard against a crafted footer: compare without adding,
+            // so an offset near 2^64 cannot wrap onto the expected end of the index.
+            const std::uint64_t index_end = file.size() - sizeof(mfooter);
+            if (index_size > index_end - sizeof(mheader) || index_offset != index_end - index_size)
+                return Result<Bool>(W("Invalid snapshot index"));
+            mindex.resize(mfooter.mshard_count.value());
+            if (index_size > 0) std::memcpy(mindex.data(), file.data() + index_offset, index_size);
+            if (crc32c(std::as_bytes(std::span<const SnapshotShard>(mindex))) != mfooter.mindex_crc.value())
+            {
+                mindex.clear();
+                return Result<Bool>(W("Snapshot index checksum mismatch"));
+            }
+            std::uint64_t objects = 0;
+            for (const SnapshotShard& s : mindex)
+            {
+                // The sizes and counts bound what load allocates, so they are checked against the
+                // stored bytes: a compressed block carries a 32-bit raw size and decodes to at most
+                // max_block_raw_size of itself, a stored one is its raw bytes, and every record
+                // writes at least its type tag.
+                const bool compressed = mheader.codec() != Codec::NONE;
+                if (s.moffset.value() < sizeof(mheader) || s.moffset.value() > index_offset || s.msize.value() > index_offset - s.moffset.value()
+                    || (compressed && (s.mraw_size.value() > UINT32_MAX || s.mraw_size.value() > max_block_raw_size(s.msize.value())))
+                    || (!compressed && s.mraw_size.value() != s.msize.value())
+                    || s.mcount.value() > s.mraw_size.value())
+                {
+                    mindex.clear();
+                    return Result<Bool>(W("Invalid snapshot index"));
+                }
+                // Compare without adding, so crafted counts cannot wrap onto the footer total.
+                if (s.mcount.value() > mfooter.mobject_count.value() - objects)
+                {
+                    mindex.clear();
+                    return Result<Bool>(W("Snapshot object count mismatch"));
+                }
+                objects += s.mcount.value();
+            }
+            if (objects != mfooter.mobject_count.value())
+            {
+                mindex.clear();
+                return Result<Bool>(W("Snapshot object count mismatch"));
+            }
+            return Result<Bool>(Bool::T);
+        }
+
+        [[nodiscard]] size_t object_count() const noexcept { return mindex.empty() ? 0 : mfooter.mobject_count.value(); }
+        [[nodiscard]] size_t shard_count() const noexcept { return mindex.size(); }
+        [[nodiscard]] const SnapshotShard& shard(size_t s) const noexcept { return mindex[s]; }
+        [[nodiscard]] Codec codec() const noexcept { return mheader.codec(); }
+
+        // Reads every object into out, resized to object_count() default constructed
+        // elements, calling read(BinaryBuffer&, E&) once per element on up to threads
+        // threads (0: one per core). read must construct pointer elements, e.g. through
+        // CommandRegistry::read_create; the default calls e.read(bb).
+        template <typename E, typename Read>
+        Result<Bool> load(std::vector<E>& out, unsigned threads, Read&& read) const
+        {
+            out.clear();
+            out.resize(object_count());
+            std::vector<size_t> first(mindex.size() + 1, 0);
+            for (size_t s = 0; s < mindex.size(); ++s) first[s + 1] = first[s] + mindex[s].mcount.value();
+
+            std::vector<Result<Bool>> results(mindex.size(), Result<Bool>(Bool::T));
+            parallel_for(mindex.size(), threads, [&](size_t s)
+            {
+                std::span<const std::byte> bytes;
+                if (Result<Bool> r = stored(s, bytes); !r) { results[s] = r; return; }
+                std::vector<std::byte> raw;
+                if (mheader.codec() != Codec::NONE)
+                {
+                    raw.resize(mindex[s].mraw_size.value());
+                    Result<size_t> n = decompress_block(bytes, raw);
+                    if (!n || n.mresult != raw.size())
+                    {
+                        results[s] = n ? Result<Bool>(W("Snapshot shard size mismatch")) : Result<Bool>(n.merror_message, Bool::F);
+                        return;
+                    }
+                    bytes = raw;
+                }
+                BinaryBuffer bb(0);
+                bb.attach(bytes);
+                bb.set_compact_types(mheader.compact_types());
+                for (size_t i = first[s]; i < first[s + 1] && bb.status(); ++i) read(bb, out[i]);
+                if (!bb.status()) results[s] = bb.status();
+                else if (bb.remaining() != 0) results[s] = Result<Bool>(W("Snapshot shard has trailing bytes"));
+            });
+            for (const Result<Bool>& r : results)
+                if (!r)
+                {
+                    out.clear();
+                    return r;
+                }
+            return Result<Bool>(Bool::T);
+        }
+
+        template <typename E>
+        Result<Bool> load(std::vector<E>& out, unsigned threads = 0) const
+        {
+            return load(out, threads, [](BinaryBuffer& bb, E& e) { e.read(bb); });
+        }
+    };
+
+    // Opens filename and loads its objects into out (see SnapshotReader::load).
+    template <typename E>
+    Result<Bool> load_snapshot(std::string_view filename, std::vector<E>& out, unsigned threads = 0)
+    {
+        SnapshotReader reader;
+        Result<Bool> r = reader.open(filename);
+        if (!r) return r;
+        return reader.load(out, threads);
+    }
+}
+
+#endif // SNAPSHOT_HPP
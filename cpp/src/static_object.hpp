@@ -0,0 +1,177 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#ifndef STATIC_OBJECT_HPP
+#define STATIC_OBJECT_HPP
+
+#include <memory>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#include "object.hpp"
+#include "constant.hpp"
+#include "s.hpp"
+#include "class_info.hpp"
+#include "binary_buffer.hpp"
+#include "serializer.hpp"
+
+namespace pensar_digital
+{
+    namespace cpplib
+    {
+        // ------------------------------------------------------------
+        // StaticObject
+        // ------------------------------------------------------------
+        // Object without virtual functions, for hot containers of small objects. A class
+        // derives from StaticObject<itself> (CRTP) and follows the Object recipe (Data,
+        // DataType, DATA_SIZE, SIZE, INFO, data (), Serializer) with neither virtual nor
+        // override: what Object dispatches through the vtable (info_ptr, size, equals,
+        // write, read) is resolved against Derived at compile time and can be inlined.
+        //
+        // The base level is Object::DataType tagged as Object, so a static class writes the
+        // bytes of a dynamic one with the same levels and each reads the other's records.
+        // Without a vptr, a Derived with trivially copyable Data is trivially copyable: a
+        // vector of them is the packed Data levels, copied with memcpy.
+        //
+        // data () and data_size () are per level, as a qualified Object::data () call:
+        // Derived declares its own for its level. Where an Object is needed, e.g. an
+        // Object::Ptr container, wrap the value in an ObjectAdapter.
+        //
+        // \code
+        // class Point : public StaticObject<Point>
+        // {
+        //     public:
+        //         struct Data : public pd::Data { std::int64_t mx, my; };
+        //         using DataType = Data;
+        //         inline static const ClassInfo INFO = { CPPLIB_NAMESPACE, W("Point"), 1, 1, 1 };
+        //         inline static constexpr size_t DATA_SIZE = sizeof(Data);
+        //         inline static constexpr size_t      SIZE = DATA_SIZE + sizeof(ClassInfo) + StaticObject::SIZE;
+        //         using Serializer = pd::Serializer<StaticObject<Point>, Point>;
+        //
+        //         const pd::Data* data() const noexcept { return &mdata; }
+        //         size_t data_size() const noexcept { return DATA_SIZE; }
+        //     private:
+        //         Data mdata;
+        // };
+        // \endcode
+        template <class Derived>
+        class StaticObject
+        {
+            public:
+                using DataType = Object::DataType;
+
+                // Same bytes as Object::INFO: both hierarchies write the same Object level.
+                inline static const ClassInfo INFO = { CPPLIB_NAMESPACE, W("Object"), 1, 1, 1 };
+                inline static constexpr size_t DATA_SIZE = sizeof(DataType);
+                inline static constexpr size_t      SIZE = DATA_SIZE + sizeof(ClassInfo);
+
+                /// \brief Binary layout of a class adding no level; Derived declares its own.
+                using Serializer = pd::Serializer<StaticObject>;
+
+            private:
+                DataType mdata;
+
+                const Derived& self() const noexcept { return static_cast<const Derived&>(*this); }
+                      Derived& self()       noexcept { return static_cast<      Derived&>(*this); }
+
+            protected:
+                StaticObject(const DataType& data = Object::NULL_DATA) noexcept : mdata(data) {}
+
+                // Defaulted, so a Derived with trivially copyable Data stays trivially copyable.
+                StaticObject(const StaticObject&) noexcept = default;
+                StaticObject& operator=(const StaticObject&) noexcept = default;
+                ~StaticObject() = default;
+
+                void set_id(const Id& value) noexcept { mdata.mid = value; }
+
+            public:
+                const pd::Data* data() const noexcept { return &mdata; }
+                size_t data_size() const noexcept { return DATA_SIZE; }
+
+                const ClassInfo* info_ptr() const noexcept { return &Derived::INFO; }
+                size_t size() const noexcept { return Derived::SIZE; }
+
+                const Id id() const noexcept { return mdata.mid; }
+                const Hash hash() const noexcept { return mdata.mid; }
+
+                /// \brief As Object::equals: the hashes, then the most derived Data level.
+                bool equals(const Derived& o) const noexcept
+                {
+                    const Derived& s = self();
+                    if (&s == &o) return true;
+                    if (s.hash() != o.hash()) return false;
+                    return std::memcmp(s.data(), o.data(), Derived::DATA_SIZE) == 0;
+                }
+
+                BinaryBuffer& write(BinaryBuffer& bb) const noexcept { return Derived::Serializer::write(self(), bb); }
+                BinaryBuffer& read (BinaryBuffer& bb)       noexcept { return Derived::Serializer::read (self(), bb); }
+
+                S to_string() const noexcept { return pd::to_string(mdata.mid); }
+
+                OutStream& write(OutStream& os) const { return os << self().id(); }
+
+                friend bool operator==(const Derived& a, const Derived& b) noexcept { return a.equals(b); }
+        };
+
+        // ------------------------------------------------------------
+        // ObjectAdapter
+        // ------------------------------------------------------------
+        // A StaticObject value behind the virtual Object interface, for code written against
+        // Object (Object::Ptr containers, a BinaryBuffer of mixed records). Calls forward to
+        // the value, so an adapter reads, writes and compares as the value does; its Object
+        // level follows the value's id.
+        template <class Derived>
+            requires std::derived_from<Derived, StaticObject<Derived>>
+        class ObjectAdapter : public Object
+        {
+            private:
+                Derived mvalue;
+
+            public:
+                using Ptr = std::shared_ptr<ObjectAdapter>;
+
+                ObjectAdapter(const Derived& value = Derived()) noexcept : Object(Object::DataType(value.id())), mvalue(value) {}
+
+                virtual ~ObjectAdapter() = default;
+
+                const Derived& value() const noexcept { return mvalue; }
+                void set_value(const Derived& value) noexcept { mvalue = value; set_id(mvalue.id()); }
+
+                const ClassInfo* info_ptr() const noexcept override { return &Derived::INFO; }
+                const pd::Data* data() const noexcept override { return mvalue.data(); }
+                size_t data_size() const noexcept override { return Derived::DATA_SIZE; }
+                size_t size() const noexcept override { return Derived::SIZE; }
+
+                const Id   id  () const noexcept override { return mvalue.id  (); }
+                const Hash hash() const noexcept override { return mvalue.hash(); }
+
+                bool equals(const Object& o) const noexcept override
+                {
+                    const ObjectAdapter* other = dynamic_cast<const ObjectAdapter*>(&o);
+                    return (other != nullptr) && mvalue.equals(other->mvalue);
+                }
+
+                BinaryBuffer& write(BinaryBuffer& bb) const noexcept override { return mvalue.write(bb); }
+
+                BinaryBuffer& read(BinaryBuffer& bb) noexcept override
+                {
+                    mvalue.read(bb);
+                    set_id(mvalue.id());
+                    return bb;
+                }
+
+                using Object::write;
+                using Object::read;
+        };
+
+        /// \brief A copy of value as a dynamic Object.
+        template <class Derived>
+        inline Object::Ptr make_object(const Derived& value)
+        {
+            return std::make_shared<ObjectAdapter<Derived>>(value);
+        }
+    }   // namespace cpplib
+}       // namespace pensar_digital
+
+#endif  // STATIC_OBJECT_HPP
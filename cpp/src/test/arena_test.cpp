@@ -0,0 +1,205 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "../arena.hpp"
+#include "../command.hpp"
+
+#include <vector>
+#include <cstdint>
+
+namespace pensar_digital::cpplib
+{
+    inline static int arena_test_alive = 0;
+
+    struct ArenaTracked
+    {
+        int mvalue;
+        ArenaTracked(int value) : mvalue(value) { ++arena_test_alive; }
+        ~ArenaTracked() { --arena_test_alive; }
+    };
+
+    TEST_CASE("MonotonicArena", "[arena]")
+    {
+        arena_test_alive = 0;
+        {
+            MonotonicArena arena(1024);
+            INFO("0. empty"); CHECK((arena.used() == 0 && arena.chunk_count() == 0));
+
+            struct alignas(64) Wide { std::byte b[64]; };
+            int* i = arena.create<int>(7);
+            Wide* w = arena.create<Wide>();
+            INFO("1. values"); CHECK(*i == 7);
+            INFO("2. alignment"); CHECK(reinterpret_cast<uintptr_t>(w) % 64 == 0);
+            INFO("3. trivial types need no finalizer"); CHECK(arena.finalizer_count() == 0);
+
+            std::vector<ArenaTracked*> tracked;
+            for (int k = 0; k < 1000; ++k) tracked.push_back(arena.create<ArenaTracked>(k));
+            INFO("4. constructed"); CHECK(arena_test_alive == 1000);
+            INFO("5. finalizers"); CHECK(arena.finalizer_count() == 1000);
+            INFO("6. grew"); CHECK(arena.chunk_count() > 1);
+            bool intact = true;
+            for (int k = 0; k < 1000; ++k) intact = intact && tracked[k]->mvalue == k;
+            INFO("7. objects do not overlap"); CHECK(intact);
+
+            const size_t capacity = arena.capacity();
+            arena.release();
+            INFO("8. release destroys"); CHECK(arena_test_alive == 0);
+            INFO("9. release keeps one chunk"); CHECK(arena.chunk_count() == 1);
+            INFO("10. rewound"); CHECK(arena.used() == 0);
+            INFO("11. kept the largest"); CHECK((arena.capacity() > 0 && arena.capacity() <= capacity));
+
+            // A second round of the same size fits the kept chunk or grows once.
+            for (int k = 0; k < 1000; ++k) arena.create<ArenaTracked>(k);
+            INFO("12. reused"); CHECK(arena.chunk_count() <= 2);
+
+            void* big = arena.allocate(1 << 20, 16);
+            INFO("13. oversized request"); CHECK((big != nullptr && reinterpret_cast<uintptr_t>(big) % 16 == 0));
+        }
+        INFO("14. destructor destroys"); CHECK(arena_test_alive == 0);
+    }
+
+    TEST_CASE("CommandArenaRead", "[arena]")
+    {
+        // Three levels: the root owns plain and nested composites.
+        CompositeCommand root;
+        for (int k = 0; k < 3; ++k) root.add(new NullCommand());
+        CompositeCommand* nested = new CompositeCommand();
+        nested->add(new NullCommand());
+        nested->add(new NullCommand());
+        root.add(nested);
+
+        for (bool compact : { false, true })
+        {
+            BinaryBuffer bb;
+            bb.set_compact_types(compact);
+            root.write(bb);
+
+            MonotonicArena arena;
+            for (int round = 0; round < 3; ++round)
+            {
+                bb.rewind();
+                Command* back = CommandRegistry::read_command(bb, arena);
+                INFO("0. read, compact " << compact); REQUIRE(back != nullptr);
+                INFO("1. consumed"); CHECK((bb.ok() && bb.remaining() == 0));
+                INFO("2. equal"); CHECK(back->equals(root));
+                INFO("3. every command in the arena"); CHECK(arena.finalizer_count() == 7);
+                arena.release();
+            }
+
+            // A heap composite reading into the arena does not delete the arena's commands.
+            CompositeCommand holder;
+            holder.add(new NullCommand());
+            bb.rewind();
+            INFO("4. own tag"); CHECK(CompositeCommand::INFO.read_tag(bb));
+            holder.read(bb, arena);
+            INFO("5. holder equal"); CHECK(holder.equals(root));
+
+            // Its commands are the arena's now: adding a heap command would leak it.
+            NullCommand extra;
+            bool rejected = false;
+            try { holder.add(&extra); }
+            catch (const Error&) { rejected = true; }
+            INFO("6. add rejected"); CHECK(rejected);
+        }
+    }
+
+    TEST_CASE("CommandArenaPooled", "[arena]")
+    {
+        // One slot, so the second get reuses the object the first released.
+        ConcurrentPoolFactory<CompositeCommand, Id> pool(1, 1, NULL_ID);
+        const CompositeCommand* first = nullptr;
+        MonotonicArena arena;
+        {
+            CompositeCommand source;
+            source.add(new NullCommand());
+            BinaryBuffer bb;
+            source.write(bb);
+            REQUIRE(CompositeCommand::INFO.read_tag(bb));
+
+            CompositeCommand::Ptr c = pool.get(5);
+            first = c.get();
+            c->add(new NullCommand());
+            c->read(bb, arena);
+            REQUIRE(bb.ok());
+        }
+        arena.release();
+
+        CompositeCommand::Ptr again = pool.get(6);
+        INFO("0. reused"); REQUIRE(again.get() == first);
+        INFO("1. no commands left from the last use"); CHECK(again->size() == CompositeCommand(6).size());
+        bool added = true;
+        try { again->add(new NullCommand()); }
+        catch (const Error&) { added = false; }
+        INFO("2. owns its commands again"); CHECK(added);
+    }
+
+    TEST_CASE("CommandArenaReadDamaged", "[arena]")
+    {
+        CompositeCommand root;
+        root.add(new NullCommand());
+        root.add(new NullCommand());
+        BinaryBuffer bb;
+        root.write(bb);
+
+        SECTION("truncated")
+        {
+            BinaryBuffer cut;
+            cut.write(bb.data().first(bb.size() - 3));
+            MonotonicArena arena;
+            INFO("0. fails"); CHECK(CommandRegistry::read_command(cut, arena) == nullptr);
+            INFO("1. error set"); CHECK(!cut.ok());
+            CompositeCommand heap;
+            cut.rewind();
+            cut.clear_error();
+            INFO("2. own tag"); CHECK(CompositeCommand::INFO.read_tag(cut));
+            heap.read(cut);
+            INFO("3. heap read fails without leaking"); CHECK(!cut.ok());
+        }
+        SECTION("command count out of range")
+        {
+            BinaryBuffer empty;
+            CompositeCommand().write(empty);
+            // The count is the last field of an empty composite.
+            std::vector<std::byte> bytes(empty.data().begin(), empty.data().end());
+            size_t count = CompositeCommand::MAX_COMMANDS + 1;
+            std::memcpy(bytes.data() + bytes.size() - sizeof(count), &count, sizeof(count));
+            BinaryBuffer bad;
+            bad.write(std::span<const std::byte>(bytes));
+            MonotonicArena arena;
+            INFO("4. rejected"); CHECK(CommandRegistry::read_command(bad, arena) == nullptr);
+            INFO("5. invalid data"); CHECK(bad.error() == BufferError::INVALID_DATA);
+        }
+    }
+
+    TEST_CASE("CommandArenaBenchmark", "[.][arena][benchmark]")
+    {
+        CompositeCommand root;
+        for (size_t k = 0; k + 1 < CompositeCommand::MAX_COMMANDS; ++k) root.add(new NullCommand());
+        CompositeCommand* nested = new CompositeCommand();
+        for (size_t k = 0; k < CompositeCommand::MAX_COMMANDS; ++k) nested->add(new NullCommand());
+        root.add(nested);
+        BinaryBuffer bb;
+        bb.set_compact_types(true);
+        root.write(bb);
+        MonotonicArena arena;
+
+        BENCHMARK("CompositeCommand::read, 20 commands, heap")
+        {
+            bb.rewind();
+            CompositeCommand cmd;
+            (void)CompositeCommand::INFO.read_tag(bb);
+            return cmd.read(bb).ok();
+        };
+
+        BENCHMARK("CommandRegistry::read_command, 20 commands, arena")
+        {
+            bb.rewind();
+            const bool ok = CommandRegistry::read_command(bb, arena) != nullptr;
+            arena.release();
+            return ok;
+        };
+    }
+}
@@ -2,15 +2,23 @@
 // license: MIT (https://opensource.org/licenses/MIT)
 
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
 
 #include "../constant.hpp"
 #include "../string_def.hpp"
 #include "../cs.hpp"
 #include "../object.hpp"
+#include "../command.hpp"
 #include "../binary_buffer.hpp"
 #include "../concept.hpp"
+#include "../array.hpp"
+#include "../wire_int.hpp"
 
 #include <span>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 
 namespace pensar_digital::cpplib
 {
@@ -27,4 +35,462 @@ namespace pensar_digital::cpplib
         INFO(W("0"));
         CHECK(*o == *o2);
     }
+
+    TEST_CASE("BinaryBufferView", "[binary_buffer]")
+    {
+        BinaryBuffer bb;
+        const std::int64_t values[] = { 1, 2, 3, 4 };
+        bb.write(std::span<const std::byte>(std::as_bytes(std::span{ values })));
+
+        auto peeked = bb.peek(sizeof(std::int64_t));
+        INFO(W("0. peek does not consume")); CHECK(bb.remaining() == sizeof(values));
+        INFO(W("1. peek points into the buffer")); CHECK(peeked.data() == bb.data().data());
+
+        auto v = bb.view(sizeof(std::int64_t));
+        INFO(W("2. view consumes")); CHECK(bb.remaining() == 3 * sizeof(std::int64_t));
+        std::int64_t first = 0;
+        std::memcpy(&first, v.data(), sizeof(first));
+        INFO(W("3. view content")); CHECK(first == 1);
+
+        auto typed = bb.view_as<std::int64_t>(3);
+        if (!typed.empty()) // Empty only when the buffer storage is misaligned for int64_t.
+        {
+            INFO(W("4. typed view size")); CHECK(typed.size() == 3);
+            INFO(W("5. typed view content")); CHECK(typed[2] == 4);
+            INFO(W("6. typed view consumes")); CHECK(bb.remaining() == 0);
+        }
+
+        INFO(W("7. view past the end is empty")); CHECK(bb.view(1).empty());
+
+        // A count whose byte size wraps to a small number is rejected, not viewed.
+        BinaryBuffer wrap;
+        wrap.write(std::span<const std::byte>(std::as_bytes(std::span{ values })));
+        const size_t huge = (std::numeric_limits<size_t>::max)() / sizeof(std::int64_t) + 2;
+        INFO(W("8. wrapping count is empty")); CHECK(wrap.view_as<std::int64_t>(huge).empty());
+        INFO(W("9. and fails")); CHECK(wrap.error() == BufferError::READ_UNDERFLOW);
+    }
+
+    TEST_CASE("BinaryBufferSkip", "[binary_buffer]")
+    {
+        BinaryBuffer bb;
+        bb.write(std::int32_t{ 7 });
+        bb.write(std::int32_t{ 9 });
+        bb.skip(sizeof(std::int32_t));
+        std::int32_t x = 0;
+        bb.read(x);
+        INFO(W("0")); CHECK(x == 9);
+    }
+
+    TEST_CASE("BinaryBufferViewBenchmark", "[.][binary_buffer][benchmark]")
+    {
+        struct Record
+        {
+            std::int64_t id;
+            std::int64_t value;
+            std::int64_t flags;
+        };
+        static constexpr size_t RECORDS = 1'000'000;
+
+        BinaryBuffer bb(RECORDS * sizeof(Record));
+        for (size_t i = 0; i < RECORDS; ++i)
+            bb.write(Record{ static_cast<std::int64_t>(i), static_cast<std::int64_t>(i * 2), 0 });
+
+        BENCHMARK("copy read 1M records")
+        {
+            bb.rewind();
+            Record r{};
+            std::int64_t sum = 0;
+            for (size_t i = 0; i < RECORDS; ++i)
+            {
+                bb.read(r);
+                sum += r.id;
+            }
+            return sum;
+        };
+
+        BENCHMARK("view read 1M records")
+        {
+            bb.rewind();
+            std::int64_t sum = 0;
+            for (size_t i = 0; i < RECORDS; ++i)
+            {
+                const std::byte* p = bb.view(sizeof(Record)).data();
+                std::int64_t id;
+                std::memcpy(&id, p + offsetof(Record, id), sizeof(id));
+                sum += id;
+            }
+            return sum;
+        };
+
+        BENCHMARK("typed view read 1M records")
+        {
+            bb.rewind();
+            std::int64_t sum = 0;
+            for (const Record& r : bb.view_as<Record>(RECORDS))
+                sum += r.id;
+            return sum;
+        };
+    }
+
+    TEST_CASE("GrowthPolicy", "[binary_buffer]")
+    {
+        INFO(W("0. geometric doubles")); CHECK(GrowthPolicy::geometric().next_capacity(100, 101) == 200);
+        INFO(W("1. geometric 50%")); CHECK(GrowthPolicy::geometric(50).next_capacity(100, 101) == 150);
+        INFO(W("2. geometric never below required")); CHECK(GrowthPolicy::geometric().next_capacity(100, 500) == 500);
+        INFO(W("3. chunked rounds up")); CHECK(GrowthPolicy::chunked(64).next_capacity(0, 65) == 128);
+        INFO(W("4. fixed cap limits growth")); CHECK(GrowthPolicy::fixed_cap(150).next_capacity(100, 101) == 150);
+        INFO(W("5. fixed cap refuses")); CHECK(GrowthPolicy::fixed_cap(150).next_capacity(100, 151) == 0);
+    }
+
+    TEST_CASE("BinaryBufferGrowth", "[binary_buffer]")
+    {
+        BinaryBuffer bb(8);
+        size_t reallocations = 0;
+        const std::byte* last = bb.data().data();
+        for (std::int64_t i = 0; i < 1000; ++i)
+        {
+            bb.write(i);
+            if (bb.data().data() != last)
+            {
+                ++reallocations;
+                last = bb.data().data();
+            }
+        }
+        INFO(W("0. geometric growth reallocates logarithmically")); CHECK(reallocations <= 10);
+
+        std::int64_t x = -1;
+        bb.skip(999 * sizeof(std::int64_t));
+        bb.read(x);
+        INFO(W("1. content survives reallocation")); CHECK(x == 999);
+
+        BinaryBuffer capped(0, GrowthPolicy::fixed_cap(16));
+        capped.write(std::int64_t{ 1 });
+        capped.write(std::int64_t{ 2 });
+        capped.write(std::int64_t{ 3 });
+        INFO(W("2. fixed cap stops growth")); CHECK(capped.size() == 16);
+        INFO(W("3. reserve respects the cap")); CHECK((!capped.reserve(17) && capped.capacity() == 16));
+
+        BinaryBuffer assigned;
+        assigned = capped;
+        INFO(W("4. copy assignment keeps the policy")); CHECK(assigned.growth_policy().next_capacity(16, 17) == 0);
+    }
+
+    TEST_CASE("BinaryBufferReserveFor", "[binary_buffer]")
+    {
+        BinaryBuffer bb(0);
+        REQUIRE(bb.reserve_for<Object>(100));
+        INFO(W("0. capacity from Object::SIZE")); CHECK(bb.capacity() >= 100 * Object::SIZE);
+
+        const std::byte* before = bb.data().data();
+        for (Id i = 0; i < 100; ++i)
+            Object(i).write(bb);
+        INFO(W("1. no reallocation after reserve_for")); CHECK(bb.data().data() == before);
+
+        REQUIRE(bb.reserve_for<Object, std::int64_t>(10));
+        INFO(W("2. variadic sizes add up")); CHECK(bb.capacity() >= bb.size() + 10 * (Object::SIZE + sizeof(std::int64_t)));
+    }
+
+    // A small BinaryBufferIO object: 16 bytes per record.
+    struct Small
+    {
+        inline static constexpr size_t SIZE = 2 * sizeof(std::int64_t);
+        std::int64_t a = 0;
+        std::int64_t b = 0;
+        BinaryBuffer& write(BinaryBuffer& bb) const noexcept { bb.write(a); return bb.write(b); }
+        BinaryBuffer& read(BinaryBuffer& bb) noexcept { bb.read(a); return bb.read(b); }
+    };
+
+    TEST_CASE("BinaryBufferGrowthBenchmark", "[.][binary_buffer][benchmark]")
+    {
+        static constexpr size_t OBJECTS = 10'000'000;
+
+        BENCHMARK("before: exact resize of a zero-filled vector, 10M objects")
+        {
+            std::vector<std::byte> v;
+            v.reserve(4096);
+            size_t pos = 0;
+            for (size_t i = 0; i < OBJECTS; ++i)
+            {
+                const Small s{ static_cast<std::int64_t>(i), 1 };
+                v.resize(pos + Small::SIZE);
+                std::memcpy(v.data() + pos, &s.a, sizeof(s.a));
+                std::memcpy(v.data() + pos + sizeof(s.a), &s.b, sizeof(s.b));
+                pos += Small::SIZE;
+            }
+            return v.size();
+        };
+
+        BENCHMARK("after: geometric growth, 10M objects")
+        {
+            BinaryBuffer bb;
+            for (size_t i = 0; i < OBJECTS; ++i)
+                Small{ static_cast<std::int64_t>(i), 1 }.write(bb);
+            return bb.size();
+        };
+
+        BENCHMARK("after: reserve_for, 10M objects")
+        {
+            BinaryBuffer bb(0);
+            bb.reserve_for<Small>(OBJECTS);
+            for (size_t i = 0; i < OBJECTS; ++i)
+                Small{ static_cast<std::int64_t>(i), 1 }.write(bb);
+            return bb.size();
+        };
+    }
+
+    TEST_CASE("BinaryBufferErrors", "[binary_buffer]")
+    {
+        BinaryBuffer bb;
+        bb.write(std::int32_t{ 1 });
+        std::int64_t x = 0;
+        bb.read(x);
+        INFO(W("0. underflow sets the error")); CHECK(bb.error() == BufferError::READ_UNDERFLOW);
+        INFO(W("1. status reports it")); CHECK(!bb.status());
+        INFO(W("2. nothing consumed")); CHECK(bb.remaining() == sizeof(std::int32_t));
+
+        std::int32_t y = 0;
+        bb.read(y);
+        INFO(W("3. sticky: later reads are no-ops")); CHECK((y == 0 && bb.remaining() == sizeof(std::int32_t)));
+
+        bb.clear_error();
+        bb.read(y);
+        INFO(W("4. reads again after clear_error")); CHECK((bb.ok() && y == 1));
+
+        BinaryBuffer capped(0, GrowthPolicy::fixed_cap(4));
+        capped.write(std::int64_t{ 1 });
+        INFO(W("5. overflow")); CHECK(capped.error() == BufferError::WRITE_OVERFLOW);
+
+        BinaryBuffer varints;
+        varints.write(std::byte{ 0x80 });
+        std::uint64_t v = 0;
+        varints.read_varint(v);
+        INFO(W("6. truncated varint")); CHECK(varints.error() == BufferError::INVALID_VARINT);
+    }
+
+    TEST_CASE("BinaryBufferEnsure", "[binary_buffer]")
+    {
+        BinaryBuffer bb;
+        bb.write(std::int64_t{ 1 });
+        bb.write(std::int32_t{ 2 });
+        REQUIRE(bb.ensure(sizeof(std::int64_t) + sizeof(std::int32_t)));
+        std::int64_t a = 0;
+        std::int32_t b = 0;
+        bb.read_unchecked(a).read_unchecked(b);
+        INFO(W("0. unchecked reads")); CHECK((a == 1 && b == 2));
+        INFO(W("1. ensure past the end fails")); CHECK(!bb.ensure(1));
+        INFO(W("2. and sets the error")); CHECK(bb.error() == BufferError::READ_UNDERFLOW);
+
+        // A record with a foreign ClassInfo is rejected without consuming its data.
+        BinaryBuffer malformed;
+        Object(1).write(malformed);
+        std::vector<std::byte> bytes(malformed.data().begin(), malformed.data().end());
+        bytes[0] = ~bytes[0];
+        malformed.clear();
+        malformed.write(std::span<const std::byte>(bytes));
+        Object o(7);
+        o.read(malformed);
+        INFO(W("3. invalid data")); CHECK(malformed.error() == BufferError::INVALID_DATA);
+        INFO(W("4. object untouched")); CHECK(o.id() == 7);
+    }
+
+    TEST_CASE("BinaryBufferEnsureBenchmark", "[.][binary_buffer][benchmark]")
+    {
+        static constexpr size_t RECORDS = 10'000'000;
+        BinaryBuffer bb(RECORDS * 3 * sizeof(std::int64_t));
+        for (std::int64_t i = 0; i < static_cast<std::int64_t>(RECORDS); ++i)
+        {
+            bb.write(i);
+            bb.write(i + 1);
+            bb.write(i + 2);
+        }
+
+        BENCHMARK("checked read per field, 10M records")
+        {
+            bb.rewind();
+            std::int64_t sum = 0, a, b, c;
+            for (size_t i = 0; i < RECORDS; ++i)
+            {
+                bb.read(a).read(b).read(c);
+                sum += a + b + c;
+            }
+            return sum;
+        };
+
+        BENCHMARK("ensure once per record, 10M records")
+        {
+            bb.rewind();
+            std::int64_t sum = 0, a, b, c;
+            for (size_t i = 0; i < RECORDS; ++i)
+            {
+                if (!bb.ensure(3 * sizeof(std::int64_t))) break;
+                bb.read_unchecked(a).read_unchecked(b).read_unchecked(c);
+                sum += a + b + c;
+            }
+            return sum;
+        };
+    }
+
+    TEST_CASE("BinaryBufferArray", "[binary_buffer]")
+    {
+        BinaryBuffer bb;
+        std::vector<WireInt64> wire = { WireInt64(1), WireInt64(2), WireInt64(3) };
+        bb.write_array(wire);
+        INFO(W("0. count prefix plus one copy")); CHECK(bb.size() == sizeof(std::uint64_t) + 3 * sizeof(WireInt64));
+
+        std::vector<WireInt64> wire_back;
+        bb.read_array(wire_back);
+        INFO(W("1. vector round trip")); CHECK(wire_back == wire);
+
+        CArray<4, std::int32_t> carray = { 1, -2, 3, -4 };
+        CArray<4, std::int32_t> carray_back;
+        bb.write_array(carray);
+        bb.read_array(carray_back);
+        INFO(W("2. CArray round trip")); CHECK(std::memcmp(carray.data(), carray_back.data(), sizeof(carray)) == 0);
+
+        const std::uint32_t values[] = { 0x01020304u, 0x05060708u };
+        bb.clear();
+        bb.write_array(std::span<const std::uint32_t>(values), Endian::big());
+        const std::span<const std::byte> bytes = bb.data().subspan(sizeof(std::uint64_t));
+        INFO(W("3. stored big endian")); CHECK((bytes[0] == std::byte{ 1 } && bytes[3] == std::byte{ 4 } && bytes[4] == std::byte{ 5 }));
+        std::uint32_t back[2] = {};
+        bb.read_array(std::span<std::uint32_t>(back), Endian::big());
+        INFO(W("4. swapped back")); CHECK((back[0] == values[0] && back[1] == values[1]));
+
+        bb.clear();
+        bb.write_array(std::span<const std::uint32_t>(values));
+        std::uint32_t three[3] = {};
+        bb.read_array(std::span<std::uint32_t>(three));
+        INFO(W("5. count mismatch")); CHECK(bb.error() == BufferError::INVALID_DATA);
+
+        bb.clear();
+        bb.write(std::uint64_t{ 1 } << 40); // Corrupt count, no elements.
+        std::vector<std::uint64_t> huge;
+        bb.read_array(huge);
+        INFO(W("6. corrupt count rejected before allocating")); CHECK((bb.error() == BufferError::READ_UNDERFLOW && huge.capacity() == 0));
+
+        BinaryBuffer compact;
+        compact.set_compact_integers(true);
+        compact.write_array(std::span<const std::uint32_t>(values));
+        INFO(W("7. varint count in compact mode")); CHECK(compact.size() == 1 + sizeof(values));
+
+        // Through a sink with no room for the whole array, in compact integers mode: the
+        // swapped elements are still written raw, as read_array reads them.
+        std::vector<std::uint32_t> many(1000);
+        for (size_t i = 0; i < many.size(); ++i) many[i] = static_cast<std::uint32_t>(i * 0x01010101u);
+        std::vector<std::byte> sunk;
+        std::byte window[64];
+        BinaryBuffer sink(0);
+        sink.set_compact_integers(true);
+        sink.attach_sink(window, [&](std::span<const std::byte> written, size_t)
+        {
+            sunk.insert(sunk.end(), written.begin(), written.end());
+            return std::span<std::byte>(window);
+        });
+        sink.write_array(std::span<const std::uint32_t>(many), Endian::big());
+        sunk.insert(sunk.end(), sink.data().begin(), sink.data().end());
+        BinaryBuffer source;
+        source.set_compact_integers(true);
+        source.write(std::span<const std::byte>(sunk));
+        std::vector<std::uint32_t> many_back;
+        source.read_array(many_back, Endian::big());
+        INFO(W("8. sink, compact, big endian")); CHECK((sink.ok() && source.ok() && many_back == many && source.remaining() == 0));
+    }
+
+    TEST_CASE("BinaryBufferCompactTypes", "[binary_buffer]")
+    {
+        static constexpr size_t COUNT = 100;
+        BinaryBuffer bb;
+        bb.set_compact_types(true);
+        for (size_t i = 0; i < COUNT; ++i)
+            Object(static_cast<Id>(i)).write(bb);
+        INFO(W("0. the ClassInfo is written once")); CHECK(bb.size() < COUNT * Object::SIZE / 10);
+
+        Object o;
+        bool all_equal = true;
+        for (size_t i = 0; i < COUNT; ++i)
+        {
+            o.read(bb);
+            all_equal = all_equal && (o.id() == static_cast<Id>(i));
+        }
+        INFO(W("1. read back")); CHECK((all_equal && bb.ok() && bb.remaining() == 0));
+
+        BinaryBuffer copy = bb;
+        copy.rewind();
+        copy.read(o);
+        INFO(W("2. copies and rewinds keep the table")); CHECK((copy.ok() && o.id() == 0));
+
+        // A reader that only sees the bytes (e.g. from a file) rebuilds the table.
+        BinaryBuffer reader;
+        reader.set_compact_types(true);
+        reader.write(bb.data());
+        reader.read(o).skip(reader.remaining() - Object::DATA_SIZE - 1).read(o);
+        INFO(W("3. later records are an id")); CHECK((reader.ok() && o.id() == static_cast<Id>(COUNT - 1)));
+
+        BinaryBuffer unknown;
+        unknown.set_compact_types(true);
+        unknown.write_varint(5u);
+        unknown.read(o);
+        INFO(W("4. undefined type id")); CHECK(unknown.error() == BufferError::INVALID_DATA);
+
+        BinaryBuffer wrong;
+        wrong.set_compact_types(true);
+        Command::INFO.write_tag(wrong);
+        wrong.write(Object().data_bytes());
+        wrong.read(o);
+        INFO(W("5. wrong type")); CHECK(wrong.error() == BufferError::INVALID_DATA);
+
+        BinaryBuffer plain;
+        Object(7).write(plain);
+        INFO(W("6. off by default")); CHECK((!plain.compact_types() && plain.size() == Object::SIZE));
+    }
+
+    TEST_CASE("BinaryBufferArrayBenchmark", "[.][binary_buffer][benchmark]")
+    {
+        static constexpr size_t COUNT = 10'000'000;
+        std::vector<std::int64_t> values(COUNT);
+        for (size_t i = 0; i < COUNT; ++i)
+            values[i] = static_cast<std::int64_t>(i);
+        BinaryBuffer bb(COUNT * sizeof(std::int64_t) + 16);
+        std::vector<std::int64_t> back(COUNT);
+
+        BENCHMARK("per element write, 10M int64")
+        {
+            bb.clear();
+            bb.write(static_cast<std::uint64_t>(values.size()));
+            for (std::int64_t v : values) bb.write(v);
+            return bb.size();
+        };
+
+        BENCHMARK("write_array, 10M int64")
+        {
+            bb.clear();
+            bb.write_array(values);
+            return bb.size();
+        };
+
+        BENCHMARK("write_array big endian, 10M int64")
+        {
+            bb.clear();
+            bb.write_array(values, Endian::big());
+            return bb.size();
+        };
+
+        BENCHMARK("per element read, 10M int64")
+        {
+            bb.clear();
+            bb.write_array(values);
+            std::uint64_t count = 0;
+            bb.read(count);
+            for (std::int64_t& v : back) bb.read(v);
+            return back.back();
+        };
+
+        BENCHMARK("read_array, 10M int64")
+        {
+            bb.clear();
+            bb.write_array(values);
+            bb.read_array(std::span<std::int64_t>(back));
+            return back.back();
+        };
+    }
 }
@@ -0,0 +1,245 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "test_helpers.hpp"
+
+#include "../object.hpp"
+#include "../binary_buffer.hpp"
+#include "../binary_stream.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace pensar_digital::cpplib
+{
+    using namespace test_helpers;
+
+    TEST_CASE("BinaryStreamObjects", "[binary_stream]")
+    {
+        const size_t COUNT = 10000;
+        for (bool async : { true, false })
+        {
+            Path out = test_file(W("BinaryStream"), W("objects.bin"));
+            {
+                Result<int> fd = open_fd(out.s(), FdMode::WRITE);
+                REQUIRE(fd);
+                // A window that is not a multiple of Object::SIZE, so objects straddle blocks.
+                BinaryWriter w(fd.mresult, 1000, async);
+                for (size_t i = 0; i < COUNT; ++i)
+                    w.write(Object(static_cast<Id>(i)));
+                INFO(W("0. size")); CHECK(w.size() == COUNT * Object::SIZE);
+                REQUIRE(w.flush());
+                close_fd(fd.mresult);
+            }
+
+            Result<int> fd = open_fd(out.s(), FdMode::READ);
+            REQUIRE(fd);
+            BinaryReader r(fd.mresult, 1000, async);
+            Object o;
+            bool all_equal = true;
+            for (size_t i = 0; i < COUNT; ++i)
+            {
+                r.read(o);
+                all_equal = all_equal && (o.id() == static_cast<Id>(i));
+            }
+            INFO(W("1. objects read back")); CHECK(all_equal);
+            INFO(W("2. position")); CHECK(r.position() == COUNT * Object::SIZE);
+            INFO(W("3. eof")); CHECK(r.eof());
+            INFO(W("4. status")); CHECK(r.status());
+            close_fd(fd.mresult);
+        }
+    }
+
+    TEST_CASE("BinaryStreamLargeValues", "[binary_stream]")
+    {
+        Path out = test_file(W("BinaryStream"), W("large.bin"));
+        std::vector<std::int64_t> big(1000);
+        for (size_t i = 0; i < big.size(); ++i)
+            big[i] = static_cast<std::int64_t>(i);
+        {
+            Result<int> fd = open_fd(out.s(), FdMode::WRITE);
+            REQUIRE(fd);
+            BinaryWriter w(fd.mresult, 100);
+            w.write(std::int32_t{ 7 });
+            w.write(std::as_bytes(std::span<const std::int64_t>(big)));
+            w.write(std::int32_t{ 8 });
+            REQUIRE(w.flush());
+            close_fd(fd.mresult);
+        }
+
+        Result<int> fd = open_fd(out.s(), FdMode::READ);
+        REQUIRE(fd);
+        BinaryReader r(fd.mresult, 100);
+        std::int32_t a = 0, b = 0;
+        std::vector<std::int64_t> back(big.size());
+        r.read(a);
+        r.read(std::as_writable_bytes(std::span<std::int64_t>(back)));
+        r.read(b);
+        INFO(W("0. value before")); CHECK(a == 7);
+        INFO(W("1. value larger than the window")); CHECK(back == big);
+        INFO(W("2. value after")); CHECK(b == 8);
+        INFO(W("3. eof")); CHECK(r.eof());
+        close_fd(fd.mresult);
+    }
+
+    TEST_CASE("BinaryStreamFramed", "[binary_stream]")
+    {
+        const size_t COUNT = 5000;
+        std::vector<std::int64_t> big(1000);
+        for (size_t i = 0; i < big.size(); ++i)
+            big[i] = static_cast<std::int64_t>(i) * 3;
+        Path out = test_file(W("BinaryStream"), W("framed.bin"));
+        for (Codec codec : { Codec::FAST, Codec::HIGH, Codec::NONE })
+        for (bool async : { true, false })
+        {
+            {
+                Result<int> fd = open_fd(out.s(), FdMode::WRITE);
+                REQUIRE(fd);
+                BinaryWriter w(fd.mresult, 1000, async, true, codec);
+                for (size_t i = 0; i < COUNT; ++i)
+                {
+                    w.write(Object(static_cast<Id>(i)));
+                    if (i == 2) REQUIRE(w.flush()); // A short frame in the middle of the stream.
+                }
+                w.write(std::as_bytes(std::span<const std::int64_t>(big)));
+                REQUIRE(w.close());
+                close_fd(fd.mresult);
+            }
+
+            Result<int> fd = open_fd(out.s(), FdMode::READ);
+            REQUIRE(fd);
+            BinaryReader r(fd.mresult, 64, async, true);
+            INFO(W("0. window and codec of the writer")); CHECK((r.window() == 1000 && r.codec() == codec));
+            Object o;
+            bool all_equal = true;
+            for (size_t i = 0; i < COUNT; ++i)
+            {
+                r.read(o);
+                all_equal = all_equal && (o.id() == static_cast<Id>(i));
+            }
+            std::vector<std::int64_t> back(big.size());
+            r.read(std::as_writable_bytes(std::span<std::int64_t>(back)));
+            INFO(W("1. objects read back")); CHECK(all_equal);
+            INFO(W("2. value larger than the window")); CHECK(back == big);
+            INFO(W("3. eof")); CHECK(r.eof());
+            INFO(W("4. status")); CHECK(r.status());
+            close_fd(fd.mresult);
+        }
+
+        BinaryBuffer file;
+        REQUIRE(file.load_from_file(out.s()));
+        const std::vector<std::byte> good(file.data().begin(), file.data().end());
+
+        // Reads a copy of the stream to its end; returns the reader's status.
+        auto read_damaged = [&](std::span<const std::byte> bytes, bool framed)
+        {
+            Path bad = test_file(W("BinaryStream"), W("framed_bad.bin"));
+            BinaryBuffer bb;
+            bb.write(bytes);
+            REQUIRE(bb.save_to_file(bad.s()));
+            Result<int> fd = open_fd(bad.s(), FdMode::READ);
+            REQUIRE(fd);
+            Result<Bool> status(Bool::T);
+            {
+                BinaryReader r(fd.mresult, 1000, true, framed);
+                std::byte b;
+                while (!r.eof()) r.read(b);
+                status = r.status();
+            }
+            close_fd(fd.mresult);
+            return status;
+        };
+
+        // Offset of the last data frame.
+        size_t last = sizeof(FrameFileHeader);
+        for (size_t pos = last; ; )
+        {
+            FrameHeader h;
+            std::memcpy(&h, good.data() + pos, sizeof(h));
+            if (h.is_end()) break;
+            last = pos;
+            pos += sizeof(h) + h.mlength.value();
+        }
+
+        std::vector<std::byte> flipped = good;
+        flipped[flipped.size() / 2] ^= std::byte{ 0x01 };
+        INFO(W("5. intact copy")); CHECK(read_damaged(good, true));
+        INFO(W("6. flipped bit detected")); CHECK(!read_damaged(flipped, true));
+        INFO(W("7. missing end frame detected")); CHECK(!read_damaged(std::span(good).first(good.size() - 16), true));
+        INFO(W("8. cut at a frame boundary detected")); CHECK(!read_damaged(std::span(good).first(last), true));
+        INFO(W("9. not a framed stream")); CHECK(!read_damaged(std::span(good).subspan(4), true));
+    }
+
+    TEST_CASE("BinaryStreamBenchmark", "[.][binary_stream][benchmark]")
+    {
+        static constexpr size_t OBJECTS = 1'000'000;
+        Path out = test_file(W("BinaryStream"), W("benchmark.bin"));
+
+        BENCHMARK("BinaryBuffer::save_to_file, 1M objects")
+        {
+            BinaryBuffer bb;
+            for (size_t i = 0; i < OBJECTS; ++i)
+                Object(static_cast<Id>(i)).write(bb);
+            return bb.save_to_file(out.s()).mok;
+        };
+
+        BENCHMARK("BinaryWriter, 1M objects")
+        {
+            Result<int> fd = open_fd(out.s(), FdMode::WRITE);
+            {
+                BinaryWriter w(fd.mresult);
+                for (size_t i = 0; i < OBJECTS; ++i)
+                    w.write(Object(static_cast<Id>(i)));
+            }
+            return close_fd(fd.mresult).mok;
+        };
+
+        BENCHMARK("BinaryReader, 1M objects")
+        {
+            Result<int> fd = open_fd(out.s(), FdMode::READ);
+            Id sum = 0;
+            {
+                BinaryReader r(fd.mresult);
+                Object o;
+                while (!r.eof())
+                {
+                    r.read(o);
+                    sum += o.id();
+                }
+            }
+            close_fd(fd.mresult);
+            return sum;
+        };
+
+        BENCHMARK("BinaryWriter framed, 1M objects")
+        {
+            Result<int> fd = open_fd(out.s(), FdMode::WRITE);
+            {
+                BinaryWriter w(fd.mresult, BinaryWriter::DEFAULT_WINDOW, true, true);
+                for (size_t i = 0; i < OBJECTS; ++i)
+                    w.write(Object(static_cast<Id>(i)));
+            }
+            return close_fd(fd.mresult).mok;
+        };
+
+        BENCHMARK("BinaryReader framed, 1M objects")
+        {
+            Result<int> fd = open_fd(out.s(), FdMode::READ);
+            Id sum = 0;
+            {
+                BinaryReader r(fd.mresult, BinaryReader::DEFAULT_WINDOW, true, true);
+                Object o;
+                while (!r.eof())
+                {
+                    r.read(o);
+                    sum += o.id();
+                }
+            }
+            close_fd(fd.mresult);
+            return sum;
+        };
+    }
+}
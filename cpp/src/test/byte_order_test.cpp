@@ -2,6 +2,7 @@
 // license: MIT (https://opensource.org/licenses/MIT)
 
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include "test_helpers.hpp"
 
 #include "../s.hpp"
@@ -9,6 +10,8 @@
 #include "../array.hpp"
 
 #include <span>
+#include <vector>
+#include <cstdint>
 
 namespace pensar_digital::cpplib
 {
@@ -83,4 +86,77 @@ namespace pensar_digital::cpplib
         std::vector<uint64_t> a16 = { 0xf8ffffffffffffff, 0xf9ffffffffffffff, 0xfaffffffffffffff, 0xfbffffffffffffff, 0xfcffffffffffffff, 0xfdffffffffffffff, 0xfeffffffffffffff, 0xffffffffffffffff, 0x0000000000000000, 0x0100000000000000, 0x0200000000000000 ,0x0300000000000000, 0x0400000000000000, 0x0500000000000000, 0x0600000000000000, 0x0700000000000000, 0x0800000000000000 };
         test_byte_order_conversion<int64_t, uint64_t>(a15, a16, 7);
     }
+
+    template <typename T>
+    static bool byteswap_kernels_agree(size_t count)
+    {
+        std::vector<T> in(count);
+        for (size_t i = 0; i < count; ++i)
+            in[i] = static_cast<T>(0x0102030405060708ULL * (i + 1));
+        std::vector<T> expected(count);
+        for (size_t i = 0; i < count; ++i)
+            expected[i] = std::byteswap(in[i]);
+
+        bool ok = true;
+        for (SimdLevel level : { SimdLevel::SCALAR, SimdLevel::SSSE3, SimdLevel::AVX2 })
+        {
+            if (level > simd_level()) break;
+            // Out of place from an odd offset (unaligned), then in place back.
+            std::vector<std::byte> src(count * sizeof(T) + 1), dst(count * sizeof(T) + 1);
+            std::memcpy(src.data() + 1, in.data(), count * sizeof(T));
+            byteswap_copy<sizeof(T)>(src.data() + 1, dst.data() + 1, count, level);
+            ok = ok && std::memcmp(dst.data() + 1, expected.data(), count * sizeof(T)) == 0;
+            byteswap_copy<sizeof(T)>(dst.data() + 1, dst.data() + 1, count, level);
+            ok = ok && std::memcmp(dst.data() + 1, in.data(), count * sizeof(T)) == 0;
+        }
+        return ok;
+    }
+
+    TEST_CASE("ByteswapKernels", "[byte_order]")
+    {
+        // Counts around the 16, 32 and 64 byte steps exercise every tail.
+        bool ok = true;
+        for (size_t count : { 0, 1, 3, 7, 8, 9, 15, 16, 17, 33, 100, 1001 })
+            ok = ok && byteswap_kernels_agree<std::uint16_t>(count) && byteswap_kernels_agree<std::uint32_t>(count) && byteswap_kernels_agree<std::uint64_t>(count);
+        INFO(W("0. every kernel matches std::byteswap")); CHECK(ok);
+
+        const std::uint32_t from[3] = { 0x01020304u, 0x05060708u, 0x090A0B0Cu };
+        std::uint32_t to[3] = {};
+        convert(std::as_bytes(std::span(from)), std::as_writable_bytes(std::span(to)), sizeof(std::uint32_t), native_byte_order, big_address_8_byte_order);
+        INFO(W("1. out of place convert")); CHECK((to[0] == std::byteswap(from[0]) && to[2] == std::byteswap(from[2])));
+
+        std::uint32_t same[3] = {};
+        convert(std::as_bytes(std::span(from)), std::as_writable_bytes(std::span(same)), sizeof(std::uint32_t), native_byte_order, native_byte_order);
+        INFO(W("2. same byte order copies")); CHECK((same[0] == from[0] && same[2] == from[2]));
+
+        std::uint8_t three[6] = { 1, 2, 3, 4, 5, 6 };
+        byteswap_copy(reinterpret_cast<std::byte*>(three), reinterpret_cast<std::byte*>(three), 2, 3);
+        INFO(W("3. other element sizes")); CHECK((three[0] == 3 && three[2] == 1 && three[3] == 6 && three[5] == 4));
+    }
+
+    TEST_CASE("ByteswapBenchmark", "[.][byte_order][benchmark]")
+    {
+        static constexpr size_t COUNT = 10'000'000;
+        std::vector<std::uint32_t> in(COUNT, 0x01020304u), out(COUNT);
+        const std::byte* src = reinterpret_cast<const std::byte*>(in.data());
+        std::byte* dst = reinterpret_cast<std::byte*>(out.data());
+
+        BENCHMARK("memcpy, 10M uint32")
+        {
+            std::memcpy(dst, src, COUNT * sizeof(std::uint32_t));
+            return out.back();
+        };
+
+        BENCHMARK("scalar byteswap, 10M uint32")
+        {
+            byteswap_copy<4>(src, dst, COUNT, SimdLevel::SCALAR);
+            return out.back();
+        };
+
+        BENCHMARK("dispatched byteswap, 10M uint32")
+        {
+            byteswap_copy<4>(src, dst, COUNT);
+            return out.back();
+        };
+    }
 }
@@ -0,0 +1,105 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "../class_info_table.hpp"
+#include "../command.hpp"
+#include "../object.hpp"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace pensar_digital::cpplib
+{
+    TEST_CASE("ClassInfoTable", "[class_info]")
+    {
+        const ClassInfo a = { CPPLIB_NAMESPACE, W("InternA"), 1, 2, 3 };
+        const ClassInfo a2 = a;
+        const ClassInfo a_v2 = { CPPLIB_NAMESPACE, W("InternA"), 2, 2, 3 };
+        const ClassInfo b = { CPPLIB_NAMESPACE, W("InternB"), 1, 2, 3 };
+
+        const ClassInfo unseen = { CPPLIB_NAMESPACE, W("NeverInterned"), 9, 9, 9 };
+        INFO("0. find does not add"); CHECK(!ClassInfoTable::find(unseen).has_value());
+        const size_t before = ClassInfoTable::size();
+        INFO("1. still absent"); CHECK(ClassInfoTable::size() == before);
+
+        const ClassId ia = ClassInfoTable::intern(a);
+        INFO("2. equal bytes, same id"); CHECK(ClassInfoTable::intern(a2) == ia);
+        INFO("3. versions count"); CHECK(ClassInfoTable::intern(a_v2) != ia);
+        INFO("4. names count"); CHECK(ClassInfoTable::intern(b) != ia);
+        INFO("5. found"); CHECK(ClassInfoTable::find(a.bytes()) == ia);
+        INFO("6. wrong size"); CHECK(!ClassInfoTable::find(a.bytes().first(10)).has_value());
+
+        const InternedClass& e = ClassInfoTable::get(ia);
+        INFO("7. info"); CHECK(e.minfo == a);
+        INFO("8. cached name"); CHECK(e.mfull_name == a.full_class_name());
+        INFO("9. cached hash"); CHECK(e.mhash == ClassInfoTable::hash(a.bytes()));
+        INFO("10. id"); CHECK(e.mid == ia);
+
+        INFO("11. class_id"); CHECK(class_id<Object>() == ClassInfoTable::intern(Object::INFO));
+        INFO("12. class_id is stable"); CHECK(class_id<Object>() == class_id<Object>());
+        INFO("13. distinct classes"); CHECK(class_id<Object>() != class_id<Command>());
+    }
+
+    TEST_CASE("ClassInfoTableThreads", "[class_info]")
+    {
+        // Threads interning the same new classes agree on their ids.
+        constexpr size_t CLASSES = 64;
+        std::vector<ClassInfo> infos;
+        for (size_t i = 0; i < CLASSES; ++i)
+            infos.push_back(ClassInfo(CPPLIB_NAMESPACE, W("Concurrent"), static_cast<VersionInt>(i), 0, 0));
+
+        constexpr size_t THREADS = 4;
+        std::vector<std::vector<ClassId>> ids(THREADS, std::vector<ClassId>(CLASSES));
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < THREADS; ++t)
+            threads.emplace_back([&, t] { for (size_t i = 0; i < CLASSES; ++i) ids[t][(i + t * 7) % CLASSES] = ClassInfoTable::intern(infos[(i + t * 7) % CLASSES]); });
+        for (std::thread& t : threads) t.join();
+
+        bool agree = true;
+        for (size_t t = 1; t < THREADS; ++t) agree = agree && ids[t] == ids[0];
+        INFO("0. agree"); CHECK(agree);
+        bool distinct = true;
+        for (size_t i = 1; i < CLASSES; ++i) distinct = distinct && ids[0][i] != ids[0][i - 1];
+        INFO("1. distinct"); CHECK(distinct);
+    }
+
+    TEST_CASE("CommandRegistryVersions", "[class_info]")
+    {
+        // The registered version is an id lookup; another version of the class still resolves by name.
+        std::unique_ptr<Command> same(CommandRegistry::create(NullCommand::INFO));
+        INFO("0. registered version"); CHECK(dynamic_cast<NullCommand*>(same.get()) != nullptr);
+
+        const ClassInfo newer = { CPPLIB_NAMESPACE, W("NullCommand"), 3, 1, 1 };
+        std::unique_ptr<Command> other(CommandRegistry::create(newer));
+        INFO("1. other version"); CHECK(dynamic_cast<NullCommand*>(other.get()) != nullptr);
+        INFO("2. lookups do not intern"); CHECK(!ClassInfoTable::find(newer).has_value());
+
+        const ClassInfo unknown = { CPPLIB_NAMESPACE, W("NoSuchCommand"), 2, 1, 1 };
+        INFO("3. unknown"); CHECK(CommandRegistry::create(unknown) == nullptr);
+    }
+
+    TEST_CASE("ClassInfoTableBenchmark", "[.][class_info][benchmark]")
+    {
+        ClassInfo info = NullCommand::INFO;
+
+        BENCHMARK("ClassInfo::full_class_name")
+        {
+            return info.full_class_name().size();
+        };
+
+        BENCHMARK("ClassInfoTable::find")
+        {
+            return ClassInfoTable::find(info).value_or(0);
+        };
+
+        BENCHMARK("CommandRegistry::create")
+        {
+            std::unique_ptr<Command> cmd(CommandRegistry::create(info));
+            return cmd != nullptr;
+        };
+    }
+}
@@ -0,0 +1,203 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "test_helpers.hpp"
+
+#include "../columnar.hpp"
+#include "../object.hpp"
+#include "../command.hpp"
+#include "../binary_buffer.hpp"
+#include "../mapped_binary_buffer.hpp"
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace pensar_digital::cpplib
+{
+    using namespace test_helpers;
+
+    struct Sample : public Data
+    {
+        std::int64_t  mid;
+        std::int32_t  mqty;
+        std::uint16_t mcode;
+        char          mtag[2];
+    };
+    static_assert(StdLayoutTriviallyCopyableNoPadding<Sample>);
+
+    inline constexpr auto SAMPLE_COLUMNS = DATA_COLUMNS(Sample, mid, mqty, mcode, mtag);
+
+    static std::vector<Sample> make_samples(size_t n)
+    {
+        std::vector<Sample> samples(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            Sample& s = samples[i];
+            s.mid   = static_cast<std::int64_t>(i) * 1000003;   // Distinct: plain.
+            s.mqty  = static_cast<std::int32_t>(i / 100) - 3;   // Long runs: RLE.
+            s.mcode = static_cast<std::uint16_t>(i * 7 % 5);    // Few values, no runs: dictionary.
+            s.mtag[0] = 'A'; s.mtag[1] = 'B';
+        }
+        return samples;
+    }
+
+    static bool same(const std::vector<Sample>& a, const std::vector<Sample>& b)
+    {
+        return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(Sample)) == 0;
+    }
+
+    TEST_CASE("Columnar", "[columnar]")
+    {
+        INFO(W("0. column info")); CHECK((SAMPLE_COLUMNS.size() == 4 && std::string_view(SAMPLE_COLUMNS[1].mname) == "mqty" &&
+            SAMPLE_COLUMNS[1].moffset == offsetof(Sample, mqty) && SAMPLE_COLUMNS[1].msize == 4 &&
+            SAMPLE_COLUMNS[1].mswap == 4 && SAMPLE_COLUMNS[3].mswap == 0));
+        INFO(W("1. class columns")); CHECK((Object::COLUMNS.size() == 1 && std::string_view(Object::COLUMNS[0].mname) == "mid" &&
+            std::string_view(Command::COLUMNS[0].mname) == "mok"));
+
+        const std::vector<Sample> samples = make_samples(1000);
+        ColumnarWriter w(SAMPLE_COLUMNS, sizeof(Sample));
+        w.add(std::span<const Sample>(samples));
+        BinaryBuffer bb;
+        REQUIRE(w.write(bb));
+
+        ColumnarReader r;
+        REQUIRE(r.open(bb.data()));
+        INFO(W("2. header")); CHECK((r.rows() == 1000 && r.column_count() == 4 && r.record_size() == sizeof(Sample)));
+        INFO(W("3. auto encodings")); CHECK((r.column(0).encoding() == ColumnEncoding::PLAIN && r.column(1).encoding() == ColumnEncoding::RLE &&
+            r.column(2).encoding() == ColumnEncoding::DICTIONARY && r.column(3).encoding() == ColumnEncoding::RLE));
+        INFO(W("4. compressed")); CHECK(bb.size() < samples.size() * sizeof(Sample) * 3 / 4);
+
+        std::vector<std::int32_t> qty(r.rows());
+        REQUIRE(r.read_column(r.find("mqty"), std::span<std::int32_t>(qty)));
+        bool ok = true;
+        for (size_t i = 0; i < qty.size(); ++i) ok = ok && qty[i] == samples[i].mqty;
+        INFO(W("5. column scan")); CHECK(ok);
+
+        std::vector<Sample> back(r.rows());
+        REQUIRE(r.read_records(std::span<Sample>(back)));
+        INFO(W("6. records")); CHECK(same(back, samples));
+
+        const std::span<const std::int64_t> ids = r.view_column<std::int64_t>(0);
+        INFO(W("7. zero copy view")); CHECK((ids.size() == samples.size() && ids[999] == samples[999].mid));
+
+        INFO(W("8. unknown column")); CHECK(r.find("nope") == ColumnarReader::NPOS);
+        std::vector<std::int64_t> wrong(r.rows());
+        INFO(W("9. width mismatch")); CHECK(!r.read_column(1, std::span<std::int64_t>(wrong)));
+
+        // Forced encodings and big endian values decode to the same records.
+        for (ColumnEncoding e : { ColumnEncoding::PLAIN, ColumnEncoding::RLE, ColumnEncoding::DICTIONARY })
+        {
+            ColumnarWriter wbe(SAMPLE_COLUMNS, sizeof(Sample), Endian::big());
+            wbe.add(std::span<const Sample>(samples));
+            for (size_t c = 0; c < wbe.column_count(); ++c) wbe.set_encoding(c, e);
+            BinaryBuffer be;
+            REQUIRE(wbe.write(be));
+            ColumnarReader rbe;
+            REQUIRE(rbe.open(be.data()));
+            std::vector<Sample> recs(rbe.rows());
+            REQUIRE(rbe.read_records(std::span<Sample>(recs)));
+            INFO(W("10. encoding ") << static_cast<int>(e)); CHECK(same(recs, samples));
+            INFO(W("11. no view of swapped columns")); CHECK(rbe.view_column<std::int64_t>(0).empty());
+        }
+        // More distinct values than a dictionary holds fall back to plain.
+        {
+            ColumnarWriter wd(SAMPLE_COLUMNS, sizeof(Sample));
+            const std::vector<Sample> many = make_samples(COLUMNAR_MAX_DICTIONARY + 1);
+            wd.add(std::span<const Sample>(many));
+            wd.set_encoding(0, ColumnEncoding::DICTIONARY);
+            BinaryBuffer d;
+            REQUIRE(wd.write(d));
+            ColumnarReader rd;
+            REQUIRE(rd.open(d.data()));
+            std::vector<Sample> recs(rd.rows());
+            REQUIRE(rd.read_records(std::span<Sample>(recs)));
+            INFO(W("12. dictionary overflow")); CHECK((rd.column(0).encoding() == ColumnEncoding::PLAIN && same(recs, many)));
+        }
+
+        std::vector<std::byte> bad(bb.data().begin(), bb.data().end());
+        bad[0] = std::byte{ 'X' };
+        INFO(W("13. bad magic")); CHECK(!ColumnarReader().open(bad));
+        INFO(W("14. truncated")); CHECK(!ColumnarReader().open(bb.data().first(bb.size() - 1)));
+        bad[0] = std::byte{ 'P' };
+        bad[r.column(1).moffset] = std::byte{ 0x7F }; // First run longer than the column.
+        ColumnarReader rbad;
+        REQUIRE(rbad.open(bad));
+        INFO(W("15. corrupt chunk")); CHECK(!rbad.read_column(1, std::span<std::int32_t>(qty)));
+
+        // A row count whose record bytes overflow a size_t would wrap every size check.
+        std::vector<std::byte> huge(bb.data().begin(), bb.data().end());
+        std::uint64_t rows = std::numeric_limits<size_t>::max() / sizeof(Sample) + 1;
+        std::memcpy(huge.data() + offsetof(ColumnarHeader, mrows), &rows, sizeof(rows));
+        INFO(W("16. row count overflow")); CHECK(!ColumnarReader().open(huge));
+        rows = std::uint64_t{ 1 } << 40;
+        std::memcpy(huge.data() + offsetof(ColumnarHeader, mrows), &rows, sizeof(rows));
+        ColumnarReader rhuge;
+        REQUIRE(rhuge.open(huge));
+        INFO(W("17. output too small")); CHECK(!rhuge.read_records(std::span<std::byte>()));
+        INFO(W("18. chunks do not match the rows")); CHECK(rhuge.view_column<std::int64_t>(0).empty());
+
+        ColumnarWriter empty(SAMPLE_COLUMNS, sizeof(Sample));
+        BinaryBuffer eb;
+        REQUIRE(empty.write(eb));
+        INFO(W("19. empty")); CHECK((r.open(eb.data()) && r.rows() == 0 && r.read_column(1, std::span<std::int32_t>())));
+    }
+
+    TEST_CASE("ColumnarMappedFile", "[columnar]")
+    {
+        Path out = test_file(W("Columnar"), W("samples.pdcf"));
+
+        const std::vector<Sample> samples = make_samples(5000);
+        ColumnarWriter w(SAMPLE_COLUMNS, sizeof(Sample));
+        w.add(std::span<const Sample>(samples));
+        REQUIRE(w.save_to_file(out.s()));
+
+        MappedBinaryBuffer mbb;
+        REQUIRE(mbb.open(out.s(), MappedBinaryBuffer::Mode::READ_ONLY, MappedBinaryBuffer::Advice::RANDOM));
+        ColumnarReader r;
+        REQUIRE(r.open(mbb.data()));
+        std::int64_t sum = 0, expected = 0;
+        for (std::int64_t id : r.view_column<std::int64_t>(r.find("mid"))) sum += id;
+        for (const Sample& s : samples) expected += s.mid;
+        INFO(W("0. column scan over the mapping")); CHECK((r.rows() == samples.size() && sum == expected));
+    }
+
+    TEST_CASE("ColumnarBenchmark", "[.][columnar][benchmark]")
+    {
+        const size_t N = 1'000'000;
+        const std::vector<Sample> samples = make_samples(N);
+
+        BinaryBuffer rows;
+        rows.write(std::as_bytes(std::span<const Sample>(samples)));
+
+        ColumnarWriter w(SAMPLE_COLUMNS, sizeof(Sample));
+        w.add(std::span<const Sample>(samples));
+        BinaryBuffer cols;
+        REQUIRE(w.write(cols));
+        ColumnarReader r;
+        REQUIRE(r.open(cols.data()));
+
+        std::vector<Sample> records(N);
+        std::vector<std::int32_t> qty(N);
+
+        BENCHMARK("row read, sum of one member")
+        {
+            rows.rewind();
+            rows.read(std::as_writable_bytes(std::span<Sample>(records)));
+            std::int64_t sum = 0;
+            for (const Sample& s : records) sum += s.mqty;
+            return sum;
+        };
+
+        BENCHMARK("column read (RLE), sum of one member")
+        {
+            (void)r.read_column(1, std::span<std::int32_t>(qty));
+            std::int64_t sum = 0;
+            for (std::int32_t q : qty) sum += q;
+            return sum;
+        };
+    }
+}
@@ -285,4 +285,32 @@ namespace pensar_digital::cpplib
         cmd2.read(buffer);
         INFO(W("1")); CHECK(cmd2 == cmd);
     }
+
+    TEST_CASE("CompositeCmdCompactTypes", "[command]")
+    {
+        using Cmd = CompositeCommand;
+
+        Cmd cmd;
+        for (size_t i = 0; i < Cmd::MAX_COMMANDS; ++i)
+            cmd.add(new NullCommand());
+        BinaryBuffer full;
+        cmd.write(full);
+        BinaryBuffer buffer;
+        buffer.set_compact_types(true);
+        cmd.write(buffer);
+        INFO(W("0. type tags shrink the payload")); CHECK(buffer.size() * 4 < full.size());
+
+        Cmd cmd2;
+        INFO(W("1. own tag")); CHECK(Cmd::INFO.read_tag(buffer));
+        cmd2.read(buffer);
+        INFO(W("2. children created from their type ids")); CHECK(cmd2 == cmd);
+        INFO(W("3. consumed")); CHECK((buffer.ok() && buffer.remaining() == 0));
+
+        // Read again: the type table is rebuilt from the definitions in the stream.
+        Cmd cmd3;
+        buffer.rewind();
+        INFO(W("4. own tag again")); CHECK(Cmd::INFO.read_tag(buffer));
+        cmd3.read(buffer);
+        INFO(W("5. rewind")); CHECK(cmd3 == cmd);
+    }
 }
@@ -0,0 +1,183 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "test_helpers.hpp"
+
+#include "../compression.hpp"
+#include "../frame.hpp"
+#include "../object.hpp"
+#include "../binary_buffer.hpp"
+#include "../framed_io.hpp"
+
+#include <vector>
+#include <random>
+#include <string>
+#include <iterator>
+#include <cstdint>
+
+namespace pensar_digital::cpplib
+{
+    using namespace test_helpers;
+
+    // Serialized objects: the redundant data compression is for.
+    static std::vector<std::byte> object_snapshot(size_t count)
+    {
+        BinaryBuffer bb;
+        for (size_t i = 0; i < count; ++i) Object(static_cast<Id>(i)).write(bb);
+        return std::vector<std::byte>(bb.data().begin(), bb.data().end());
+    }
+
+    static std::vector<std::byte> random_bytes(size_t n, unsigned seed)
+    {
+        std::mt19937 gen(seed);
+        std::vector<std::byte> v(n);
+        for (std::byte& b : v) b = static_cast<std::byte>(gen());
+        return v;
+    }
+
+    static bool round_trip(Codec codec, std::span<const std::byte> data, size_t* compressed_size = nullptr)
+    {
+        std::vector<std::byte> block(compress_bound(data.size()));
+        block.resize(compress_block(codec, data, block));
+        if (compressed_size) *compressed_size = block.size();
+        std::vector<std::byte> back(block_raw_size(block));
+        Result<size_t> n = decompress_block(block, back);
+        return n && n.mresult == data.size() && std::ranges::equal(back, data);
+    }
+
+    TEST_CASE("Compression", "[compression]")
+    {
+        const std::vector<std::byte> snapshot = object_snapshot(10000);
+        const std::vector<std::byte> noise = random_bytes(5000, 1);
+        std::vector<std::byte> runs(100000, std::byte{ 0 });
+        for (size_t i = 0; i < runs.size(); i += 1000) runs[i] = std::byte{ 1 };
+
+        for (Codec codec : { Codec::FAST, Codec::HIGH })
+        {
+            bool ok = true;
+            for (size_t n : { 0, 1, 12, 13, 100 })
+                ok = ok && round_trip(codec, std::span(snapshot).first(n));
+            INFO(W("0. short inputs, codec ") << static_cast<int>(codec)); CHECK(ok);
+
+            size_t size = 0;
+            INFO(W("1. objects")); CHECK(round_trip(codec, snapshot, &size));
+            INFO(W("2. objects shrink several fold")); CHECK(size * 4 < snapshot.size());
+            INFO(W("3. runs and long matches")); CHECK((round_trip(codec, runs, &size) && size * 50 < runs.size()));
+            INFO(W("4. noise is stored")); CHECK((round_trip(codec, noise, &size) && size == noise.size() + BLOCK_HEADER_SIZE));
+        }
+
+        // Text from a small vocabulary: short, scattered matches that hash chains find.
+        std::string text;
+        std::mt19937 words(3);
+        const char* const VOCABULARY[] = { "class ", "object ", "command ", "buffer ", "read ", "write ", "size_t ", "const ",
+                                           "return ", "value ", "id ", "bool ", "span ", "data ", "(", ");\n", "{\n", "}\n" };
+        while (text.size() < 100000) text += VOCABULARY[words() % std::size(VOCABULARY)];
+        const std::span<const std::byte> text_bytes = std::as_bytes(std::span(text.data(), text.size()));
+        size_t fast = 0, high = 0;
+        INFO(W("5. text")); CHECK((round_trip(Codec::FAST, text_bytes, &fast) && round_trip(Codec::HIGH, text_bytes, &high)));
+        INFO(W("6. HIGH smaller than FAST")); CHECK(high < fast);
+
+        std::vector<std::byte> block(compress_bound(snapshot.size()));
+        block.resize(compress_block(Codec::FAST, snapshot, block));
+        std::vector<std::byte> back(snapshot.size());
+        INFO(W("7. destination too small")); CHECK(!decompress_block(block, std::span(back).first(snapshot.size() - 1)));
+        INFO(W("8. truncated")); CHECK(!decompress_block(std::span(block).first(block.size() - 1), back));
+
+        // Damaged blocks must be rejected or decode to something, never write out of bounds.
+        std::mt19937 gen(7);
+        bool rejected = false;
+        for (int i = 0; i < 1000; ++i)
+        {
+            std::vector<std::byte> bad = block;
+            bad[BLOCK_HEADER_SIZE + gen() % (bad.size() - BLOCK_HEADER_SIZE)] ^= static_cast<std::byte>(1 + gen() % 255);
+            rejected = !decompress_block(bad, back) || rejected;
+        }
+        INFO(W("9. damaged blocks")); CHECK(rejected);
+    }
+
+    TEST_CASE("CompressionFramed", "[compression]")
+    {
+        const std::vector<std::byte> snapshot = object_snapshot(20000);
+        for (Codec codec : { Codec::NONE, Codec::FAST, Codec::HIGH })
+        {
+            std::vector<std::byte> framed;
+            frame(snapshot, framed, 64 * 1024, codec, 4);
+
+            std::vector<std::byte> back;
+            INFO(W("0. sequential, codec ") << static_cast<int>(codec)); CHECK(unframe(framed, [&](std::span<const std::byte> p) { back.insert(back.end(), p.begin(), p.end()); }));
+            INFO(W("1. same bytes")); CHECK(back == snapshot);
+
+            FrameIndex index;
+            REQUIRE(index.build(framed));
+            std::vector<std::byte> parallel(index.mraw_size);
+            INFO(W("2. parallel")); CHECK((unframe_parallel(framed, index, parallel, 4) && parallel == snapshot));
+
+            framed[framed.size() / 2] ^= std::byte{ 0x20 };
+            REQUIRE(index.build(framed)); // Headers intact unless the flip hit one.
+            INFO(W("3. corruption detected")); CHECK(!unframe_parallel(framed, index, parallel, 4));
+        }
+
+        // A block header may not claim more bytes than its payload can decode to, nor the
+        // stream more than the caller allows: both are checked before anything is allocated.
+        std::vector<std::byte> small;
+        frame(std::vector<std::byte>(100), small, 64 * 1024, Codec::FAST);
+        FrameIndex index;
+        INFO(W("4. limit")); CHECK((index.build(small, 100) && !index.build(small, 99)));
+        const size_t raw_size_pos = sizeof(FrameFileHeader) + sizeof(FrameHeader) + 1;
+        small[raw_size_pos + 2] = std::byte{ 0x01 }; // 64 KiB more, from a payload of a few bytes.
+        INFO(W("5. inflated block size")); CHECK(!index.build(small));
+
+        Path out = test_file(W("Compression"), W("objects.pdfr"));
+        BinaryBuffer bb;
+        bb.write(std::span<const std::byte>(snapshot));
+        REQUIRE(save_framed(bb, out.s(), 64 * 1024, Codec::FAST));
+        BinaryBuffer in;
+        REQUIRE(load_framed(in, out.s()));
+        INFO(W("6. BinaryBuffer round trip")); CHECK(std::ranges::equal(in.data(), bb.data()));
+    }
+
+    TEST_CASE("CompressionBenchmark", "[.][compression][benchmark]")
+    {
+        const std::vector<std::byte> snapshot = object_snapshot(1'000'000);
+        std::vector<std::byte> framed_fast, framed_high;
+        frame(snapshot, framed_fast, DEFAULT_FRAME_BLOCK, Codec::FAST);
+        frame(snapshot, framed_high, DEFAULT_FRAME_BLOCK, Codec::HIGH);
+        INFO(W("0. ratio")); CHECK((framed_high.size() <= framed_fast.size() && framed_fast.size() * 4 < snapshot.size()));
+        FrameIndex index;
+        REQUIRE(index.build(framed_fast));
+        std::vector<std::byte> out(index.mraw_size);
+
+        BENCHMARK("FAST, 1 thread")
+        {
+            std::vector<std::byte> f;
+            frame(snapshot, f, DEFAULT_FRAME_BLOCK, Codec::FAST, 1);
+            return f.size();
+        };
+
+        BENCHMARK("FAST, all threads")
+        {
+            std::vector<std::byte> f;
+            frame(snapshot, f, DEFAULT_FRAME_BLOCK, Codec::FAST);
+            return f.size();
+        };
+
+        BENCHMARK("HIGH, all threads")
+        {
+            std::vector<std::byte> f;
+            frame(snapshot, f, DEFAULT_FRAME_BLOCK, Codec::HIGH);
+            return f.size();
+        };
+
+        BENCHMARK("decompress, 1 thread")
+        {
+            return unframe_parallel(framed_fast, index, out, 1).mok;
+        };
+
+        BENCHMARK("decompress, all threads")
+        {
+            return unframe_parallel(framed_fast, index, out).mok;
+        };
+    }
+}
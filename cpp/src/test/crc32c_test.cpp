@@ -0,0 +1,54 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "test_helpers.hpp"
+
+#include "../crc32c.hpp"
+
+#include <vector>
+#include <string_view>
+
+namespace pensar_digital::cpplib
+{
+    using namespace test_helpers;
+
+    static std::span<const std::byte> crc_bytes(std::string_view s) { return std::as_bytes(std::span(s.data(), s.size())); }
+
+    TEST_CASE("Crc32c", "[crc32c]")
+    {
+        INFO(W("0. check value")); CHECK(crc32c(crc_bytes("123456789")) == 0xE3069283u);
+        INFO(W("1. scalar check value")); CHECK(crc32c_scalar(crc_bytes("123456789")) == 0xE3069283u);
+        INFO(W("2. empty")); CHECK(crc32c({}) == 0u);
+
+        std::vector<std::byte> data(4099);
+        for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<std::byte>(i * 131 + (i >> 7));
+        const std::span<const std::byte> all(data);
+        bool same = true;
+        for (size_t n : { 1, 7, 8, 9, 63, 64, 4096, 4099 })
+            same = same && crc32c(all.first(n)) == crc32c_scalar(all.first(n)) && crc32c(all.subspan(1, n - 1)) == crc32c_scalar(all.subspan(1, n - 1));
+        INFO(W("3. kernels agree, any length and alignment")); CHECK(same);
+        INFO(W("4. chaining")); CHECK(crc32c(all.subspan(1000), crc32c(all.first(1000))) == crc32c(all));
+
+        const std::uint32_t before = crc32c(data);
+        data[2000] ^= std::byte{ 0x10 };
+        INFO(W("5. detects a flipped bit")); CHECK(crc32c(data) != before);
+    }
+
+    TEST_CASE("Crc32cBenchmark", "[.][crc32c][benchmark]")
+    {
+        std::vector<std::byte> data(16 << 20);
+        for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<std::byte>(i * 131);
+
+        BENCHMARK("crc32c, 16 MiB")
+        {
+            return crc32c(data);
+        };
+
+        BENCHMARK("crc32c_scalar, 16 MiB")
+        {
+            return crc32c_scalar(data);
+        };
+    }
+}
@@ -0,0 +1,148 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "../delta.hpp"
+#include "../object.hpp"
+#include "../binary_buffer.hpp"
+#include "../crc32c.hpp"
+
+#include <vector>
+#include <random>
+#include <utility>
+
+namespace pensar_digital::cpplib
+{
+    static std::vector<std::pair<size_t, size_t>> delta_runs(const std::vector<std::byte>& a, const std::vector<std::byte>& b)
+    {
+        std::vector<std::pair<size_t, size_t>> runs;
+        delta::for_each_run(a, b, [&runs](size_t at, size_t length) { runs.emplace_back(at, length); });
+        return runs;
+    }
+
+    TEST_CASE("DeltaRuns", "[delta]")
+    {
+        std::vector<std::byte> base(1000);
+        for (size_t i = 0; i < base.size(); ++i) base[i] = static_cast<std::byte>(i * 7);
+
+        std::vector<std::byte> cur = base;
+        INFO("0. equal, no runs"); CHECK(delta_runs(cur, base).empty());
+        INFO("1. first_difference of equal"); CHECK(delta::first_difference(cur.data(), base.data(), 0, cur.size()) == cur.size());
+
+        // Every position, so each SIMD, word and tail lane is hit.
+        bool found = true;
+        for (size_t i = 0; i < cur.size(); ++i)
+        {
+            cur[i] ^= std::byte{ 0x10 };
+            found = found && delta::first_difference(cur.data(), base.data(), 0, cur.size()) == i;
+            cur[i] ^= std::byte{ 0x10 };
+        }
+        INFO("2. first_difference finds every position"); CHECK(found);
+
+        cur[17] ^= std::byte{ 1 };
+        cur[18] ^= std::byte{ 1 };
+        cur[20] ^= std::byte{ 1 };             // Gap of 1: merged.
+        cur[500] ^= std::byte{ 1 };            // Far: its own run.
+        cur[999] ^= std::byte{ 1 };            // Last byte.
+        const auto runs = delta_runs(cur, base);
+        INFO("3. runs"); CHECK(runs == (std::vector<std::pair<size_t, size_t>>{ { 17, 4 }, { 500, 1 }, { 999, 1 } }));
+    }
+
+    TEST_CASE("DeltaRandom", "[delta]")
+    {
+        // Replaying the runs over the baseline rebuilds the current bytes.
+        std::mt19937 rng(42);
+        for (int round = 0; round < 200; ++round)
+        {
+            const size_t n = rng() % 300;
+            std::vector<std::byte> base(n), cur(n);
+            for (size_t i = 0; i < n; ++i) base[i] = static_cast<std::byte>(rng());
+            cur = base;
+            const size_t changes = n == 0 ? 0 : rng() % 8;
+            for (size_t c = 0; c < changes; ++c) cur[rng() % n] = static_cast<std::byte>(rng());
+
+            std::vector<std::byte> rebuilt = base;
+            size_t last_end = 0;
+            bool ordered = true;
+            delta::for_each_run(cur, base, [&](size_t at, size_t length)
+            {
+                ordered = ordered && at >= last_end && length > 0;
+                for (size_t k = at; k < at + length; ++k) rebuilt[k] = cur[k];
+                last_end = at + length;
+            });
+            INFO("round " << round); CHECK(ordered); CHECK(rebuilt == cur);
+        }
+    }
+
+    TEST_CASE("ObjectDelta", "[delta]")
+    {
+        Object o(1);
+        Object replica(1);
+        const Object baseline = o;
+        o = Object(123456);
+        BinaryBuffer bb;
+        Object::Serializer::write_delta(o, baseline, bb);
+        Object::Serializer::read_delta(replica, bb);
+        INFO("0. applied"); CHECK((bb.ok() && replica.id() == 123456));
+
+        SECTION("wrong baseline")
+        {
+            Object other(2);
+            bb.rewind();
+            Object::Serializer::read_delta(other, bb);
+            INFO("1. rejected"); CHECK(bb.error() == BufferError::INVALID_DATA);
+            INFO("2. unchanged"); CHECK(other.id() == 2);
+        }
+        SECTION("run past the record")
+        {
+            BinaryBuffer bad;
+            Object::INFO.write_tag(bad);
+            std::uint32_t crc = crc32c(std::span<const std::byte>(reinterpret_cast<const std::byte*>(replica.data()), Object::DATA_SIZE));
+            bad.write(crc);
+            bad.write_varint(Object::DATA_SIZE);
+            bad.write_varint(size_t{ 1 });
+            bad.write(std::byte{ 0 });
+            Object::Serializer::read_delta(replica, bad);
+            INFO("3. rejected"); CHECK(bad.error() == BufferError::INVALID_DATA);
+            INFO("4. unchanged"); CHECK(replica.id() == 123456);
+        }
+        SECTION("truncated")
+        {
+            BinaryBuffer cut;
+            cut.write(bb.data().first(bb.size() - 1));
+            Object::Serializer::read_delta(replica, cut);
+            INFO("5. fails"); CHECK(!cut.ok());
+            INFO("6. unchanged"); CHECK(replica.id() == 123456);
+        }
+    }
+
+    TEST_CASE("DeltaBenchmark", "[.][delta][benchmark]")
+    {
+        // A 4 KiB record with one changed field.
+        std::vector<std::byte> base(4096, std::byte{ 1 });
+        std::vector<std::byte> cur = base;
+        cur[2050] = std::byte{ 2 };
+        BinaryBuffer bb;
+
+        BENCHMARK("full record, 4 KiB")
+        {
+            bb.clear();
+            bb.write(std::span<const std::byte>(cur));
+            return bb.size();
+        };
+
+        BENCHMARK("delta runs, 4 KiB, one change")
+        {
+            bb.clear();
+            delta::for_each_run(cur, base, [&](size_t at, size_t length)
+            {
+                bb.write_varint(at);
+                bb.write_varint(length);
+                bb.write(std::span<const std::byte>(cur).subspan(at, length));
+            });
+            return bb.size();
+        };
+    }
+}
@@ -2,11 +2,15 @@
 // license: MIT (https://opensource.org/licenses/MIT)
 
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
 
 #include "../factory.hpp"
 #include "../s.hpp"
 #include "../object.hpp"
 #include <memory>
+#include <thread>
+#include <vector>
+#include <atomic>
 
 namespace pensar_digital::cpplib
 {
@@ -55,16 +59,18 @@ namespace pensar_digital::cpplib
         PoolFactory<Object, Object::DataType> factory(3, 10, {1});
         {
             size_t count = factory.get_available_count();
-            Object::Ptr ptr;
+            std::vector<Object::Ptr> ptrs;
             for (size_t i = 0; i < count; i++)
             {
-                ptr = factory.get({1});
+                ptrs.push_back(factory.get({1}));
                 INFO(W("0."));
                 CHECK(factory.get_available_count() == factory.get_pool_size() - i - 1);
             }
             INFO(W("0.1. available_count should be 0 but is ") + pd::to_string((int)factory.get_available_count()));
             CHECK(factory.get_available_count() == 0);
         }
+        INFO(W("0.2. released objects return to the pool"));
+        CHECK(factory.get_available_count() == factory.get_pool_size());
         factory.reset(3, 10, 0);
 
         INFO(W("1. available_count should be 3 but is ") + pd::to_string((int)factory.get_available_count()));
@@ -96,7 +102,165 @@ namespace pensar_digital::cpplib
         INFO(W("9. *o != *o1 should be true.")); CHECK(*o != *o1);
 
         o.reset();
-        INFO(W("10. managed object should have been deleted and assigned to nullptr."));
+        INFO(W("10. pointer should have been reset to nullptr."));
         CHECK(o.get() == nullptr);
+        INFO(W("11. the object returned to the pool."));
+        CHECK(factory.get_available_count() == 10);
+
+        Object::Ptr o4 = factory.get({5});
+        INFO(W("12. a released object is reused, reinitialized."));
+        CHECK((o4->id() == 5 && factory.get_available_count() == 9));
+
+        const NewFactory<Object, Object::DataType>& base = factory;
+        Object::Ptr o5 = base.get({6});
+        INFO(W("13. get overrides NewFactory::get."));
+        CHECK((o5->id() == 6 && factory.get_available_count() == 8));
+
+        Factory<Object, Object::DataType> fresh(3, 10, {1});
+        INFO(W("14. Factory defaults to newly constructed objects, not a pool."));
+        CHECK(dynamic_cast<ConcurrentPoolFactory<Object, Object::DataType>*>(&fresh.get_factory()) == nullptr);
+    }
+
+    TEST_CASE("PoolFactoryLifetime", "[factory]")
+    {
+        Object::Ptr kept;
+        {
+            PoolFactory<Object, Object::DataType> factory(2, 2, {1});
+            kept = factory.get({7});
+            Object::Ptr copy = kept;
+            INFO(W("0. copies share the object")); CHECK(copy.use_count() == 2);
+
+            // Many get/release rounds reuse the same two slots.
+            for (int i = 0; i < 1000; ++i) { Object::Ptr p = factory.get({i}); }
+            INFO(W("1. no growth")); CHECK(factory.get_pool_size() == 2);
+
+            factory.reset(1, 1, {0});
+            INFO(W("2. reset pool")); CHECK((factory.get_pool_size() == 1 && factory.get_available_count() == 1));
+        }
+        // Factory gone: the object in use is still valid and is freed with the last pointer.
+        INFO(W("3. outlives the factory")); CHECK(kept->id() == 7);
+        kept.reset();
+    }
+
+    TEST_CASE("ConcurrentPoolFactory", "[factory]")
+    {
+        using Pool = ConcurrentPoolFactory<Object, Object::DataType>;
+        auto pool = std::make_shared<Pool>(100, 50, Object::DataType{ 1 });
+        INFO(W("0. initial pool")); CHECK((pool->get_pool_size() == 100 && pool->get_available_count() == 100));
+
+        {
+            Object::Ptr o = pool->get({ 7 });
+            INFO(W("1. initialized")); CHECK(o->id() == 7);
+            INFO(W("2. taken")); CHECK(pool->get_available_count() == 99);
+        }
+        INFO(W("3. returned")); CHECK(pool->get_available_count() == 100);
+
+        // Through the Factory hook.
+        Factory<Object, Object::DataType> factory(3, 10, Object::DataType{ 0 });
+        factory.set_factory(pool);
+        Object::Ptr o = factory.get({ 9 });
+        INFO(W("4. Factory uses the pool")); CHECK((o->id() == 9 && pool->get_available_count() == 99));
+        o.reset();
+
+        // Threads take and release, also objects taken by other threads.
+        constexpr size_t THREADS = 4, ROUNDS = 20'000;
+        std::vector<Object::Ptr> handoff(THREADS * 100);
+        for (size_t i = 0; i < handoff.size(); ++i) handoff[i] = pool->get({ static_cast<Id>(i) });
+        std::atomic<bool> ok{ true };
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < THREADS; ++t)
+            threads.emplace_back([&, t]
+            {
+                for (size_t i = 0; i < 100; ++i) handoff[t * 100 + i].reset(); // Taken on the main thread.
+                std::vector<Object::Ptr> held;
+                for (size_t r = 0; r < ROUNDS; ++r)
+                {
+                    const Id id = static_cast<Id>(t * ROUNDS + r);
+                    held.push_back(pool->get({ id }));
+                    if (held.back()->id() != id) ok = false;
+                    if (held.size() == 300) held.clear();
+                }
+            });
+        for (std::thread& t : threads) t.join();
+        INFO(W("5. every get saw its own object")); CHECK(ok);
+        // Exited threads flushed their caches to the depot.
+        INFO(W("6. all back")); CHECK(pool->get_available_count() == pool->get_pool_size());
+
+        // Released after the pool is gone.
+        Object::Ptr kept = pool->get({ 11 });
+        factory.set_factory(nullptr);
+        pool.reset();
+        INFO(W("7. outlives the pool")); CHECK(kept->id() == 11);
+
+        // Threads release their last objects, and exit, after the pool is gone: the last one
+        // back frees the pool, once.
+        pool = std::make_shared<Pool>(10, 10, Object::DataType{ 1 });
+        std::vector<std::vector<Object::Ptr>> late(THREADS);
+        for (size_t i = 0; i < 300; ++i) late[i % THREADS].push_back(pool->get({ static_cast<Id>(i) }));
+        std::atomic<size_t> ready{ 0 };
+        std::atomic<bool> go{ false };
+        threads.clear();
+        for (size_t t = 0; t < THREADS; ++t)
+            threads.emplace_back([&, t, p = pool]() mutable
+            {
+                Object::Ptr own = p->get({ 12 }); // Gives the thread a cache on the pool.
+                p.reset();
+                ++ready;
+                while (!go) std::this_thread::yield();
+                own.reset();
+                late[t].clear();
+            });
+        while (ready < THREADS) std::this_thread::yield();
+        pool.reset();
+        go = true;
+        for (std::thread& t : threads) t.join();
+        INFO(W("8. released by threads after the pool is gone")); CHECK(kept->id() == 11);
+    }
+
+    TEST_CASE("PoolFactoryBenchmark", "[.][factory][benchmark]")
+    {
+        // Tens of thousands of objects in use: get () no longer scans the pool.
+        constexpr size_t IN_USE = 50'000;
+        PoolFactory<Object, Object::DataType> factory(IN_USE + 1000, 1000, {1});
+        std::vector<Object::Ptr> in_use;
+        for (size_t i = 0; i < IN_USE; ++i) in_use.push_back(factory.get({1}));
+
+        BENCHMARK("PoolFactory get/release, 50k in use")
+        {
+            Object::Ptr p = factory.get({2});
+            return p->id();
+        };
+
+        BENCHMARK("make_shared/release")
+        {
+            Object::Ptr p = std::make_shared<Object>(2);
+            return p->id();
+        };
+    }
+
+    TEST_CASE("ConcurrentPoolFactoryBenchmark", "[.][factory][benchmark]")
+    {
+        // Each thread gets and releases in a loop: the pool scales with cores, make_shared with malloc.
+        const unsigned threads = (std::max)(2u, std::thread::hardware_concurrency());
+        constexpr size_t ROUNDS = 100'000;
+        auto run = [threads](auto&& get)
+        {
+            std::vector<std::thread> workers;
+            for (unsigned t = 0; t < threads; ++t)
+                workers.emplace_back([&] { for (size_t r = 0; r < ROUNDS; ++r) { Object::Ptr p = get(); } });
+            for (std::thread& w : workers) w.join();
+            return threads * ROUNDS;
+        };
+        ConcurrentPoolFactory<Object, Object::DataType> pool(1024, 256, { 1 });
+
+        BENCHMARK("ConcurrentPoolFactory get/release, all threads")
+        {
+            return run([&pool] { return pool.get({ 2 }); });
+        };
+
+        BENCHMARK("make_shared/release, all threads")
+        {
+            return run([] { return std::make_shared<Object>(2); });
+        };
     }
 }
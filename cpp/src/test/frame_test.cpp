@@ -0,0 +1,71 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#include <catch2/catch_test_macros.hpp>
+#include "test_helpers.hpp"
+
+#include "../frame.hpp"
+#include "../framed_io.hpp"
+
+#include <vector>
+#include <cstdint>
+
+namespace pensar_digital::cpplib
+{
+    using namespace test_helpers;
+
+    TEST_CASE("Frame", "[frame]")
+    {
+        std::vector<std::byte> data(10000);
+        for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<std::byte>(i * 7);
+
+        std::vector<std::byte> framed;
+        frame(data, framed, 4096);
+        INFO(W("0. size")); CHECK(framed.size() == framed_size(data.size(), 4096));
+
+        std::vector<std::byte> back;
+        size_t frames = 0;
+        auto collect = [&](std::span<const std::byte> payload) { back.insert(back.end(), payload.begin(), payload.end()); ++frames; };
+        INFO(W("1. verified")); CHECK(unframe(framed, collect));
+        INFO(W("2. payload")); CHECK((back == data && frames == 3));
+
+        auto ignore = [](std::span<const std::byte>) {};
+        std::vector<std::byte> bad = framed;
+        bad[sizeof(FrameFileHeader) + sizeof(FrameHeader) + 5000] ^= std::byte{ 0x80 };
+        INFO(W("3. corrupt payload")); CHECK(!unframe(bad, ignore));
+        bad = framed;
+        bad[8] ^= std::byte{ 0x01 };
+        INFO(W("4. corrupt file header")); CHECK(!unframe(bad, ignore));
+        INFO(W("5. truncated")); CHECK(!unframe(std::span(framed).first(framed.size() - 1), ignore));
+        INFO(W("6. end frame missing")); CHECK(!unframe(std::span(framed).first(framed.size() - 16), ignore));
+        bad = framed;
+        bad[bad.size() - 8] ^= std::byte{ 0x01 };
+        INFO(W("7. corrupt total")); CHECK(!unframe(bad, ignore));
+
+        std::vector<std::byte> empty;
+        frame({}, empty);
+        INFO(W("8. empty stream")); CHECK((empty.size() == FRAME_OVERHEAD && unframe(empty, ignore)));
+    }
+
+    TEST_CASE("FrameBinaryBuffer", "[frame]")
+    {
+        Path out = test_file(W("Frame"), W("buffer.pdfr"));
+
+        BinaryBuffer bb;
+        for (std::int64_t i = 0; i < 10000; ++i) bb.write(i);
+        REQUIRE(save_framed(bb, out.s(), 1000));
+
+        BinaryBuffer in;
+        REQUIRE(load_framed(in, out.s()));
+        INFO(W("0. same bytes")); CHECK(std::ranges::equal(in.data(), bb.data()));
+
+        BinaryBuffer raw;
+        REQUIRE(raw.load_from_file(out.s()));
+        std::vector<std::byte> bytes(raw.data().begin(), raw.data().end());
+        bytes[bytes.size() / 2] ^= std::byte{ 0x04 };
+        raw.clear();
+        raw.write(std::span<const std::byte>(bytes));
+        REQUIRE(raw.save_to_file(out.s()));
+        INFO(W("1. corruption detected")); CHECK((!load_framed(in, out.s()) && in.size() == 0));
+    }
+}
@@ -2,6 +2,7 @@
 // license: MIT (https://opensource.org/licenses/MIT)
 
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include "test_helpers.hpp"
 
 #include "../generator.hpp"
@@ -10,6 +11,10 @@
 #include "../binary_buffer.hpp"
 
 #include <sstream>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <algorithm>
 
 namespace pensar_digital::cpplib
 {
@@ -126,4 +131,111 @@ namespace pensar_digital::cpplib
         bb.read(g2);
         INFO("1"); CHECK(g2 == g);
     }
+
+    TEST_CASE("GeneratorDelta", "[generator]")
+    {
+        typedef Generator<Object> G;
+        G g(1, 1000, 1);
+        G replica;
+        BinaryBuffer full;
+        g.write(full);
+        replica.read(full);
+        REQUIRE(replica == g);
+
+        const G baseline = g;
+        for (int i = 0; i < 5; ++i) g.get_id();
+        BinaryBuffer bb;
+        g.write_delta(baseline, bb);
+        INFO(W("0. smaller than the record")); CHECK(bb.size() < full.size());
+
+        replica.read_delta(bb);
+        INFO(W("1. applied")); CHECK((bb.ok() && bb.remaining() == 0));
+        INFO(W("2. same value")); CHECK(replica.current() == g.current());
+        INFO(W("3. equal")); CHECK(replica == g);
+
+        // Unchanged: the delta carries no runs.
+        BinaryBuffer none;
+        g.write_delta(g, none);
+        replica.read_delta(none);
+        INFO(W("4. empty delta")); CHECK((none.ok() && replica.current() == g.current()));
+    }
+
+    TEST_CASE("GeneratorConcurrent", "[generator]")
+    {
+        // Half the threads draw shared ids, half draw from their own blocks.
+        using G = Generator<Object>;
+        G g(1, 0, 1);
+        constexpr size_t THREADS = 4, PER_THREAD = 50'000;
+        std::vector<std::vector<Id>> ids(THREADS);
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < THREADS; ++t)
+            threads.emplace_back([&, t]
+            {
+                ids[t].reserve(PER_THREAD);
+                for (size_t i = 0; i < PER_THREAD; ++i)
+                    ids[t].push_back(t % 2 == 0 ? g.get_id() : g.get_local_id(100));
+            });
+        for (std::thread& t : threads) t.join();
+
+        std::vector<Id> all;
+        for (auto& v : ids) all.insert(all.end(), v.begin(), v.end());
+        std::sort(all.begin(), all.end());
+        INFO(W("0. no id drawn twice")); CHECK(std::adjacent_find(all.begin(), all.end()) == all.end());
+        INFO(W("1. all drawn from the generator")); CHECK((all.front() > 0 && all.back() <= g.current()));
+        bool increasing = true;
+        for (auto& v : ids)
+            for (size_t i = 1; i < v.size(); ++i) increasing = increasing && v[i] > v[i - 1];
+        INFO(W("2. increasing within a thread")); CHECK(increasing);
+    }
+
+    TEST_CASE("GeneratorReserve", "[generator]")
+    {
+        using G = Generator<Object>;
+        G g(1, 10, 5);
+        const G::IdRange r = g.reserve(4);
+        INFO(W("0. the ids get_id would give")); CHECK((r.mfirst == 15 && r[3] == 30 && r.mcount == 4));
+        INFO(W("1. value moved past the block")); CHECK(g.get_id() == 35);
+        INFO(W("2. empty")); CHECK(g.reserve(0).empty());
+
+        // Persistence is unchanged: the current value round-trips.
+        BinaryBuffer bb;
+        g.write(bb);
+        G g2;
+        g2.read(bb);
+        INFO(W("3. round-trip")); CHECK(g2.get_id() == 40);
+
+        // A copy draws its own blocks.
+        G g3(2, 1000, 1);
+        INFO(W("4. local id")); CHECK(g3.get_local_id(10) == 1001);
+        G g4 = g3;
+        INFO(W("5. copy continues from the shared value, not g3's block")); CHECK(g4.get_local_id(10) == 1011);
+        INFO(W("6. g3 keeps its block")); CHECK(g3.get_local_id(10) == 1002);
+    }
+
+    TEST_CASE("GeneratorBenchmark", "[.][generator][benchmark]")
+    {
+        using G = Generator<Object>;
+        G g(1, 0, 1);
+        const unsigned threads = (std::max)(2u, std::thread::hardware_concurrency());
+        constexpr size_t IDS = 1'000'000;
+        auto run = [threads](auto&& draw)
+        {
+            std::vector<std::thread> workers;
+            std::atomic<Id> sink{ 0 };
+            for (unsigned t = 0; t < threads; ++t)
+                workers.emplace_back([&] { Id s = 0; for (size_t i = 0; i < IDS; ++i) s += draw(); sink += s; });
+            for (std::thread& w : workers) w.join();
+            return sink.load();
+        };
+
+        BENCHMARK("get_id, 1M ids per thread, all threads")
+        {
+            return run([&g] { return g.get_id(); });
+        };
+
+        BENCHMARK("get_local_id, 1M ids per thread, all threads")
+        {
+            return run([&g] { return g.get_local_id(); });
+        };
+    }
 }
@@ -0,0 +1,94 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#include <catch2/catch_test_macros.hpp>
+#include "test_helpers.hpp"
+
+#include "../object.hpp"
+#include "../binary_buffer.hpp"
+#include "../mapped_binary_buffer.hpp"
+
+#include <cstdint>
+
+namespace pensar_digital::cpplib
+{
+    using namespace test_helpers;
+
+    TEST_CASE("MappedBinaryBufferRoundTrip", "[mapped_binary_buffer]")
+    {
+        Path out = test_file(W("MappedBinaryBuffer"), W("mapped_round_trip.bin"));
+
+        const size_t COUNT = 1000;
+        {
+            MappedBinaryBuffer mbb;
+            REQUIRE(mbb.open(out.s(), MappedBinaryBuffer::Mode::READ_WRITE));
+            for (size_t i = 0; i < COUNT; ++i)
+            {
+                Object o(static_cast<Id>(i));
+                o.write(mbb);
+            }
+            INFO(W("0. written size")); CHECK(mbb.size() == COUNT * Object::SIZE);
+            REQUIRE(mbb.close());
+        }
+
+        MappedBinaryBuffer mbb;
+        REQUIRE(mbb.open(out.s()));
+        INFO(W("1. file trimmed to written size")); CHECK(mbb.size() == COUNT * Object::SIZE);
+
+        Object o;
+        bool all_equal = true;
+        for (size_t i = 0; i < COUNT; ++i)
+        {
+            o.read(mbb);
+            all_equal = all_equal && (o.id() == static_cast<Id>(i));
+        }
+        INFO(W("2. objects read back")); CHECK(all_equal);
+        INFO(W("3. everything consumed")); CHECK(mbb.remaining() == 0);
+
+        mbb.write(std::int32_t{ 1 });
+        INFO(W("4. read-only mapping rejects writes")); CHECK(mbb.size() == COUNT * Object::SIZE);
+    }
+
+    TEST_CASE("MappedBinaryBufferAppend", "[mapped_binary_buffer]")
+    {
+        Path out = test_file(W("MappedBinaryBuffer"), W("mapped_append.bin"));
+
+        BinaryBuffer bb;
+        bb.write(std::int64_t{ 1 });
+        REQUIRE(bb.save_to_file(out.s()));
+
+        {
+            MappedBinaryBuffer mbb;
+            REQUIRE(mbb.open(out.s(), MappedBinaryBuffer::Mode::READ_WRITE));
+            INFO(W("0. existing bytes are kept")); CHECK(mbb.size() == sizeof(std::int64_t));
+            mbb.write(std::int64_t{ 2 });
+            REQUIRE(mbb.close());
+        }
+
+        REQUIRE(bb.load_from_file(out.s()));
+        std::int64_t a = 0, b = 0;
+        bb.read(a);
+        bb.read(b);
+        INFO(W("1. first value")); CHECK(a == 1);
+        INFO(W("2. appended value")); CHECK(b == 2);
+    }
+
+    TEST_CASE("BinaryBufferAttach", "[binary_buffer]")
+    {
+        std::byte memory[16] = {};
+        BinaryBuffer bb;
+        bb.attach(std::span<std::byte>(memory), 0);
+        bb.write(std::int64_t{ 42 });
+        INFO(W("0. written into attached memory")); CHECK(bb.data().data() == memory);
+
+        bb.write(std::int64_t{ 43 });
+        bb.write(std::int64_t{ 44 });
+        INFO(W("1. attached memory without grow function does not overflow")); CHECK(bb.size() == 16);
+
+        BinaryBuffer copy = bb;
+        INFO(W("2. copies own their bytes")); CHECK(!copy.is_attached());
+        std::int64_t x = 0;
+        copy.read(x);
+        INFO(W("3. copy content")); CHECK(x == 42);
+    }
+}
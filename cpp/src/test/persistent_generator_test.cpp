@@ -0,0 +1,130 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "test_helpers.hpp"
+
+#include "../persistent_generator.hpp"
+#include "../binary_buffer.hpp"
+
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+namespace pensar_digital::cpplib
+{
+    using namespace test_helpers;
+
+    // The file as a crash would leave it: what was synced, without close () recording the value.
+    static void copy_file(const Path& from, const Path& to)
+    {
+        BinaryBuffer bb;
+        bb.load_from_file(from.s());
+        bb.save_to_file(to.s());
+    }
+
+    TEST_CASE("PersistentGenerator", "[generator]")
+    {
+        using G = PersistentGenerator<Object>;
+        const Path file  = test_file(W("PersistentGenerator"), W("ids.bin"));
+        const Path crash = test_file(W("PersistentGenerator"), W("crash.bin"));
+
+        G closed(1, 0, 1);
+        INFO(W("0. not open")); CHECK(closed.get_id() == null_value<Id>());
+        INFO(W("1. error set")); CHECK(!closed.error());
+
+        G g(1, 0, 1);
+        REQUIRE(g.open(file.s(), 10));
+        INFO(W("2. open")); CHECK((g.is_open() && g.error()));
+
+        Id last = 0;
+        for (int i = 0; i < 15; ++i) last = g.get_id();
+        INFO(W("3. ids continue from the initial value")); CHECK(last == 15);
+        INFO(W("4. mark a chunk ahead")); CHECK(g.durable_limit() == 22);
+
+        // A crash: the file holds what was synced, not the value close () would record.
+        copy_file(file, crash);
+        {
+            G g2(1, 0, 1);
+            REQUIRE(g2.open(crash.s(), 10));
+            INFO(W("5. resumes past every id handed out")); CHECK(g2.get_id() == 23);
+        }
+
+        // A write torn by a crash. Mark 11 went to slot 1, mark 22 to slot 0.
+        copy_file(file, crash);
+        {
+            MappedFile f;
+            REQUIRE(f.open(crash.s(), MappedFile::Mode::READ_WRITE));
+            f.wbytes()[16] ^= std::byte{ 1 };
+            f.close();
+            G g2(1, 0, 1);
+            REQUIRE(g2.open(crash.s(), 10));
+            INFO(W("6. falls back to the other slot")); CHECK(g2.current() == 11);
+        }
+        copy_file(file, crash);
+        {
+            MappedFile f;
+            REQUIRE(f.open(crash.s(), MappedFile::Mode::READ_WRITE));
+            f.wbytes()[16] ^= std::byte{ 1 };
+            f.wbytes()[4096 + 16] ^= std::byte{ 1 };
+            f.close();
+            G g2(1, 5, 1);
+            REQUIRE(g2.open(crash.s(), 10));
+            INFO(W("7. no valid slot, initial value")); CHECK(g2.current() == 5);
+        }
+
+        REQUIRE(g.close());
+        G g2(1, 0, 1);
+        REQUIRE(g2.open(file.s(), 10));
+        INFO(W("8. clean close, no ids skipped")); CHECK(g2.get_id() == last + 1);
+
+        G down(1, 100, -1);
+        INFO(W("9. negative step rejected")); CHECK(!down.open(crash.s()));
+    }
+
+    TEST_CASE("PersistentGeneratorConcurrent", "[generator]")
+    {
+        using G = PersistentGenerator<Object>;
+        const Path file = test_file(W("PersistentGenerator"), W("concurrent.bin"));
+        G g(1, 0, 1);
+        REQUIRE(g.open(file.s(), 100));
+
+        constexpr size_t THREADS = 4, PER_THREAD = 10'000;
+        std::vector<std::vector<Id>> ids(THREADS);
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < THREADS; ++t)
+            threads.emplace_back([&, t]
+            {
+                for (size_t i = 0; i < PER_THREAD; ++i)
+                    ids[t].push_back(t % 2 == 0 ? g.get_id() : g.get_local_id(64));
+            });
+        for (std::thread& t : threads) t.join();
+
+        std::vector<Id> all;
+        for (auto& v : ids) all.insert(all.end(), v.begin(), v.end());
+        std::sort(all.begin(), all.end());
+        INFO(W("0. all drawn")); CHECK(all.front() > 0);
+        INFO(W("1. no id drawn twice")); CHECK(std::adjacent_find(all.begin(), all.end()) == all.end());
+        INFO(W("2. every id covered by the mark")); CHECK(all.back() <= g.durable_limit());
+        INFO(W("3. no error")); CHECK(g.error());
+    }
+
+    TEST_CASE("PersistentGeneratorBenchmark", "[.][generator][benchmark]")
+    {
+        const Path file = test_file(W("PersistentGenerator"), W("benchmark.bin"));
+        Generator<Object> memory(1, 0, 1);
+        PersistentGenerator<Object> durable(1, 0, 1);
+        REQUIRE(durable.open(file.s()));
+
+        BENCHMARK("Generator::get_id")
+        {
+            return memory.get_id();
+        };
+
+        BENCHMARK("PersistentGenerator::get_id, one sync per 4096 ids")
+        {
+            return durable.get_id();
+        };
+    }
+}
@@ -0,0 +1,149 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "test_helpers.hpp"
+
+#include "../object.hpp"
+#include "../binary_buffer.hpp"
+#include "../segmented_binary_buffer.hpp"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace pensar_digital::cpplib
+{
+    using namespace test_helpers;
+
+    TEST_CASE("SegmentedBinaryBufferObjects", "[segmented_binary_buffer]")
+    {
+        // Segments deliberately smaller than, and not a multiple of, Object::SIZE.
+        SegmentPool pool(100);
+        SegmentedBinaryBuffer sbb(pool);
+
+        const size_t COUNT = 1000;
+        for (size_t i = 0; i < COUNT; ++i)
+            sbb.write(Object(static_cast<Id>(i)));
+        INFO(W("0. size")); CHECK(sbb.size() == COUNT * Object::SIZE);
+        INFO(W("1. segment count")); CHECK(sbb.segment_count() == (COUNT * Object::SIZE + 99) / 100);
+
+        Object o;
+        bool all_equal = true;
+        for (size_t i = 0; i < COUNT; ++i)
+        {
+            sbb.read(o);
+            all_equal = all_equal && (o.id() == static_cast<Id>(i));
+        }
+        INFO(W("2. objects read across segment boundaries")); CHECK(all_equal);
+        INFO(W("3. everything consumed")); CHECK(sbb.remaining() == 0);
+    }
+
+    TEST_CASE("SegmentedBinaryBufferCompactTypes", "[segmented_binary_buffer]")
+    {
+        // The type definition straddles segments, later records are an id and the data.
+        SegmentPool pool(100);
+        SegmentedBinaryBuffer sbb(pool);
+        sbb.set_compact_types(true);
+
+        const size_t COUNT = 1000;
+        for (size_t i = 0; i < COUNT; ++i)
+            sbb.write(Object(static_cast<Id>(i)));
+        INFO(W("0. size")); CHECK(sbb.size() == sizeof(ClassInfo) + COUNT * (1 + Object::DATA_SIZE));
+
+        Object o;
+        bool all_equal = true;
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            for (size_t i = 0; i < COUNT; ++i)
+            {
+                sbb.read(o);
+                all_equal = all_equal && (o.id() == static_cast<Id>(i));
+            }
+            sbb.rewind();
+        }
+        INFO(W("1. objects read twice")); CHECK((all_equal && sbb.ok()));
+    }
+
+    TEST_CASE("SegmentedBinaryBufferPods", "[segmented_binary_buffer]")
+    {
+        SegmentPool pool(12);
+        SegmentedBinaryBuffer sbb(pool);
+        for (std::int64_t i = 0; i < 100; ++i)
+            sbb.write(i);
+
+        const std::byte* first = sbb.segments().front().data();
+        for (std::int64_t i = 100; i < 1000; ++i)
+            sbb.write(i);
+        INFO(W("0. written segments never move")); CHECK(sbb.segments().front().data() == first);
+
+        size_t total = 0;
+        for (std::span<const std::byte> s : sbb.segments())
+            total += s.size();
+        INFO(W("1. gather list covers all bytes")); CHECK(total == sbb.size());
+
+        std::int64_t x = -1;
+        bool all_equal = true;
+        for (std::int64_t i = 0; i < 1000; ++i)
+        {
+            sbb.read(x);
+            all_equal = all_equal && (x == i);
+        }
+        INFO(W("2. straddling values read back")); CHECK(all_equal);
+
+        sbb.rewind();
+        sbb.skip(10 * sizeof(std::int64_t)).read(x);
+        INFO(W("3. skip")); CHECK(x == 10);
+
+        sbb.clear();
+        INFO(W("4. clear empties")); CHECK(sbb.size() == 0);
+        INFO(W("5. clear returns segments to the pool")); CHECK(pool.free_count() > 0);
+    }
+
+    TEST_CASE("SegmentedBinaryBufferSave", "[segmented_binary_buffer]")
+    {
+        Path out = test_file(W("SegmentedBinaryBuffer"), W("segmented.bin"));
+
+        SegmentPool pool(64);
+        SegmentedBinaryBuffer sbb(pool);
+        for (size_t i = 0; i < 100; ++i)
+            sbb.write(Object(static_cast<Id>(i)));
+        REQUIRE(sbb.save_to_file(out.s()));
+
+        BinaryBuffer bb;
+        REQUIRE(bb.load_from_file(out.s()));
+        INFO(W("0. file size")); CHECK(bb.size() == sbb.size());
+
+        Object o;
+        bool all_equal = true;
+        for (size_t i = 0; i < 100; ++i)
+        {
+            o.read(bb);
+            all_equal = all_equal && (o.id() == static_cast<Id>(i));
+        }
+        INFO(W("1. contiguous read of the gathered file")); CHECK(all_equal);
+    }
+
+    TEST_CASE("SegmentedBinaryBufferBenchmark", "[.][segmented_binary_buffer][benchmark]")
+    {
+        // About 450 MB of Objects: BinaryBuffer reallocates (and copies) it ~17 times.
+        static constexpr size_t OBJECTS = 2'000'000;
+
+        BENCHMARK("BinaryBuffer, 2M objects")
+        {
+            BinaryBuffer bb;
+            for (size_t i = 0; i < OBJECTS; ++i)
+                Object(static_cast<Id>(i)).write(bb);
+            return bb.size();
+        };
+
+        BENCHMARK("SegmentedBinaryBuffer, 2M objects")
+        {
+            SegmentedBinaryBuffer sbb;
+            for (size_t i = 0; i < OBJECTS; ++i)
+                sbb.write(Object(static_cast<Id>(i)));
+            return sbb.size();
+        };
+    }
+}
@@ -0,0 +1,56 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "../serializer.hpp"
+#include "../object.hpp"
+#include "../command.hpp"
+#include "../generator.hpp"
+
+#include <cstring>
+
+namespace pensar_digital::cpplib
+{
+    static_assert(SerializableLevel<Object>);
+    static_assert(SerializableLevel<Command>);
+    static_assert(SerializableLevel<Generator<Object>>);
+    static_assert(Object::Serializer::SIZE == Object::SIZE);
+    static_assert(Generator<Object>::Serializer::SIZE == Generator<Object>::SIZE);
+
+    TEST_CASE("Serializer", "[serializer]")
+    {
+        Generator<Object> g(5, 10, 2);
+        g.get_id();
+        BinaryBuffer bb;
+        g.write(bb);
+        INFO(W("0. fixed size")); CHECK(bb.size() == Generator<Object>::Serializer::SIZE);
+
+        // Same layout as the hand-written chain: each level is its ClassInfo then its Data.
+        BinaryBuffer manual;
+        manual.write(Object::INFO.bytes()).write(std::span<const std::byte>((const std::byte*)g.Object::data(), Object::DATA_SIZE));
+        manual.write(Generator<Object>::INFO.bytes()).write(std::span<const std::byte>((const std::byte*)g.generator_data(), Generator<Object>::DATA_SIZE));
+        INFO(W("1. layout")); CHECK((manual.size() == bb.size() && std::memcmp(manual.data().data(), bb.data().data(), bb.size()) == 0));
+
+        Generator<Object> g2;
+        g2.read(bb);
+        INFO(W("2. read back")); CHECK((bb.ok() && g2.id() == g.id() && g2.current() == g.current() && g2.next() == g.next()));
+
+        // A Command read where a Generator was written fails at its second level.
+        bb.rewind();
+        NullCommand cmd;
+        Command::Serializer::read(cmd, bb);
+        INFO(W("3. wrong level")); CHECK(bb.error() == BufferError::INVALID_DATA);
+
+        BinaryBuffer truncated;
+        truncated.write(bb.data().first(Generator<Object>::Serializer::SIZE - 1));
+        g2.read(truncated);
+        INFO(W("4. one bounds check for the record")); CHECK((truncated.error() == BufferError::READ_UNDERFLOW && truncated.remaining() == truncated.size()));
+
+        BinaryBuffer compact;
+        compact.set_compact_types(true);
+        for (int i = 0; i < 3; ++i) g.write(compact);
+        for (int i = 0; i < 3; ++i) g2.read(compact);
+        INFO(W("5. compact types")); CHECK((compact.ok() && compact.remaining() == 0 && g2.current() == g.current()));
+    }
+}
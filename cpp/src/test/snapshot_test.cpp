@@ -0,0 +1,182 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "test_helpers.hpp"
+
+#include "../snapshot.hpp"
+#include "../object.hpp"
+
+#include <vector>
+#include <memory>
+
+namespace pensar_digital::cpplib
+{
+    using namespace test_helpers;
+
+    static std::vector<Object> make_objects(size_t n)
+    {
+        std::vector<Object> objects;
+        objects.reserve(n);
+        for (size_t i = 0; i < n; ++i) objects.emplace_back(static_cast<Id>(i * 3 + 1));
+        return objects;
+    }
+
+    static bool same_ids(const std::vector<Object>& a, const std::vector<Object>& b)
+    {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); ++i)
+            if (a[i].id() != b[i].id()) return false;
+        return true;
+    }
+
+    TEST_CASE("Snapshot", "[snapshot]")
+    {
+        const std::vector<Object> objects = make_objects(10007);
+        Path out = test_file(W("Snapshot"), W("objects.pdsn"));
+
+        SnapshotOptions options;
+        options.mshard_objects = 1000;
+        options.mthreads = 4;
+        for (Codec codec : { Codec::NONE, Codec::FAST, Codec::HIGH })
+        for (bool compact : { false, true })
+        {
+            options.mcodec = codec;
+            options.mcompact_types = compact;
+            REQUIRE(save_snapshot(out.s(), objects, options));
+
+            SnapshotReader reader;
+            REQUIRE(reader.open(out.s()));
+            INFO(W("0. index, codec ") << static_cast<int>(codec) << W(" compact ") << compact);
+            CHECK((reader.object_count() == objects.size() && reader.shard_count() == 11 && reader.shard(10).mcount.value() == 7));
+            std::vector<Object> back;
+            INFO(W("1. load")); CHECK(reader.load(back, 4));
+            INFO(W("2. same objects, same order")); CHECK(same_ids(back, objects));
+        }
+
+        // Pointers, loaded through a custom read.
+        std::vector<Object::Ptr> ptrs;
+        for (const Object& o : objects) ptrs.push_back(std::make_shared<Object>(o));
+        REQUIRE(save_snapshot(out.s(), ptrs));
+        SnapshotReader reader;
+        REQUIRE(reader.open(out.s()));
+        std::vector<Object::Ptr> back_ptrs;
+        REQUIRE(reader.load(back_ptrs, 0, [](BinaryBuffer& bb, Object::Ptr& p) { p = std::make_shared<Object>(); p->read(bb); }));
+        INFO(W("3. pointers")); CHECK((back_ptrs.size() == ptrs.size() && back_ptrs.back()->id() == ptrs.back()->id()));
+
+        std::vector<Object> none;
+        REQUIRE(save_snapshot(out.s(), none));
+        std::vector<Object> back = objects;
+        INFO(W("4. empty")); CHECK((load_snapshot(out.s(), back) && back.empty()));
+    }
+
+    TEST_CASE("SnapshotDamaged", "[snapshot]")
+    {
+        const std::vector<Object> objects = make_objects(5000);
+        Path out = test_file(W("Snapshot"), W("damaged.pdsn"));
+        SnapshotOptions options;
+        options.mshard_objects = 500;
+        options.mcodec = Codec::FAST;
+        REQUIRE(save_snapshot(out.s(), objects, options));
+        BinaryBuffer file;
+        REQUIRE(file.load_from_file(out.s()));
+        const std::vector<std::byte> good(file.data().begin(), file.data().end());
+
+        auto save = [&](std::span<const std::byte> bytes)
+        {
+            BinaryBuffer bb;
+            bb.write(bytes);
+            REQUIRE(bb.save_to_file(out.s()));
+        };
+
+        std::vector<Object> back;
+        std::vector<std::byte> bad = good;
+        bad[sizeof(SnapshotHeader) + 10] ^= std::byte{ 0x01 };
+        save(bad);
+        SnapshotReader reader;
+        INFO(W("0. a damaged shard opens")); CHECK(reader.open(out.s()));
+        INFO(W("1. but does not load")); CHECK((!reader.load(back) && back.empty()));
+
+        bad = good;
+        bad[bad.size() - sizeof(SnapshotFooter) - 3] ^= std::byte{ 0x01 };
+        save(bad);
+        INFO(W("2. damaged index")); CHECK(!SnapshotReader().open(out.s()));
+
+        bad = good;
+        bad[bad.size() - 10] ^= std::byte{ 0x01 };
+        save(bad);
+        INFO(W("3. damaged footer")); CHECK(!SnapshotReader().open(out.s()));
+
+        // A valid footer CRC over an index offset that wraps onto the end of the index.
+        bad = good;
+        SnapshotFooter footer;
+        std::memcpy(&footer, bad.data() + bad.size() - sizeof(footer), sizeof(footer));
+        footer.mshard_count = LEUInt32(std::uint32_t{ 1 } << 20);
+        footer.mindex_offset = LEUInt64(bad.size() - sizeof(footer) - (std::uint64_t{ 1 } << 20) * sizeof(SnapshotShard));
+        footer.mcrc = LEUInt32(footer.checksum());
+        std::memcpy(bad.data() + bad.size() - sizeof(footer), &footer, sizeof(footer));
+        save(bad);
+        INFO(W("4. tampered footer")); CHECK(!SnapshotReader().open(out.s()));
+
+        // Rewrites the first shard of the index, and the footer total to match its count
+        // (modulo 2^64), under valid CRCs.
+        auto tamper = [&](auto&& change)
+        {
+            bad = good;
+            std::memcpy(&footer, bad.data() + bad.size() - sizeof(footer), sizeof(footer));
+            std::vector<SnapshotShard> index(footer.mshard_count.value());
+            std::memcpy(index.data(), bad.data() + footer.mindex_offset.value(), index.size() * sizeof(SnapshotShard));
+            const std::uint64_t old_count = index[0].mcount.value();
+            change(index[0]);
+            std::memcpy(bad.data() + footer.mindex_offset.value(), index.data(), index.size() * sizeof(SnapshotShard));
+            footer.mobject_count = LEUInt64(footer.mobject_count.value() - old_count + index[0].mcount.value());
+            footer.mindex_crc = LEUInt32(crc32c(std::as_bytes(std::span<const SnapshotShard>(index))));
+            footer.mcrc = LEUInt32(footer.checksum());
+            std::memcpy(bad.data() + bad.size() - sizeof(footer), &footer, sizeof(footer));
+            save(bad);
+        };
+
+        // Shard counts whose sum wraps onto a valid footer total.
+        tamper([](SnapshotShard& s) { s.mcount = LEUInt64(~std::uint64_t{ 0 }); });
+        INFO(W("5. wrapping object count")); CHECK(!SnapshotReader().open(out.s()));
+
+        // Sizes and counts that agree with each other but not with the stored bytes.
+        tamper([](SnapshotShard& s) { s.mraw_size = LEUInt64(UINT32_MAX); });
+        INFO(W("6. raw size beyond the stored bytes")); CHECK(!SnapshotReader().open(out.s()));
+        tamper([](SnapshotShard& s) { s.mcount = LEUInt64(s.mraw_size.value() + 1); });
+        INFO(W("7. more objects than bytes")); CHECK(!SnapshotReader().open(out.s()));
+
+        save(std::span(good).first(good.size() - 1));
+        INFO(W("8. truncated")); CHECK(!SnapshotReader().open(out.s()));
+    }
+
+    TEST_CASE("SnapshotBenchmark", "[.][snapshot][benchmark]")
+    {
+        const std::vector<Object> objects = make_objects(1'000'000);
+        Path out = test_file(W("Snapshot"), W("benchmark.pdsn"));
+        SnapshotOptions one;
+        one.mthreads = 1;
+        std::vector<Object> back;
+
+        BENCHMARK("save_snapshot, 1M objects, 1 thread")
+        {
+            return save_snapshot(out.s(), objects, one).mok;
+        };
+
+        BENCHMARK("save_snapshot, 1M objects, all threads")
+        {
+            return save_snapshot(out.s(), objects).mok;
+        };
+
+        BENCHMARK("load_snapshot, 1M objects, 1 thread")
+        {
+            return load_snapshot(out.s(), back, 1).mok;
+        };
+
+        BENCHMARK("load_snapshot, 1M objects, all threads")
+        {
+            return load_snapshot(out.s(), back).mok;
+        };
+    }
+}
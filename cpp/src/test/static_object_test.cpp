@@ -0,0 +1,196 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "../static_object.hpp"
+#include "../object.hpp"
+#include "../binary_buffer.hpp"
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <type_traits>
+
+namespace pensar_digital::cpplib
+{
+    // The same class twice: as a StaticObject and as an Object.
+    struct PointData : public pd::Data
+    {
+        std::int64_t mx;
+        std::int64_t my;
+        PointData(std::int64_t x = 0, std::int64_t y = 0) noexcept : mx(x), my(y) {}
+    };
+
+    inline static const ClassInfo POINT_INFO = { CPPLIB_NAMESPACE, W("Point"), 1, 1, 1 };
+
+    class StaticPoint : public StaticObject<StaticPoint>
+    {
+        public:
+            using DataType = PointData;
+            inline static const ClassInfo INFO = POINT_INFO;
+            inline static constexpr size_t DATA_SIZE = sizeof(DataType);
+            inline static constexpr size_t      SIZE = DATA_SIZE + sizeof(ClassInfo) + StaticObject::SIZE;
+            using Serializer = pd::Serializer<StaticObject<StaticPoint>, StaticPoint>;
+
+            StaticPoint(Id id = NULL_ID, std::int64_t x = 0, std::int64_t y = 0) noexcept : StaticObject(Object::DataType(id)), mdata(x, y) {}
+
+            const pd::Data* data() const noexcept { return &mdata; }
+            size_t data_size() const noexcept { return DATA_SIZE; }
+            std::int64_t x() const noexcept { return mdata.mx; }
+
+        private:
+            DataType mdata;
+    };
+
+    class DynamicPoint : public Object
+    {
+        public:
+            using DataType = PointData;
+            inline static const ClassInfo INFO = POINT_INFO;
+            inline static constexpr size_t DATA_SIZE = sizeof(DataType);
+            inline static constexpr size_t      SIZE = DATA_SIZE + sizeof(ClassInfo) + Object::SIZE;
+            using Serializer = pd::Serializer<Object, DynamicPoint>;
+
+            DynamicPoint(Id id = NULL_ID, std::int64_t x = 0, std::int64_t y = 0) noexcept : Object(Object::DataType(id)), mdata(x, y) {}
+
+            const ClassInfo* info_ptr() const noexcept override { return &INFO; }
+            const pd::Data* data() const noexcept override { return &mdata; }
+            size_t data_size() const noexcept override { return DATA_SIZE; }
+            size_t size() const noexcept override { return SIZE; }
+            BinaryBuffer& write(BinaryBuffer& bb) const noexcept override { return Serializer::write(*this, bb); }
+            BinaryBuffer& read(BinaryBuffer& bb) noexcept override { return Serializer::read(*this, bb); }
+            using Object::write;
+            using Object::read;
+
+        private:
+            DataType mdata;
+    };
+
+    TEST_CASE("StaticObject", "[static_object]")
+    {
+        static_assert(!std::is_polymorphic_v<StaticPoint>);
+        static_assert(std::is_trivially_copyable_v<StaticPoint>);
+        static_assert(sizeof(StaticPoint) == Object::DATA_SIZE + StaticPoint::DATA_SIZE);
+        static_assert(BinaryBufferIO<StaticPoint>);
+        static_assert(Identifiable<StaticPoint> && Hashable<StaticPoint> && HasClassInfo<StaticPoint>);
+        static_assert(TriviallyPersistable<StaticPoint>);
+
+        const StaticPoint a(1, 2, 3);
+        INFO("0. identity"); CHECK((a.id() == 1 && a.hash() == 1));
+        INFO("1. info"); CHECK(*a.info_ptr() == POINT_INFO);
+        INFO("2. object level tag"); CHECK(StaticObject<StaticPoint>::INFO == Object::INFO);
+        INFO("3. size"); CHECK(a.size() == DynamicPoint::SIZE);
+        INFO("4. equal"); CHECK(a == StaticPoint(1, 2, 3));
+        INFO("5. other id"); CHECK(a != StaticPoint(2, 2, 3));
+        INFO("6. other data"); CHECK(a != StaticPoint(1, 2, 4));
+
+        for (bool compact : { false, true })
+        {
+            // Same bytes as the dynamic class, both ways.
+            BinaryBuffer sbb, dbb;
+            sbb.set_compact_types(compact);
+            dbb.set_compact_types(compact);
+            a.write(sbb);
+            DynamicPoint(1, 2, 3).write(dbb);
+            INFO("7. same bytes, compact " << compact); CHECK(std::equal(sbb.data().begin(), sbb.data().end(), dbb.data().begin(), dbb.data().end()));
+
+            DynamicPoint d;
+            d.read(sbb);
+            INFO("8. dynamic reads static"); CHECK((sbb.ok() && d.equals(DynamicPoint(1, 2, 3))));
+            StaticPoint s;
+            s.read(dbb);
+            INFO("9. static reads dynamic"); CHECK((dbb.ok() && s == a));
+        }
+
+        BinaryBuffer bad;
+        DynamicPoint(1, 2, 3).Object::write(bad);
+        StaticPoint s;
+        s.read(bad);
+        INFO("10. an Object record is not a point"); CHECK(!bad.ok());
+    }
+
+    TEST_CASE("ObjectAdapter", "[static_object]")
+    {
+        const StaticPoint a(7, 8, 9);
+        Object::Ptr o = make_object(a);
+        INFO("0. identity"); CHECK((o->id() == 7 && o->hash() == 7));
+        INFO("1. info"); CHECK(*o->info_ptr() == POINT_INFO);
+        INFO("2. data"); CHECK(std::memcmp(o->data(), a.data(), StaticPoint::DATA_SIZE) == 0);
+        INFO("3. equals"); CHECK(o->equals(*make_object(a)));
+        INFO("4. not equals"); CHECK(!o->equals(*make_object(StaticPoint(7, 8, 10))));
+        INFO("5. other class"); CHECK(!o->equals(Object(7)));
+
+        BinaryBuffer bb;
+        o->write(bb);
+        ObjectAdapter<StaticPoint> back;
+        Object& dyn = back;
+        dyn.read(bb);
+        INFO("6. round trip"); CHECK((bb.ok() && back.value() == a));
+        INFO("7. object level follows"); CHECK(back.to_string() == a.to_string());
+    }
+
+    TEST_CASE("StaticObjectBenchmark", "[.][static_object][benchmark]")
+    {
+        constexpr size_t N = 10'000'000;
+        std::vector<StaticPoint> spoints;
+        std::vector<DynamicPoint> dpoints;
+        spoints.reserve(N);
+        dpoints.reserve(N);
+        for (size_t i = 0; i < N; ++i)
+        {
+            const Id id = static_cast<Id>(i % 1000);
+            spoints.emplace_back(id, 1, 2);
+            dpoints.emplace_back(id, 1, 2);
+        }
+        const StaticPoint sref(500, 1, 2);
+        const DynamicPoint dref(500, 1, 2);
+        const Object& dref_object = dref;
+        // Compact type tags: full tags would be most of the bytes of such small records.
+        BinaryBuffer bb(N * (Object::DATA_SIZE + StaticPoint::DATA_SIZE + 4));
+        bb.set_compact_types(true);
+
+        BENCHMARK("Object equals, 10M objects")
+        {
+            size_t n = 0;
+            for (const Object& p : dpoints) n += p.equals(dref_object);
+            return n;
+        };
+
+        BENCHMARK("StaticObject equals, 10M objects")
+        {
+            size_t n = 0;
+            for (const StaticPoint& p : spoints) n += p.equals(sref);
+            return n;
+        };
+
+        BENCHMARK("Object write, 10M objects")
+        {
+            bb.clear();
+            for (const Object& p : dpoints) p.write(bb);
+            return bb.size();
+        };
+
+        BENCHMARK("StaticObject write, 10M objects")
+        {
+            bb.clear();
+            for (const StaticPoint& p : spoints) p.write(bb);
+            return bb.size();
+        };
+
+        BENCHMARK("Object read, 10M objects")
+        {
+            bb.rewind();
+            for (Object& p : dpoints) p.read(bb);
+            return bb.ok();
+        };
+
+        BENCHMARK("StaticObject read, 10M objects")
+        {
+            bb.rewind();
+            for (StaticPoint& p : spoints) p.read(bb);
+            return bb.ok();
+        };
+    }
+}
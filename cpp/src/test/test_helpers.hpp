@@ -24,6 +24,17 @@ namespace pensar_digital::cpplib::test_helpers
         return get_user_home() / "test_dir/";
     }
 
+    /// Returns the path of file name in the test directory's subdirectory dir, creating dir
+    /// and removing the file a previous run left.
+    inline Path test_file(const S& dir, const S& name)
+    {
+        Path test_dir = get_test_dir() / Path(dir + W("/"));
+        test_dir.create_dir();
+        Path out = test_dir / Path(name);
+        out.remove();
+        return out;
+    }
+
     /// Element-wise collection equality check using Catch2 macros.
     /// Replaces the old Test::check_equal_collection method.
     template <typename A, typename E>
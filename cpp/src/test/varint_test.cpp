@@ -0,0 +1,177 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "../varint.hpp"
+#include "../binary_buffer.hpp"
+#include "../segmented_binary_buffer.hpp"
+#include "../command.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace pensar_digital::cpplib
+{
+    TEST_CASE("ZigZag", "[varint]")
+    {
+        INFO(W("0. zero")); CHECK(zigzag_encode(std::int64_t{ 0 }) == 0);
+        INFO(W("1. -1")); CHECK(zigzag_encode(std::int64_t{ -1 }) == 1);
+        INFO(W("2. 1")); CHECK(zigzag_encode(std::int64_t{ 1 }) == 2);
+        INFO(W("3. min")); CHECK(zigzag_encode((std::numeric_limits<std::int32_t>::min)()) == 0xFFFFFFFFu);
+        INFO(W("4. round trip min")); CHECK(zigzag_decode<std::int64_t>(zigzag_encode((std::numeric_limits<std::int64_t>::min)())) == (std::numeric_limits<std::int64_t>::min)());
+        INFO(W("5. round trip int16")); CHECK(zigzag_decode<std::int16_t>(zigzag_encode(std::int16_t{ -300 })) == -300);
+    }
+
+    TEST_CASE("Varint", "[varint]")
+    {
+        std::byte bytes[VARINT_MAX_BYTES];
+        INFO(W("0. one byte")); CHECK(encode_varint(127, bytes) == 1);
+        INFO(W("1. two bytes")); CHECK(encode_varint(128, bytes) == 2);
+        INFO(W("2. max")); CHECK(encode_varint((std::numeric_limits<std::uint64_t>::max)(), bytes) == VARINT_MAX_BYTES);
+        INFO(W("3. varint_size")); CHECK(varint_size((std::numeric_limits<std::uint64_t>::max)()) == VARINT_MAX_BYTES);
+        INFO(W("4. varint_size 0")); CHECK(varint_size(0) == 1);
+
+        std::uint64_t v = 0;
+        INFO(W("5. decode max")); CHECK(decode_varint(bytes, v) == VARINT_MAX_BYTES);
+        INFO(W("6. decoded max")); CHECK(v == (std::numeric_limits<std::uint64_t>::max)());
+        INFO(W("7. truncated")); CHECK(decode_varint(std::span<const std::byte>(bytes, 3), v) == 0);
+
+        bytes[VARINT_MAX_BYTES - 1] = std::byte{ 2 };
+        INFO(W("8. more than 64 bits")); CHECK(decode_varint(bytes, v) == 0);
+    }
+
+    TEST_CASE("DecodeVarints", "[varint]")
+    {
+        // Mix long runs of 1-byte values with multi-byte ones at every offset.
+        std::vector<std::uint32_t> values;
+        for (std::uint32_t i = 0; i < 1000; ++i)
+            values.push_back((i % 37 == 0) ? i * 100000 : i % 128);
+
+        BinaryBuffer bb;
+        bb.write_varints(std::span<const std::uint32_t>(values));
+        std::vector<std::uint32_t> back(values.size());
+        size_t consumed = 0;
+        INFO(W("0. all decoded")); CHECK(decode_varints(bb.data(), std::span<std::uint32_t>(back), consumed) == values.size());
+        INFO(W("1. all bytes consumed")); CHECK(consumed == bb.size());
+        INFO(W("2. values")); CHECK(back == values);
+
+        std::vector<std::uint8_t> narrow(values.size());
+        INFO(W("3. stops at values out of range")); CHECK(decode_varints(bb.data(), std::span<std::uint8_t>(narrow), consumed) == 37);
+    }
+
+    TEST_CASE("BinaryBufferVarint", "[varint]")
+    {
+        BinaryBuffer bb;
+        bb.write_varint(std::int64_t{ -5 });
+        bb.write_varint(std::uint16_t{ 300 });
+        INFO(W("0. compact size")); CHECK(bb.size() == 3);
+
+        std::int64_t a = 0;
+        std::uint16_t b = 0;
+        bb.read_varint(a).read_varint(b);
+        INFO(W("1. signed")); CHECK(a == -5);
+        INFO(W("2. unsigned")); CHECK(b == 300);
+
+        std::vector<std::int32_t> values = { 0, -1, 1, -1000000, 1000000, 63, -64 };
+        bb.clear();
+        bb.write_varints(std::span<const std::int32_t>(values));
+        std::vector<std::int32_t> back(values.size());
+        bb.read_varints(std::span<std::int32_t>(back));
+        INFO(W("3. bulk signed")); CHECK(back == values);
+    }
+
+    TEST_CASE("CompactIntegers", "[varint]")
+    {
+        BinaryBuffer bb;
+        bb.set_compact_integers(true);
+        bb.write(std::int64_t{ 1 });
+        bb.write(size_t{ 2 });
+        bb.write(std::int32_t{ -3 });
+        INFO(W("0. integers take one byte each")); CHECK(bb.size() == 3);
+
+        std::int64_t a = 0;
+        size_t b = 0;
+        std::int32_t c = 0;
+        bb.read(a).read(b).read(c);
+        INFO(W("1. values")); CHECK((a == 1 && b == 2 && c == -3));
+
+        BinaryBuffer copy = bb;
+        INFO(W("2. mode is copied")); CHECK(copy.compact_integers());
+
+        // Varints that straddle segments are read through the source refill.
+        SegmentPool pool(7);
+        SegmentedBinaryBuffer sbb(pool);
+        sbb.set_compact_integers(true);
+        for (std::int64_t i = 0; i < 1000; ++i)
+            sbb.write(i * 1000);
+        bool all_equal = true;
+        for (std::int64_t i = 0; i < 1000; ++i)
+        {
+            std::int64_t x = -1;
+            sbb.read(x);
+            all_equal = all_equal && (x == i * 1000);
+        }
+        INFO(W("3. segmented")); CHECK(all_equal);
+        INFO(W("4. consumed")); CHECK(sbb.remaining() == 0);
+    }
+
+    TEST_CASE("CompactIntegersCompositeCommand", "[varint]")
+    {
+        CompositeCommand cmd;
+        BinaryBuffer full;
+        cmd.write(full);
+
+        BinaryBuffer compact;
+        compact.set_compact_integers(true);
+        cmd.write(compact);
+        INFO(W("0. mindex shrinks")); CHECK(compact.size() < full.size());
+
+        CompositeCommand cmd2;
+        compact.skip(sizeof(ClassInfo)); // Type tag, read by the caller for dispatch.
+        cmd2.read(compact);
+        INFO(W("1. read back")); CHECK(compact.remaining() == 0);
+    }
+
+    TEST_CASE("VarintBenchmark", "[.][varint][benchmark]")
+    {
+        static constexpr size_t COUNT = 10'000'000;
+        std::vector<std::uint64_t> ids(COUNT);
+        for (size_t i = 0; i < COUNT; ++i)
+            ids[i] = (i % 64 == 0) ? i : i % 100;
+
+        BinaryBuffer bb(COUNT * VARINT_MAX_BYTES);
+        bb.write_varints(std::span<const std::uint64_t>(ids));
+        std::vector<std::uint64_t> back(COUNT);
+
+        BENCHMARK("fixed width write, 10M ids")
+        {
+            BinaryBuffer out(COUNT * sizeof(std::uint64_t));
+            for (std::uint64_t id : ids) out.write(id);
+            return out.size();
+        };
+
+        BENCHMARK("varint write, 10M ids")
+        {
+            BinaryBuffer out(COUNT * VARINT_MAX_BYTES);
+            out.write_varints(std::span<const std::uint64_t>(ids));
+            return out.size();
+        };
+
+        BENCHMARK("scalar varint decode, 10M ids")
+        {
+            bb.rewind();
+            for (std::uint64_t& v : back) bb.read_varint(v);
+            return back.back();
+        };
+
+        BENCHMARK("bulk varint decode, 10M ids")
+        {
+            bb.rewind();
+            bb.read_varints(std::span<std::uint64_t>(back));
+            return back.back();
+        };
+    }
+}
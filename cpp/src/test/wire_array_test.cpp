@@ -0,0 +1,112 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "test_helpers.hpp"
+
+#include "../wire_array.hpp"
+#include "../binary_buffer.hpp"
+
+#include <cmath>
+#include <vector>
+#include <cstdint>
+
+namespace pensar_digital::cpplib
+{
+    using namespace test_helpers;
+
+    using BEInt32 = Int<std::int32_t, Endian::big()>;
+
+    TEST_CASE("WireArrayInt", "[wire_array]")
+    {
+        // 2500 values: several decode blocks plus a partial one.
+        std::vector<std::int32_t> values(2500);
+        for (size_t i = 0; i < values.size(); ++i)
+            values[i] = static_cast<std::int32_t>(i % 2 ? i * 1000 : -static_cast<std::int64_t>(i));
+
+        WireArray<BEInt32> a(values);
+        INFO(W("0. stored big endian")); CHECK(a[1].storage == static_cast<std::int32_t>(std::byteswap(1000u)));
+        INFO(W("1. element decode")); CHECK(a[1].value() == 1000);
+        INFO(W("2. bulk decode")); CHECK(a.decode() == values);
+
+        std::int64_t sum = 0;
+        std::int64_t dot = 0;
+        for (std::int32_t v : values)
+        {
+            sum += v;
+            dot += static_cast<std::int64_t>(v) * v;
+        }
+        INFO(W("3. sum")); CHECK(a.sum() == sum);
+        INFO(W("4. min")); CHECK(a.min() == -2498);
+        INFO(W("5. max")); CHECK(a.max() == 2499000);
+        INFO(W("6. dot")); CHECK(a.dot(a) == dot);
+
+        WireArray<Int<std::int32_t, Endian::little()>> little(values);
+        INFO(W("7. mixed endian dot")); CHECK(a.dot(little) == dot);
+
+        WireArray<BEInt32> empty;
+        INFO(W("8. empty")); CHECK((empty.sum() == 0 && empty.min() == (std::numeric_limits<std::int32_t>::max)()));
+
+        BinaryBuffer bb;
+        bb.write_array(a);
+        WireArray<BEInt32> back;
+        bb.read_array(back.values());
+        INFO(W("9. BinaryBuffer round trip")); CHECK(back.decode() == values);
+    }
+
+    TEST_CASE("WireArrayDouble", "[wire_array]")
+    {
+        std::vector<double> values(1500);
+        for (size_t i = 0; i < values.size(); ++i)
+            values[i] = 0.5 * static_cast<double>(i) - 100.0;
+
+        WireArray<BEDouble> a(values);
+        INFO(W("0. bulk decode")); CHECK(a.decode() == values);
+        INFO(W("1. same bytes as element encoding")); CHECK(a[7].bits == BEDouble(values[7]).bits);
+
+        double sum = 0;
+        for (double v : values) sum += v;
+        INFO(W("2. sum")); CHECK(std::abs(a.sum() - sum) < DEFAULT_DELTA);
+        INFO(W("3. min")); CHECK(a.min() == -100.0);
+        INFO(W("4. max")); CHECK(a.max() == 649.5);
+
+        // A view over wire bytes that live elsewhere, e.g. a file read into a buffer.
+        WireSpan<BEDouble> view(std::span<const BEDouble>(a.data() + 1, 2));
+        INFO(W("5. span")); CHECK(view.sum() == values[1] + values[2]);
+    }
+
+    TEST_CASE("WireArrayBenchmark", "[.][wire_array][benchmark]")
+    {
+        static constexpr size_t COUNT = 10'000'000;
+        std::vector<double> values(COUNT);
+        for (size_t i = 0; i < COUNT; ++i)
+            values[i] = static_cast<double>(i % 1000);
+        const WireArray<BEDouble> a(values);
+        std::vector<double> out(COUNT);
+
+        BENCHMARK("per element value() sum, 10M BE doubles")
+        {
+            double s = 0;
+            for (const BEDouble& d : a) s += d.value();
+            return s;
+        };
+
+        BENCHMARK("WireArray::sum, 10M BE doubles")
+        {
+            return a.sum();
+        };
+
+        BENCHMARK("per element decode, 10M BE doubles")
+        {
+            for (size_t i = 0; i < COUNT; ++i) out[i] = a[i].value();
+            return out.back();
+        };
+
+        BENCHMARK("WireArray::decode_into, 10M BE doubles")
+        {
+            a.decode_into(out);
+            return out.back();
+        };
+    }
+}
@@ -0,0 +1,110 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "test_helpers.hpp"
+
+#include "../wire_decimal.hpp"
+#include "../wire_array.hpp"
+#include "../equal.hpp"
+
+#include <string>
+#include <vector>
+#include <cstdlib>
+
+namespace pensar_digital::cpplib
+{
+    using namespace test_helpers;
+
+    using Geo   = Decimal<9, 6>;               // DECIMAL(9,6)
+    using Money = Decimal<18, 2, Endian::little()>;
+
+    // Arithmetic and parsing are constexpr.
+    static_assert(Geo::parse("-23.550520").unscaled() == -23550520);
+    static_assert(Geo(2) * Geo::parse("1.5") == Geo(3));
+    static_assert(Money::parse("10.00") / Money(3) == Money::parse("3.33"));
+    static_assert(Money::parse("20.00") / Money(3) == Money::parse("6.67"));
+    static_assert(decimal::count_digits(0) == 1 && decimal::count_digits(9) == 1 && decimal::count_digits(10) == 2 &&
+                  decimal::count_digits(999999999999999999ULL) == 18 && decimal::count_digits(~0ULL) == 20);
+
+    TEST_CASE("WireDecimal", "[wire_decimal]")
+    {
+        Geo lat = Geo::parse("-23.550520");
+        INFO(W("0. stored big endian")); CHECK(lat.storage == static_cast<std::int32_t>(std::byteswap(static_cast<std::uint32_t>(-23550520))));
+        INFO(W("1. format")); CHECK(lat.to_string() == "-23.550520");
+        INFO(W("2. round trip")); CHECK(Geo::parse(lat.to_string()) == lat);
+
+        Geo g;
+        INFO(W("3. leading zeros, sign, short fraction")); CHECK((Geo::parse("+000.5", g) && g.unscaled() == 500000 && g.to_string() == "0.500000"));
+        INFO(W("4. rounds extra digits half away from zero")); CHECK((Geo::parse("1.0000005") == Geo::parse("1.000001") && Geo::parse("-1.0000005") == Geo::parse("-1.000001") &&
+            Geo::parse("1.00000049999") == Geo::parse("1.000000")));
+        INFO(W("5. integer digits limited by precision")); CHECK((Geo::parse("999.999999", g) && !Geo::parse("1000", g)));
+        INFO(W("6. invalid text")); CHECK((!Geo::parse("", g) && !Geo::parse("-", g) && !Geo::parse(".", g) && !Geo::parse("1.2.3", g) && !Geo::parse("1e5", g) && !Geo::parse(" 1", g)));
+        INFO(W("7. failed parse keeps the value")); CHECK(g == Geo::parse("999.999999"));
+        INFO(W("8. integer only")); CHECK((Geo::parse("42") == Geo(42) && Geo::parse("42.") == Geo(42) && Geo::parse(".25").to_string() == "0.250000"));
+
+        Money a = Money::parse("1234567890123456.78");
+        INFO(W("9. 18 digits, 8 at a time")); CHECK((a.unscaled() == 123456789012345678LL && a.to_string() == "1234567890123456.78"));
+        INFO(W("10. exact sum")); CHECK((Money::parse("0.10") + Money::parse("0.20")) == Money::parse("0.30"));
+        INFO(W("11. product rounds")); CHECK((Money::parse("1.05") * Money::parse("1.05")).to_string() == "1.10");
+        INFO(W("12. 128 bit product")); CHECK((a * Money(10) / Money(10)) == a);
+        INFO(W("13. negation")); CHECK((-a).to_string() == "-1234567890123456.78");
+        INFO(W("14. rescale")); CHECK((Money(Geo::parse("-1.234999")) == Money::parse("-1.23") && Geo(Money::parse("7.5")) == Geo::parse("7.5")));
+        INFO(W("15. in range")); CHECK((Geo::parse("999.999999").in_range() && !(Geo::parse("999.999999") + Geo(1)).in_range()));
+        INFO(W("16. double at the boundary")); CHECK((Geo::from_double(-46.633308) == Geo::parse("-46.633308") && Geo::parse("0.5").to_double() == 0.5));
+        INFO(W("17. compare")); CHECK((Geo::parse("-1") < Geo::parse("0.000001") && equal<Geo>(Geo(1), Geo::parse("1.0"))));
+    }
+
+    TEST_CASE("WireDecimalBulk", "[wire_decimal]")
+    {
+        std::vector<Geo> values(1000);
+        for (size_t i = 0; i < values.size(); ++i)
+            values[i] = Geo::from_unscaled(static_cast<std::int32_t>(i * 123457) * (i % 2 ? -1 : 1));
+
+        std::string text;
+        format_decimals(std::span<const Geo>(values), '\n', text);
+        std::vector<Geo> back(values.size());
+        INFO(W("0. parse all")); CHECK(parse_decimals(text, '\n', std::span<Geo>(back)) == values.size());
+        INFO(W("1. round trip")); CHECK(back == values);
+        INFO(W("2. stops at an invalid value")); CHECK(parse_decimals(std::string_view("1.5,2.25,x,4"), ',', std::span<Geo>(back)) == 2);
+        INFO(W("3. stops when out is full")); CHECK(parse_decimals(text, '\n', std::span<Geo>(back).first(10)) == 10);
+
+        WireArray<Geo> column;
+        column.values().assign(values.begin(), values.end());
+        std::int64_t expected = 0;
+        for (const Geo& v : values) expected += v.unscaled();
+        INFO(W("4. exact column sum")); CHECK(column.sum() == expected);
+    }
+
+    TEST_CASE("WireDecimalBenchmark", "[.][wire_decimal][benchmark]")
+    {
+        std::vector<Geo> values(1'000'000);
+        for (size_t i = 0; i < values.size(); ++i)
+            values[i] = Geo::from_unscaled(static_cast<std::int32_t>((i * 2654435761u) % 180000000) - 90000000);
+        std::string text;
+        format_decimals(std::span<const Geo>(values), '\n', text);
+        std::vector<Geo> back(values.size());
+        std::vector<double> doubles(values.size());
+
+        BENCHMARK("parse_decimals")
+        {
+            return parse_decimals(text, '\n', std::span<Geo>(back));
+        };
+
+        BENCHMARK("strtod")
+        {
+            const char* p = text.c_str();
+            char* end = nullptr;
+            for (double& d : doubles) { d = std::strtod(p, &end); p = end + 1; }
+            return doubles.back();
+        };
+
+        BENCHMARK("format_decimals")
+        {
+            std::string out;
+            format_decimals(std::span<const Geo>(values), '\n', out);
+            return out.size();
+        };
+    }
+}
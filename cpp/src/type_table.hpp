@@ -0,0 +1,97 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#ifndef TYPE_TABLE_HPP
+#define TYPE_TABLE_HPP
+
+#include <span>
+#include <deque>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm> // std::equal
+#include <unordered_map>
+
+namespace pensar_digital::cpplib
+{
+    // Index of a type within one stream's TypeTable.
+    using TypeId = std::uint32_t;
+
+    // ------------------------------------------------------------
+    // TypeTable
+    // ------------------------------------------------------------
+    // Per stream table of the types serialized in it (see BinaryBuffer::set_compact_types).
+    // The first time a type is written its id is followed by its definition (e.g. the
+    // ClassInfo bytes); later records of that type carry only the id. Ids are assigned
+    // in order of first use, so a reader rebuilds the same table as it goes and never
+    // needs it up front.
+    //
+    // Types are keyed by the address of their static descriptor (e.g. &T::INFO), so
+    // interning a type already seen is a pointer lookup.
+    class TypeTable
+    {
+        public:
+            struct Entry
+            {
+                std::vector<std::byte> mdefinition;
+                const void* mlocal    = nullptr; // Local descriptor known to match mdefinition.
+                const void* mresolved = nullptr; // Cache for resolvers, e.g. the factory creating the type.
+            };
+
+        private:
+            std::deque<Entry> mentries; // A deque keeps entry addresses stable.
+            std::unordered_map<const void*, TypeId> mids;
+            size_t mread_count = 0;     // Definitions met by the reader so far.
+
+        public:
+            [[nodiscard]] size_t size() const noexcept { return mentries.size(); }
+
+            // Writer side. Returns the id of the type described by key, adding it when new;
+            // is_new tells whether its definition must follow the id.
+            TypeId intern(const void* key, std::span<const std::byte> definition, bool& is_new)
+            {
+                auto [it, inserted] = mids.try_emplace(key, static_cast<TypeId>(mentries.size()));
+                is_new = inserted;
+                if (inserted)
+                    mentries.push_back(Entry{ std::vector<std::byte>(definition.begin(), definition.end()), key });
+                return it->second;
+            }
+
+            // Reader side. The entry for a type id already defined in the stream, or nullptr.
+            [[nodiscard]] Entry* find(TypeId id) noexcept
+            {
+                return id < mread_count ? &mentries[id] : nullptr;
+            }
+
+            // Reader side. True if id is the next type the stream defines.
+            [[nodiscard]] bool defines(TypeId id) const noexcept { return id == mread_count; }
+
+            // Reader side. Records the definition read for the next type id. Returns nullptr
+            // if it contradicts the one the writer interned under that id.
+            Entry* define(std::span<const std::byte> definition)
+            {
+                if (mread_count < mentries.size())
+                {
+                    Entry& e = mentries[mread_count];
+                    if (!std::ranges::equal(e.mdefinition, definition)) return nullptr;
+                    ++mread_count;
+                    return &e;
+                }
+                mentries.push_back(Entry{ std::vector<std::byte>(definition.begin(), definition.end()) });
+                ++mread_count;
+                return &mentries.back();
+            }
+
+            // Restarts reading from the beginning of the stream, keeping the types.
+            void rewind() noexcept { mread_count = 0; }
+
+            void clear() noexcept
+            {
+                mentries.clear();
+                mids.clear();
+                mread_count = 0;
+            }
+    };
+}
+
+#endif // TYPE_TABLE_HPP
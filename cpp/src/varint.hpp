@@ -0,0 +1,141 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#ifndef VARINT_HPP
+#define VARINT_HPP
+
+#include <bit>
+#include <span>
+#include <limits>
+#include <cstddef>
+#include <cstring> // std::memcpy
+#include <cstdint>
+#include <concepts>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define PD_VARINT_SSE2 1
+#endif
+
+namespace pensar_digital::cpplib
+{
+    // ------------------------------------------------------------
+    // LEB128 variable length integers
+    // ------------------------------------------------------------
+    // Unsigned values are stored 7 bits per byte, least significant group first; the
+    // high bit of a byte is set when more bytes follow. Values below 128 take 1 byte,
+    // a full uint64_t takes 10. Signed values are zig-zag mapped first
+    // (0, -1, 1, -2, ... -> 0, 1, 2, 3, ...) so small negatives stay small.
+
+    inline constexpr size_t VARINT_MAX_BYTES = 10;
+
+    template <std::integral T>
+    inline constexpr std::make_unsigned_t<T> zigzag_encode(T v) noexcept
+    {
+        using U = std::make_unsigned_t<T>;
+        if constexpr (std::is_signed_v<T>)
+            return static_cast<U>((static_cast<U>(v) << 1) ^ static_cast<U>(v >> (sizeof(T) * 8 - 1)));
+        else
+            return v;
+    }
+
+    template <std::integral T>
+    inline constexpr T zigzag_decode(std::make_unsigned_t<T> u) noexcept
+    {
+        if constexpr (std::is_signed_v<T>)
+            return static_cast<T>((u >> 1) ^ (~(u & 1) + 1));
+        else
+            return u;
+    }
+
+    // Number of bytes encode_varint writes for v.
+    inline constexpr size_t varint_size(std::uint64_t v) noexcept
+    {
+        return 1 + (std::bit_width(v | 1) - 1) / 7;
+    }
+
+    // Encodes v at out (at least VARINT_MAX_BYTES writable bytes). Returns the bytes written.
+    inline constexpr size_t encode_varint(std::uint64_t v, std::byte* out) noexcept
+    {
+        size_t n = 0;
+        while (v >= 0x80)
+        {
+            out[n++] = static_cast<std::byte>(v | 0x80);
+            v >>= 7;
+        }
+        out[n++] = static_cast<std::byte>(v);
+        return n;
+    }
+
+    // Decodes one varint from in. Returns the bytes consumed, or 0 if in ends before the
+    // varint does or the value does not fit in 64 bits.
+    inline constexpr size_t decode_varint(std::span<const std::byte> in, std::uint64_t& v) noexcept
+    {
+        std::uint64_t result = 0;
+        const size_t max = in.size() < VARINT_MAX_BYTES ? in.size() : VARINT_MAX_BYTES;
+        for (size_t i = 0; i < max; ++i)
+        {
+            const std::uint64_t b = static_cast<std::uint8_t>(in[i]);
+            if (i == VARINT_MAX_BYTES - 1 && b > 1) return 0; // More than 64 bits.
+            result |= (b & 0x7F) << (7 * i);
+            if (b < 0x80)
+            {
+                v = result;
+                return i + 1;
+            }
+        }
+        return 0;
+    }
+
+    // Decodes up to out.size () varints from in into out, stopping early at the first
+    // truncated, overlong or out of range (for T) varint. Returns the number of values
+    // decoded; consumed receives the number of bytes used.
+    //
+    // Runs of 1-byte varints (the common case for ids, counts and deltas) are detected
+    // 16 bytes at a time with SSE2 (8 at a time with SWAR elsewhere) and widened
+    // without per-byte branches.
+    template <std::unsigned_integral T>
+    inline size_t decode_varints(std::span<const std::byte> in, std::span<T> out, size_t& consumed) noexcept
+    {
+        const std::byte* p   = in.data();
+        const std::byte* end = p + in.size();
+        size_t n = 0;
+        while (n < out.size() && p < end)
+        {
+            size_t run = 0; // Leading 1-byte varints found by the wide scan.
+#ifdef PD_VARINT_SSE2
+            if (end - p >= 16 && out.size() - n >= 16)
+            {
+                const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))));
+                run = mask == 0 ? 16 : static_cast<size_t>(std::countr_zero(mask));
+            }
+            else
+#endif
+            if (end - p >= 8 && out.size() - n >= 8)
+            {
+                std::uint64_t word;
+                std::memcpy(&word, p, sizeof(word));
+                const std::uint64_t high = word & 0x8080808080808080ULL;
+                if constexpr (std::endian::native == std::endian::little)
+                    run = high == 0 ? 8 : static_cast<size_t>(std::countr_zero(high)) / 8;
+            }
+
+            for (size_t i = 0; i < run; ++i)
+                out[n + i] = static_cast<T>(static_cast<std::uint8_t>(p[i]));
+            n += run;
+            p += run;
+            if (run > 0) continue;
+
+            std::uint64_t v = 0;
+            const size_t used = decode_varint(std::span<const std::byte>(p, end), v);
+            if (used == 0 || v > (std::numeric_limits<T>::max)()) break;
+            out[n++] = static_cast<T>(v);
+            p += used;
+        }
+        consumed = static_cast<size_t>(p - in.data());
+        return n;
+    }
+}
+
+#endif // VARINT_HPP
@@ -0,0 +1,75 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#ifndef FD_IO_WINDOWS_HPP
+#define FD_IO_WINDOWS_HPP
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <algorithm> // std::min
+#include <cstddef>   // std::byte
+
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include "../code_util.hpp"
+
+namespace pensar_digital
+{
+    namespace cpplib
+    {
+        enum class FdMode { READ, WRITE, APPEND };
+
+        /// \brief Opens filename (always in binary mode) and returns its CRT file descriptor.
+        /// \param mode WRITE creates or truncates the file, APPEND creates it or writes at its end.
+        inline Result<int> open_fd(std::string_view filename, FdMode mode)
+        {
+            int flags = _O_RDONLY;
+            if (mode == FdMode::WRITE ) flags = _O_WRONLY | _O_CREAT | _O_TRUNC;
+            if (mode == FdMode::APPEND) flags = _O_WRONLY | _O_CREAT | _O_APPEND;
+            int fd = -1;
+            if (_sopen_s(&fd, std::string(filename).c_str(), flags | _O_BINARY | _O_NOINHERIT, _SH_DENYNO, _S_IREAD | _S_IWRITE) != 0)
+                return Result<int>(W("Failed to open file"), -1);
+            return Result<int>(fd);
+        }
+
+        inline Result<Bool> close_fd(int fd) noexcept
+        {
+            if (_close(fd) != 0) return Result<Bool>(W("Failed to close file"));
+            return Result<Bool>(Bool::T);
+        }
+
+        /// \brief Writes all bytes to fd. Partial writes are retried.
+        inline Result<Bool> write_all(int fd, std::span<const std::byte> bytes) noexcept
+        {
+            while (!bytes.empty())
+            {
+                const unsigned chunk = static_cast<unsigned>((std::min)(bytes.size(), size_t{ 1 } << 30));
+                const int n = _write(fd, bytes.data(), chunk);
+                if (n < 0) return Result<Bool>(W("write failed"));
+                bytes = bytes.subspan(static_cast<size_t>(n));
+            }
+            return Result<Bool>(Bool::T);
+        }
+
+        /// \brief Reads up to dest.size () bytes from fd, retrying short reads until dest is
+        /// full or the end of the file is reached. Returns the number of bytes read.
+        inline Result<size_t> read_fill(int fd, std::span<std::byte> dest) noexcept
+        {
+            size_t total = 0;
+            while (total < dest.size())
+            {
+                const unsigned chunk = static_cast<unsigned>((std::min)(dest.size() - total, size_t{ 1 } << 30));
+                const int n = _read(fd, dest.data() + total, chunk);
+                if (n < 0) return Result<size_t>(W("read failed"), total);
+                if (n == 0) break; // End of file.
+                total += static_cast<size_t>(n);
+            }
+            return Result<size_t>(total);
+        }
+    }   // namespace cpplib
+}       // namespace pensar_digital
+
+#endif  // FD_IO_WINDOWS_HPP
@@ -0,0 +1,53 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#ifndef GATHER_IO_WINDOWS_HPP
+#define GATHER_IO_WINDOWS_HPP
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <algorithm> // std::min
+#include <cstddef>   // std::byte
+
+#include <windows.h>
+
+#include "../code_util.hpp"
+
+namespace pensar_digital
+{
+    namespace cpplib
+    {
+        /// \brief Writes all parts, in order, to the file handle h. Windows has no writev for
+        /// buffered handles (WriteFileGather needs page sized, unbuffered I/O), so each part is
+        /// written with WriteFile; parts are large segments, so the call count stays low.
+        inline Result<Bool> write_gather(HANDLE h, std::span<const std::span<const std::byte>> parts)
+        {
+            for (std::span<const std::byte> part : parts)
+            {
+                while (!part.empty())
+                {
+                    const DWORD chunk = static_cast<DWORD>((std::min)(part.size(), size_t{ 1 } << 30));
+                    DWORD written = 0;
+                    if (!WriteFile(h, part.data(), chunk, &written, nullptr))
+                        return Result<Bool>(W("WriteFile failed"));
+                    part = part.subspan(written);
+                }
+            }
+            return Result<Bool>(Bool::T);
+        }
+
+        /// \brief Creates (or truncates) filename and writes all parts to it with write_gather.
+        inline Result<Bool> save_gather(std::string_view filename, std::span<const std::span<const std::byte>> parts)
+        {
+            HANDLE h = CreateFileA(std::string(filename).c_str(), GENERIC_WRITE, 0, nullptr,
+                                   CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            if (h == INVALID_HANDLE_VALUE) return Result<Bool>(W("Failed to open file for writing"));
+            Result<Bool> r = write_gather(h, parts);
+            CloseHandle(h);
+            return r;
+        }
+    }   // namespace cpplib
+}       // namespace pensar_digital
+
+#endif  // GATHER_IO_WINDOWS_HPP
@@ -0,0 +1,186 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#ifndef MAPPED_FILE_WINDOWS_HPP
+#define MAPPED_FILE_WINDOWS_HPP
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>   // std::exchange
+#include <cstddef>   // std::byte
+
+#include <windows.h>
+
+#include "../code_util.hpp"
+
+namespace pensar_digital
+{
+    namespace cpplib
+    {
+        // MappedFile: a file mapped into memory with a file mapping object. Pages are loaded lazily on first access.
+        class MappedFile
+        {
+            public:
+                enum class Mode   { READ_ONLY, READ_WRITE };
+                enum class Advice { NORMAL, SEQUENTIAL, RANDOM, WILL_NEED, DONT_NEED };
+
+            private:
+                HANDLE      mfile    = INVALID_HANDLE_VALUE;
+                HANDLE      mmapping = nullptr;
+                std::byte*  mdata    = nullptr;
+                size_t      msize    = 0;
+                Mode        mmode    = Mode::READ_ONLY;
+
+                void unmap() noexcept
+                {
+                    if (mdata    != nullptr) UnmapViewOfFile(mdata);
+                    if (mmapping != nullptr) CloseHandle(mmapping);
+                    mdata    = nullptr;
+                    mmapping = nullptr;
+                    msize    = 0;
+                }
+
+                Result<Bool> map(size_t size)
+                {
+                    msize = size;
+                    if (size == 0) return Result<Bool>(Bool::T); // Windows rejects empty mappings.
+                    const bool rw = (mmode == Mode::READ_WRITE);
+                    const ULARGE_INTEGER sz = { .QuadPart = static_cast<ULONGLONG>(size) };
+                    mmapping = CreateFileMappingA(mfile, nullptr, rw ? PAGE_READWRITE : PAGE_READONLY, sz.HighPart, sz.LowPart, nullptr);
+                    if (mmapping == nullptr)
+                    {
+                        msize = 0;
+                        return Result<Bool>(W("CreateFileMapping failed"));
+                    }
+                    mdata = static_cast<std::byte*>(MapViewOfFile(mmapping, rw ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, size));
+                    if (mdata == nullptr)
+                    {
+                        unmap();
+                        return Result<Bool>(W("MapViewOfFile failed"));
+                    }
+                    return Result<Bool>(Bool::T);
+                }
+
+            public:
+                MappedFile() noexcept = default;
+                MappedFile(const MappedFile&) = delete;
+                MappedFile& operator=(const MappedFile&) = delete;
+
+                MappedFile(MappedFile&& o) noexcept
+                    : mfile(std::exchange(o.mfile, INVALID_HANDLE_VALUE)), mmapping(std::exchange(o.mmapping, nullptr)),
+                      mdata(std::exchange(o.mdata, nullptr)), msize(std::exchange(o.msize, 0)), mmode(o.mmode) {}
+
+                MappedFile& operator=(MappedFile&& o) noexcept
+                {
+                    if (this != &o)
+                    {
+                        close();
+                        mfile    = std::exchange(o.mfile, INVALID_HANDLE_VALUE);
+                        mmapping = std::exchange(o.mmapping, nullptr);
+                        mdata    = std::exchange(o.mdata, nullptr);
+                        msize    = std::exchange(o.msize, 0);
+                        mmode    = o.mmode;
+                    }
+                    return *this;
+                }
+
+                ~MappedFile() { close(); }
+
+                /// \brief Maps filename into memory.
+                /// \param mode READ_WRITE creates the file if it does not exist.
+                /// \param min_size In READ_WRITE mode the file is extended to at least this size.
+                Result<Bool> open(std::string_view filename, Mode mode = Mode::READ_ONLY, size_t min_size = 0)
+                {
+                    close();
+                    mmode = mode;
+                    const bool rw = (mode == Mode::READ_WRITE);
+                    mfile = CreateFileA(std::string(filename).c_str(),
+                                        rw ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ,
+                                        FILE_SHARE_READ, nullptr,
+                                        rw ? OPEN_ALWAYS : OPEN_EXISTING,
+                                        FILE_ATTRIBUTE_NORMAL, nullptr);
+                    if (mfile == INVALID_HANDLE_VALUE) return Result<Bool>(W("Failed to open file for mapping"));
+
+                    LARGE_INTEGER sz;
+                    if (!GetFileSizeEx(mfile, &sz))
+                    {
+                        close();
+                        return Result<Bool>(W("Could not determine file size"));
+                    }
+                    size_t size = static_cast<size_t>(sz.QuadPart);
+                    if (rw && (size < min_size)) size = min_size; // CreateFileMapping extends the file.
+                    Result<Bool> r = map(size);
+                    if (!r) close();
+                    return r;
+                }
+
+                /// \brief Changes the file size and remaps it (READ_WRITE only). The mapping may move.
+                /// If growing fails the old mapping is left intact.
+                Result<Bool> resize(size_t new_size)
+                {
+                    if (mfile == INVALID_HANDLE_VALUE || mmode != Mode::READ_WRITE) return Result<Bool>(W("File is not mapped for writing"));
+                    if (new_size > msize)
+                    {
+                        // CreateFileMapping extends the file: map the new size before unmapping the old view.
+                        HANDLE     old_mapping = std::exchange(mmapping, nullptr);
+                        std::byte* old_data    = std::exchange(mdata, nullptr);
+                        const size_t old_size  = msize;
+                        Result<Bool> r = map(new_size);
+                        if (!r)
+                        {
+                            mmapping = old_mapping;
+                            mdata    = old_data;
+                            msize    = old_size;
+                            return r;
+                        }
+                        if (old_data    != nullptr) UnmapViewOfFile(old_data);
+                        if (old_mapping != nullptr) CloseHandle(old_mapping);
+                        return r;
+                    }
+                    // A file cannot be truncated under a mapped view.
+                    unmap();
+                    LARGE_INTEGER pos = { .QuadPart = static_cast<LONGLONG>(new_size) };
+                    if (!SetFilePointerEx(mfile, pos, nullptr, FILE_BEGIN) || !SetEndOfFile(mfile))
+                        return Result<Bool>(W("Failed to resize mapped file"));
+                    return map(new_size);
+                }
+
+                /// \brief Hints the expected access pattern for [offset, offset + length).
+                /// Only WILL_NEED (prefetch) has a Windows equivalent; other hints are accepted and ignored.
+                Result<Bool> advise(Advice advice, size_t offset = 0, size_t length = 0) noexcept
+                {
+                    if (mdata == nullptr || offset >= msize || advice != Advice::WILL_NEED) return Result<Bool>(Bool::T);
+                    if (length == 0 || offset + length > msize) length = msize - offset;
+                    WIN32_MEMORY_RANGE_ENTRY range = { mdata + offset, length };
+                    if (!PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0))
+                        return Result<Bool>(W("PrefetchVirtualMemory failed"));
+                    return Result<Bool>(Bool::T);
+                }
+
+                /// \brief Flushes modified pages to disk (blocking).
+                Result<Bool> sync() noexcept
+                {
+                    if (mdata == nullptr || mmode != Mode::READ_WRITE) return Result<Bool>(Bool::T);
+                    if (!FlushViewOfFile(mdata, msize) || !FlushFileBuffers(mfile)) return Result<Bool>(W("FlushViewOfFile failed"));
+                    return Result<Bool>(Bool::T);
+                }
+
+                void close() noexcept
+                {
+                    unmap();
+                    if (mfile != INVALID_HANDLE_VALUE) CloseHandle(mfile);
+                    mfile = INVALID_HANDLE_VALUE;
+                }
+
+                [[nodiscard]] bool   is_open     () const noexcept { return mfile != INVALID_HANDLE_VALUE; }
+                [[nodiscard]] bool   is_writable () const noexcept { return mmode == Mode::READ_WRITE; }
+                [[nodiscard]] size_t size        () const noexcept { return msize; }
+
+                [[nodiscard]] std::span<      std::byte> wbytes()       noexcept { return { mdata, msize }; }
+                [[nodiscard]] std::span<const std::byte> bytes () const noexcept { return { mdata, msize }; }
+        };
+    }   // namespace cpplib
+}       // namespace pensar_digital
+
+#endif  // MAPPED_FILE_WINDOWS_HPP
@@ -0,0 +1,259 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#ifndef WIRE_ARRAY_HPP
+#define WIRE_ARRAY_HPP
+
+#include "endian.hpp"
+#include "concept.hpp"
+#include "wire_int.hpp"
+#include "wire_double.hpp"
+#include "wire_decimal.hpp"
+#include "byte_order.hpp" // byteswap_copy
+
+#include <span>
+#include <vector>
+#include <limits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace pensar_digital::cpplib
+{
+    // ------------------------------------------------------------
+    // Wire value traits
+    // ------------------------------------------------------------
+    // The native type and wire endian of Int, Double and Decimal. They store the value's bytes
+    // in wire order, so an array of them decodes with one bulk byte swap (or a memcpy
+    // when the wire endian is the native one).
+
+    template<typename W>
+    struct WireTraits { static constexpr bool is_wire = false; };
+
+    template<IntegerLike T, Endian E>
+    struct WireTraits<Int<T, E>>
+    {
+        static constexpr bool is_wire = true;
+        using value_type = T;
+        static constexpr Endian endian = E;
+    };
+
+    template<IEEE754Binary T, Endian E>
+    struct WireTraits<Double<T, E>>
+    {
+        static constexpr bool is_wire = true;
+        using value_type = T;
+        static constexpr Endian endian = E;
+    };
+
+    // Decimals are reduced as their unscaled integers: sums stay exact.
+    template<unsigned P, unsigned S, Endian E>
+    struct WireTraits<Decimal<P, S, E>>
+    {
+        static constexpr bool is_wire = true;
+        using value_type = typename Decimal<P, S, E>::value_type;
+        static constexpr Endian endian = E;
+    };
+
+    template<typename W>
+    concept WireValue = WireTraits<W>::is_wire && (sizeof(W) == sizeof(typename WireTraits<W>::value_type));
+
+    // ------------------------------------------------------------
+    // WireSpan
+    // ------------------------------------------------------------
+    // Read only view of wire values, e.g. a column in a mapped file or BinaryBuffer.
+    // Bulk decoding and the reductions work on blocks: a block is byte swapped with the
+    // SIMD engine into a small native buffer that stays in L1, then reduced with
+    // independent accumulators the compiler can vectorize. No per element decode.
+
+    template<WireValue W>
+    class WireSpan
+    {
+        public:
+            using wire_type  = W;
+            using value_type = typename WireTraits<W>::value_type;
+            // Integers are summed in 64 bits, floating point values in double.
+            using sum_type   = std::conditional_t<std::is_floating_point_v<value_type>, double,
+                               std::conditional_t<std::is_signed_v<value_type>, std::int64_t, std::uint64_t>>;
+
+            static constexpr size_t BLOCK = 1024; // Values decoded per step.
+
+        private:
+            std::span<const W> mvalues;
+
+            static constexpr bool NEED_SWAP = (sizeof(value_type) > 1) && WireTraits<W>::endian.known() && !WireTraits<W>::endian.is_native();
+
+            // Calls f (block) for consecutive native blocks of [first, first + n).
+            template <typename F>
+            void for_each_block(size_t first, size_t n, F&& f) const noexcept
+            {
+                value_type block[BLOCK];
+                for (size_t i = first; i < first + n; i += BLOCK)
+                {
+                    const size_t count = (std::min)(BLOCK, first + n - i);
+                    decode(i, std::span<value_type>(block, count));
+                    f(std::span<const value_type>(block, count));
+                }
+            }
+
+            void decode(size_t first, std::span<value_type> out) const noexcept
+            {
+                if (out.empty()) return;
+                const std::byte* in = reinterpret_cast<const std::byte*>(mvalues.data() + first);
+                if constexpr (NEED_SWAP)
+                    byteswap_copy<sizeof(value_type)>(in, reinterpret_cast<std::byte*>(out.data()), out.size());
+                else
+                    std::memcpy(out.data(), in, out.size_bytes());
+            }
+
+        public:
+            constexpr WireSpan() noexcept = default;
+            constexpr WireSpan(std::span<const W> values) noexcept : mvalues(values) {}
+
+            [[nodiscard]] size_t size () const noexcept { return mvalues.size(); }
+            [[nodiscard]] bool   empty() const noexcept { return mvalues.empty(); }
+            [[nodiscard]] std::span<const W> values() const noexcept { return mvalues; }
+
+            [[nodiscard]] value_type value(size_t i) const noexcept { return mvalues[i].value(); }
+
+            // Decodes the first out.size () values (at most size ()) into out.
+            void decode_into(std::span<value_type> out) const noexcept
+            {
+                decode(0, out.first((std::min)(out.size(), size())));
+            }
+
+            // Decodes out.size () values starting at first.
+            void decode_range(size_t first, std::span<value_type> out) const noexcept { decode(first, out); }
+
+            [[nodiscard]] std::vector<value_type> decode() const
+            {
+                std::vector<value_type> out(size());
+                decode_into(out);
+                return out;
+            }
+
+            [[nodiscard]] sum_type sum() const noexcept
+            {
+                sum_type acc[8] = {};
+                for_each_block(0, size(), [&](std::span<const value_type> b) noexcept
+                {
+                    size_t i = 0;
+                    for (; i + 8 <= b.size(); i += 8)
+                        for (size_t k = 0; k < 8; ++k) acc[k] += static_cast<sum_type>(b[i + k]);
+                    for (; i < b.size(); ++i) acc[0] += static_cast<sum_type>(b[i]);
+                });
+                return ((acc[0] + acc[1]) + (acc[2] + acc[3])) + ((acc[4] + acc[5]) + (acc[6] + acc[7]));
+            }
+
+            // Smallest value; numeric_limits<value_type>::max () for an empty span.
+            [[nodiscard]] value_type min() const noexcept
+            {
+                value_type m = (std::numeric_limits<value_type>::max)();
+                for_each_block(0, size(), [&](std::span<const value_type> b) noexcept
+                {
+                    for (value_type v : b) m = v < m ? v : m;
+                });
+                return m;
+            }
+
+            // Largest value; numeric_limits<value_type>::lowest () for an empty span.
+            [[nodiscard]] value_type max() const noexcept
+            {
+                value_type m = std::numeric_limits<value_type>::lowest();
+                for_each_block(0, size(), [&](std::span<const value_type> b) noexcept
+                {
+                    for (value_type v : b) m = v > m ? v : m;
+                });
+                return m;
+            }
+
+            // Sum of the products of the first min (size (), other.size ()) values.
+            template <WireValue W2>
+            [[nodiscard]] sum_type dot(const WireSpan<W2>& other) const noexcept
+            {
+                using V2 = typename WireSpan<W2>::value_type;
+                const size_t n = (std::min)(size(), other.size());
+                sum_type acc[8] = {};
+                V2 rhs[BLOCK];
+                size_t first = 0;
+                for_each_block(0, n, [&](std::span<const value_type> b) noexcept
+                {
+                    other.decode_range(first, std::span<V2>(rhs, b.size()));
+                    size_t i = 0;
+                    for (; i + 8 <= b.size(); i += 8)
+                        for (size_t k = 0; k < 8; ++k) acc[k] += static_cast<sum_type>(b[i + k]) * static_cast<sum_type>(rhs[i + k]);
+                    for (; i < b.size(); ++i) acc[0] += static_cast<sum_type>(b[i]) * static_cast<sum_type>(rhs[i]);
+                    first += b.size();
+                });
+                return ((acc[0] + acc[1]) + (acc[2] + acc[3])) + ((acc[4] + acc[5]) + (acc[6] + acc[7]));
+            }
+    };
+
+    // ------------------------------------------------------------
+    // WireArray
+    // ------------------------------------------------------------
+    // Owning array of wire values with bulk encode/decode and reductions (see WireSpan).
+    // It is a contiguous range of WireSafe values, so BinaryBuffer::write_array and
+    // read_array (with values ()) store it with a single copy.
+
+    template<WireValue W>
+    class WireArray
+    {
+        public:
+            using wire_type  = W;
+            using value_type = typename WireTraits<W>::value_type;
+            using sum_type   = typename WireSpan<W>::sum_type;
+
+        private:
+            std::vector<W> mvalues;
+
+        public:
+            WireArray() = default;
+            explicit WireArray(size_t n) : mvalues(n) {}
+            explicit WireArray(std::span<const value_type> values) { encode_from(values); }
+
+            [[nodiscard]] size_t size () const noexcept { return mvalues.size(); }
+            [[nodiscard]] bool   empty() const noexcept { return mvalues.empty(); }
+            void resize(size_t n) { mvalues.resize(n); }
+
+            [[nodiscard]] W*       data()       noexcept { return mvalues.data(); }
+            [[nodiscard]] const W* data() const noexcept { return mvalues.data(); }
+            [[nodiscard]] W*       begin()       noexcept { return mvalues.data(); }
+            [[nodiscard]] const W* begin() const noexcept { return mvalues.data(); }
+            [[nodiscard]] W*       end()         noexcept { return mvalues.data() + mvalues.size(); }
+            [[nodiscard]] const W* end()   const noexcept { return mvalues.data() + mvalues.size(); }
+
+            W&       operator[](size_t i)       noexcept { return mvalues[i]; }
+            const W& operator[](size_t i) const noexcept { return mvalues[i]; }
+
+            [[nodiscard]] std::vector<W>&       values()       noexcept { return mvalues; }
+            [[nodiscard]] const std::vector<W>& values() const noexcept { return mvalues; }
+            [[nodiscard]] WireSpan<W> view() const noexcept { return WireSpan<W>(mvalues); }
+
+            // Replaces the contents with values encoded in bulk.
+            void encode_from(std::span<const value_type> values)
+            {
+                mvalues.resize(values.size());
+                if (values.empty()) return;
+                const std::byte* in = reinterpret_cast<const std::byte*>(values.data());
+                std::byte* out = reinterpret_cast<std::byte*>(mvalues.data());
+                if constexpr ((sizeof(value_type) > 1) && WireTraits<W>::endian.known() && !WireTraits<W>::endian.is_native())
+                    byteswap_copy<sizeof(value_type)>(in, out, values.size());
+                else
+                    std::memcpy(out, in, values.size_bytes());
+            }
+
+            void decode_into(std::span<value_type> out) const noexcept { view().decode_into(out); }
+            [[nodiscard]] std::vector<value_type> decode() const { return view().decode(); }
+
+            [[nodiscard]] sum_type   sum() const noexcept { return view().sum(); }
+            [[nodiscard]] value_type min() const noexcept { return view().min(); }
+            [[nodiscard]] value_type max() const noexcept { return view().max(); }
+
+            template <WireValue W2>
+            [[nodiscard]] sum_type dot(const WireArray<W2>& other) const noexcept { return view().dot(other.view()); }
+    };
+}
+
+#endif // WIRE_ARRAY_HPP
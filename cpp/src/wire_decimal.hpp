@@ -0,0 +1,437 @@
+// author : Mauricio Gomes
+// license: MIT (https://opensource.org/licenses/MIT)
+
+#ifndef WIRE_DECIMAL_HPP
+#define WIRE_DECIMAL_HPP
+
+#include "endian.hpp"
+#include "concept.hpp"
+
+#include <bit>
+#include <span>
+#include <cmath>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <compare>
+#include <algorithm>
+#include <functional>
+#include <string_view>
+#include <type_traits>
+
+namespace pensar_digital::cpplib
+{
+    // ------------------------------------------------------------
+    // Decimal helpers
+    // ------------------------------------------------------------
+
+    namespace decimal
+    {
+        inline constexpr std::uint64_t POW10[20] =
+        {
+            1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL,
+            1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+            100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL,
+            1000000000000000000ULL, 10000000000000000000ULL
+        };
+
+        inline constexpr char DIGIT_PAIRS[] =
+            "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+            "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+            "8081828384858687888990919293949596979899";
+
+        inline constexpr bool is_digit(char c) noexcept { return static_cast<unsigned char>(c - '0') < 10; }
+
+        // Decimal digits of v (1 for 0), without a loop: log10 from the bit width.
+        inline constexpr unsigned count_digits(std::uint64_t v) noexcept
+        {
+            const unsigned t = (static_cast<unsigned>(std::bit_width(v | 1)) * 1233) >> 12;
+            return t + 1 - ((v | 1) < POW10[t]);
+        }
+
+        // Writes exactly count digits of v ending at end, two at a time. Returns the first.
+        inline constexpr char* write_digits(char* end, std::uint64_t v, unsigned count) noexcept
+        {
+            for (; count >= 2; count -= 2)
+            {
+                const size_t i = static_cast<size_t>(v % 100) * 2;
+                v /= 100;
+                *--end = DIGIT_PAIRS[i + 1];
+                *--end = DIGIT_PAIRS[i];
+            }
+            if (count) *--end = static_cast<char>('0' + v % 10);
+            return end;
+        }
+
+        // SWAR: true if the 8 bytes at p are all ASCII digits.
+        inline bool is_eight_digits(const char* p) noexcept
+        {
+            std::uint64_t v;
+            std::memcpy(&v, p, 8);
+            return (((v & 0xF0F0F0F0F0F0F0F0ULL) | (((v + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) == 0x3333333333333333ULL);
+        }
+
+        // SWAR: value of the 8 ASCII digits at p, combined in three multiply steps.
+        inline std::uint32_t parse_eight_digits(const char* p) noexcept
+        {
+            std::uint64_t v;
+            std::memcpy(&v, p, 8);
+            if constexpr (std::endian::native == std::endian::big) v = std::byteswap(v);
+            v -= 0x3030303030303030ULL;
+            v = (v * 10) + (v >> 8);
+            v = (((v & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+                 (((v >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+            return static_cast<std::uint32_t>(v);
+        }
+
+        // Appends the digits at [p, end) to v, 8 at a time when possible. Returns the
+        // first non digit.
+        inline constexpr const char* accumulate(const char* p, const char* end, std::uint64_t& v) noexcept
+        {
+            if !consteval
+            {
+                while (end - p >= 8 && is_eight_digits(p))
+                {
+                    v = v * 100000000ULL + parse_eight_digits(p);
+                    p += 8;
+                }
+            }
+            for (; p != end && is_digit(*p); ++p) v = v * 10 + static_cast<std::uint64_t>(*p - '0');
+            return p;
+        }
+
+        // Full 128 bit product of two 64 bit values.
+        inline constexpr void mul_128(std::uint64_t a, std::uint64_t b, std::uint64_t& hi, std::uint64_t& lo) noexcept
+        {
+            const std::uint64_t a_lo = a & 0xFFFFFFFFULL, a_hi = a >> 32;
+            const std::uint64_t b_lo = b & 0xFFFFFFFFULL, b_hi = b >> 32;
+            const std::uint64_t p0 = a_lo * b_lo, p1 = a_lo * b_hi, p2 = a_hi * b_lo, p3 = a_hi * b_hi;
+            const std::uint64_t mid = (p0 >> 32) + (p1 & 0xFFFFFFFFULL) + (p2 & 0xFFFFFFFFULL);
+            lo = (mid << 32) | (p0 & 0xFFFFFFFFULL);
+            hi = p3 + (p1 >> 32) + (p2 >> 32) + (mid >> 32);
+        }
+
+        // (hi:lo) / d and its remainder; the quotient must fit in 64 bits.
+        inline constexpr std::uint64_t div_128(std::uint64_t hi, std::uint64_t lo, std::uint64_t d, std::uint64_t& r) noexcept
+        {
+            std::uint64_t q = 0;
+            r = hi % d;
+            for (int i = 63; i >= 0; --i)
+            {
+                const bool carry = (r >> 63) != 0;
+                r = (r << 1) | ((lo >> i) & 1);
+                if (carry || r >= d)
+                {
+                    r -= d;
+                    q |= 1ULL << i;
+                }
+            }
+            return q;
+        }
+
+        // a * b / d rounded half away from zero, with an exact 128 bit intermediate.
+        inline constexpr std::int64_t mul_div(std::int64_t a, std::int64_t b, std::int64_t d) noexcept
+        {
+            const bool negative = ((a < 0) != (b < 0)) != (d < 0);
+            const std::uint64_t ua = a < 0 ? 0 - static_cast<std::uint64_t>(a) : static_cast<std::uint64_t>(a);
+            const std::uint64_t ub = b < 0 ? 0 - static_cast<std::uint64_t>(b) : static_cast<std::uint64_t>(b);
+            const std::uint64_t ud = d < 0 ? 0 - static_cast<std::uint64_t>(d) : static_cast<std::uint64_t>(d);
+            std::uint64_t q, r;
+#if defined(__SIZEOF_INT128__)
+            const unsigned __int128 p = static_cast<unsigned __int128>(ua) * ub;
+            q = static_cast<std::uint64_t>(p / ud);
+            r = static_cast<std::uint64_t>(p % ud);
+#else
+            std::uint64_t hi, lo;
+            mul_128(ua, ub, hi, lo);
+            q = div_128(hi, lo, ud, r);
+#endif
+            q += (r >= ud - r); // 2r >= d without overflow.
+            return negative ? static_cast<std::int64_t>(0 - q) : static_cast<std::int64_t>(q);
+        }
+
+        // n / d rounded half away from zero (d > 0).
+        inline constexpr std::int64_t div_round(std::int64_t n, std::int64_t d) noexcept
+        {
+            return mul_div(n, 1, d);
+        }
+    }
+
+    // ------------------------------------------------------------
+    // Wire fixed-point decimal
+    // ------------------------------------------------------------
+    // A SQL DECIMAL(Precision, Scale) value: an integer count of 10^-Scale units stored
+    // in E byte order, like Int. Arithmetic is exact (products and quotients round half
+    // away from zero, as Postgres does) and the text form parses and formats without
+    // going through double, so values round-trip to the database and to files unchanged.
+    // As with Int, results are not checked against Precision (see in_range).
+
+    template<unsigned Precision, unsigned Scale, Endian E = Endian::big()>
+        requires (Precision >= 1 && Precision <= 18 && Scale <= Precision)
+    struct Decimal
+    {
+        using value_type  = std::conditional_t<(Precision <= 9), std::int32_t, std::int64_t>; // Unscaled value.
+        using endian_type = Endian;
+
+        static constexpr unsigned   PRECISION    = Precision;
+        static constexpr unsigned   SCALE        = Scale;
+        static constexpr value_type ONE          = static_cast<value_type>(decimal::POW10[Scale]);         // Unscaled 1.
+        static constexpr value_type MAX_UNSCALED = static_cast<value_type>(decimal::POW10[Precision] - 1);
+        static constexpr size_t     MAX_CHARS    = 22; // Text of any value_type: sign, 19 digits, "0." .
+
+        value_type storage{0};
+
+        // --------------------------------------------------------
+        // Construction
+        // --------------------------------------------------------
+
+        constexpr Decimal() noexcept = default;
+
+        template<IntegerLike I>
+        constexpr explicit Decimal(I whole) noexcept
+            : storage(encode(static_cast<value_type>(static_cast<std::int64_t>(whole) * ONE))) {}
+
+        // Rescales o, rounding half away from zero when Scale is smaller.
+        template<unsigned P2, unsigned S2, Endian E2>
+        constexpr explicit Decimal(const Decimal<P2, S2, E2>& o) noexcept
+        {
+            const std::int64_t u = o.unscaled();
+            if constexpr (S2 <= Scale)
+                storage = encode(static_cast<value_type>(u * static_cast<std::int64_t>(decimal::POW10[Scale - S2])));
+            else
+                storage = encode(static_cast<value_type>(decimal::div_round(u, static_cast<std::int64_t>(decimal::POW10[S2 - Scale]))));
+        }
+
+        static constexpr Decimal from_unscaled(value_type u) noexcept
+        {
+            Decimal d;
+            d.storage = encode(u);
+            return d;
+        }
+
+        // Nearest decimal to v, for the boundary with code still using double.
+        static Decimal from_double(double v) noexcept
+        {
+            return from_unscaled(static_cast<value_type>(std::llround(v * static_cast<double>(ONE))));
+        }
+
+        // --------------------------------------------------------
+        // Conversion
+        // --------------------------------------------------------
+
+        constexpr value_type unscaled() const noexcept { return decode(storage); }
+
+        constexpr double to_double() const noexcept { return static_cast<double>(unscaled()) / static_cast<double>(ONE); }
+
+        // True if the value has at most Precision digits.
+        constexpr bool in_range() const noexcept
+        {
+            const value_type u = unscaled();
+            return u <= MAX_UNSCALED && u >= -MAX_UNSCALED;
+        }
+
+        // --------------------------------------------------------
+        // Arithmetic (value-based)
+        // --------------------------------------------------------
+
+        constexpr Decimal& operator+=(Decimal rhs) noexcept { return *this = from_unscaled(static_cast<value_type>(unscaled() + rhs.unscaled())); }
+        constexpr Decimal& operator-=(Decimal rhs) noexcept { return *this = from_unscaled(static_cast<value_type>(unscaled() - rhs.unscaled())); }
+
+        constexpr Decimal& operator*=(Decimal rhs) noexcept
+        {
+            return *this = from_unscaled(static_cast<value_type>(decimal::mul_div(unscaled(), rhs.unscaled(), ONE)));
+        }
+
+        // rhs must not be zero.
+        constexpr Decimal& operator/=(Decimal rhs) noexcept
+        {
+            return *this = from_unscaled(static_cast<value_type>(decimal::mul_div(unscaled(), ONE, rhs.unscaled())));
+        }
+
+        constexpr Decimal operator-() const noexcept { return from_unscaled(static_cast<value_type>(-unscaled())); }
+
+        friend constexpr Decimal operator+(Decimal a, Decimal b) noexcept { return a += b; }
+        friend constexpr Decimal operator-(Decimal a, Decimal b) noexcept { return a -= b; }
+        friend constexpr Decimal operator*(Decimal a, Decimal b) noexcept { return a *= b; }
+        friend constexpr Decimal operator/(Decimal a, Decimal b) noexcept { return a /= b; }
+
+        // --------------------------------------------------------
+        // Comparisons (value-based)
+        // --------------------------------------------------------
+
+        friend constexpr bool operator==(Decimal a, Decimal b) noexcept { return a.unscaled() == b.unscaled(); }
+        friend constexpr auto operator<=>(Decimal a, Decimal b) noexcept { return a.unscaled() <=> b.unscaled(); }
+
+        // --------------------------------------------------------
+        // Text
+        // --------------------------------------------------------
+
+        // Parses [+-]digits[.digits], e.g. Postgres output. Digits past Scale round half
+        // away from zero. False, leaving out unchanged, if text is not a decimal or has
+        // more than Precision - Scale integer digits.
+        static constexpr bool parse(std::string_view text, Decimal& out) noexcept
+        {
+            const char* p = text.data();
+            const char* const end = p + text.size();
+            bool negative = false;
+            if (p != end && (*p == '-' || *p == '+')) negative = (*p++ == '-');
+            const char* const digits = p;
+            while (p != end && *p == '0') ++p;
+
+            std::uint64_t whole = 0;
+            const char* const whole_begin = p;
+            p = decimal::accumulate(p, end, whole);
+            if (static_cast<size_t>(p - whole_begin) > Precision - Scale) return false;
+            bool any = p != digits;
+
+            std::uint64_t fraction = 0;
+            std::uint64_t round = 0;
+            if (p != end && *p == '.')
+            {
+                const char* const fraction_begin = ++p;
+                p = decimal::accumulate(p, p + (std::min)(static_cast<size_t>(end - p), static_cast<size_t>(Scale)), fraction);
+                const size_t count = static_cast<size_t>(p - fraction_begin);
+                fraction *= decimal::POW10[Scale - count];
+                if (p != end && decimal::is_digit(*p))
+                {
+                    round = *p >= '5';
+                    while (p != end && decimal::is_digit(*p)) ++p;
+                }
+                any = any || p != fraction_begin;
+            }
+            if (!any || p != end) return false;
+
+            const std::uint64_t u = whole * static_cast<std::uint64_t>(ONE) + fraction + round;
+            if (u > static_cast<std::uint64_t>(MAX_UNSCALED)) return false;
+            out = from_unscaled(static_cast<value_type>(negative ? -static_cast<std::int64_t>(u) : static_cast<std::int64_t>(u)));
+            return true;
+        }
+
+        // The value of text, or zero if it is not a valid decimal (see parse).
+        static constexpr Decimal parse(std::string_view text) noexcept
+        {
+            Decimal d;
+            parse(text, d);
+            return d;
+        }
+
+        // Writes the value with exactly Scale fraction digits, e.g. "-23.550520", to out
+        // (at least MAX_CHARS bytes). Returns the number of chars written.
+        constexpr size_t format(char* out) const noexcept
+        {
+            const std::int64_t u = unscaled();
+            const std::uint64_t a = u < 0 ? 0 - static_cast<std::uint64_t>(u) : static_cast<std::uint64_t>(u);
+            char buffer[MAX_CHARS];
+            char* const end = buffer + MAX_CHARS;
+            char* p = end;
+            if constexpr (Scale > 0)
+            {
+                p = decimal::write_digits(p, a % static_cast<std::uint64_t>(ONE), Scale);
+                *--p = '.';
+            }
+            const std::uint64_t whole = a / static_cast<std::uint64_t>(ONE);
+            p = decimal::write_digits(p, whole, decimal::count_digits(whole));
+            if (u < 0) *--p = '-';
+            const size_t n = static_cast<size_t>(end - p);
+            for (size_t i = 0; i < n; ++i) out[i] = p[i];
+            return n;
+        }
+
+        std::string to_string() const
+        {
+            char buffer[MAX_CHARS];
+            return std::string(buffer, format(buffer));
+        }
+
+    private:
+        static constexpr bool need_swap =
+            (E.value == Endian::LITTLE && std::endian::native == std::endian::big) ||
+            (E.value == Endian::BIG    && std::endian::native == std::endian::little);
+
+        static constexpr value_type encode(value_type v) noexcept
+        {
+            if constexpr (need_swap)
+                return std::byteswap(v);
+            else
+                return v;
+        }
+
+        static constexpr value_type decode(value_type v) noexcept
+        {
+            if constexpr (need_swap)
+                return std::byteswap(v);
+            else
+                return v;
+        }
+    };
+
+    template<unsigned Precision, unsigned Scale, Endian E = Endian::big()>
+    using WireDecimal = Decimal<Precision, Scale, E>;
+
+    // ------------------------------------------------------------
+    // Bulk text conversion
+    // ------------------------------------------------------------
+    // A text column, e.g. a COPY ... TO STDOUT column or one value per line of a file.
+    // Separators are found with memchr, which libc vectorizes, and digits are converted
+    // 8 at a time (see decimal::parse_eight_digits).
+
+    // Parses values separated by separator into out. Returns the number parsed: parsing
+    // stops at the first invalid value, when out is full or at the end of text.
+    template<class D>
+    size_t parse_decimals(std::string_view text, char separator, std::span<D> out) noexcept
+    {
+        size_t n = 0;
+        size_t pos = 0;
+        while (n < out.size())
+        {
+            const void* hit = std::memchr(text.data() + pos, separator, text.size() - pos);
+            const size_t stop = hit ? static_cast<size_t>(static_cast<const char*>(hit) - text.data()) : text.size();
+            if (!D::parse(text.substr(pos, stop - pos), out[n])) break;
+            ++n;
+            if (!hit) break;
+            pos = stop + 1;
+        }
+        return n;
+    }
+
+    // Appends values to out, each followed by separator.
+    template<class D>
+    void format_decimals(std::span<const D> values, char separator, std::string& out)
+    {
+        size_t size = out.size();
+        out.resize(size + values.size() * (D::MAX_CHARS + 1));
+        for (const D& v : values)
+        {
+            size += v.format(out.data() + size);
+            out[size++] = separator;
+        }
+        out.resize(size);
+    }
+
+    // ------------------------------------------------------------
+    // Static guarantees
+    // ------------------------------------------------------------
+
+    static_assert(WireSafe<Decimal<9, 6>>);
+    static_assert(sizeof(Decimal<9, 6>)  == sizeof(std::int32_t));
+    static_assert(sizeof(Decimal<18, 2>) == sizeof(std::int64_t));
+
+} // namespace pensar_digital::cpplib
+
+// ------------------------------------------------------------
+// std::hash
+// ------------------------------------------------------------
+
+namespace std
+{
+    template<unsigned P, unsigned S, pensar_digital::cpplib::Endian E>
+    struct hash<pensar_digital::cpplib::Decimal<P, S, E>>
+    {
+        size_t operator()(const pensar_digital::cpplib::Decimal<P, S, E>& d) const noexcept
+        {
+            return std::hash<typename pensar_digital::cpplib::Decimal<P, S, E>::value_type>{}(d.storage);
+        }
+    };
+}
+
+#endif // WIRE_DECIMAL_HPP